@@ -20,7 +20,9 @@
  *
  */
 
+#include "common/atomic.h"
 #include "common/debug.h"
+#include "common/endian.h"
 #include "common/file.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
@@ -370,6 +372,152 @@ QueuingAudioStream *makeQueuingAudioStream(int rate, bool stereo) {
 	return new QueuingAudioStreamImpl(rate, stereo);
 }
 
+uint32 RingQueuingAudioStream::queueSamples(const int16 *samples, uint32 numSamples) {
+	uint32 queued = 0;
+	while (queued < numSamples) {
+		uint32 count = numSamples - queued;
+		int16 *dst = reserve(count);
+		if (!count)
+			break;
+		memcpy(dst, samples + queued, count * sizeof(int16));
+		commit(count);
+		queued += count;
+	}
+	return queued;
+}
+
+class RingQueuingAudioStreamImpl : public RingQueuingAudioStream {
+private:
+	const int _rate;
+	const bool _stereo;
+	bool _finished;
+
+	int16 *_buffer;
+	uint32 _capacity;	// a power of two, so the counters may wrap around
+
+	// Samples ever queued and read, each only changed by one side
+	Common::Atomic<uint32> _written;
+	Common::Atomic<uint32> _read;
+
+	uint32 getQueuedSamples() const { return _written.load() - _read.load(); }
+
+public:
+	RingQueuingAudioStreamImpl(int rate, bool stereo, uint32 capacity);
+	~RingQueuingAudioStreamImpl() { free(_buffer); }
+
+	// Implement the AudioStream API
+	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool isStereo() const { return _stereo; }
+	virtual int getRate() const { return _rate; }
+	virtual bool endOfData() const { return getQueuedSamples() == 0; }
+	virtual bool endOfStream() const { return _finished && getQueuedSamples() == 0; }
+
+	// Implement the QueuingAudioStream API
+	virtual void queueAudioStream(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+	virtual void queueBuffer(byte *data, uint32 size, DisposeAfterUse::Flag disposeAfterUse, byte flags);
+	virtual void finish() { _finished = true; }
+	virtual uint32 numQueuedStreams() const { return getQueuedSamples() ? 1 : 0; }
+
+	// Implement the RingQueuingAudioStream API
+	virtual int16 *reserve(uint32 &numSamples);
+	virtual void commit(uint32 numSamples);
+	virtual uint32 getFreeSamples() const { return _capacity - getQueuedSamples(); }
+};
+
+RingQueuingAudioStreamImpl::RingQueuingAudioStreamImpl(int rate, bool stereo, uint32 capacity)
+	: _rate(rate), _stereo(stereo), _finished(false) {
+	_capacity = 2;
+	while (_capacity < capacity)
+		_capacity <<= 1;
+	_buffer = (int16 *)malloc(_capacity * sizeof(int16));
+	if (!_buffer)
+		error("RingQueuingAudioStreamImpl: Cannot allocate %u samples", _capacity);
+}
+
+int16 *RingQueuingAudioStreamImpl::reserve(uint32 &numSamples) {
+	assert(!_finished);
+	const uint32 pos = _written.load() & (_capacity - 1);
+	numSamples = MIN(numSamples, MIN(getFreeSamples(), _capacity - pos));
+	return _buffer + pos;
+}
+
+void RingQueuingAudioStreamImpl::commit(uint32 numSamples) {
+	assert(numSamples <= getFreeSamples());
+	_written.store(_written.load() + numSamples);
+}
+
+int RingQueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
+	const uint32 read = _read.load();
+	const uint32 count = MIN<uint32>(numSamples, _written.load() - read);
+
+	// In up to two pieces, the second one from the start of the ring
+	const uint32 pos = read & (_capacity - 1);
+	const uint32 first = MIN(count, _capacity - pos);
+	memcpy(buffer, _buffer + pos, first * sizeof(int16));
+	memcpy(buffer + first, _buffer, (count - first) * sizeof(int16));
+
+	_read.store(read + count);
+	return count;
+}
+
+void RingQueuingAudioStreamImpl::queueAudioStream(AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	if ((stream->getRate() != getRate()) || (stream->isStereo() != isStereo()))
+		error("RingQueuingAudioStreamImpl::queueAudioStream: stream has mismatched parameters");
+
+	while (!stream->endOfData()) {
+		uint32 count = _capacity;
+		int16 *dst = reserve(count);
+		if (!count) {
+			warning("RingQueuingAudioStreamImpl::queueAudioStream: Ring is full, dropping the rest");
+			break;
+		}
+		int read = stream->readBuffer(dst, count);
+		if (read <= 0)
+			break;
+		commit(read);
+	}
+
+	if (disposeAfterUse == DisposeAfterUse::YES)
+		delete stream;
+}
+
+void RingQueuingAudioStreamImpl::queueBuffer(byte *data, uint32 size, DisposeAfterUse::Flag disposeAfterUse, byte flags) {
+	const bool is16Bit = (flags & FLAG_16BITS) != 0;
+	const bool isLE = (flags & FLAG_LITTLE_ENDIAN) != 0;
+	const uint16 xorMask = (flags & FLAG_UNSIGNED) ? 0x8000 : 0;
+	assert(((flags & FLAG_STEREO) != 0) == _stereo);
+
+	const byte *src = data;
+	uint32 numSamples = is16Bit ? size / 2 : size;
+	while (numSamples) {
+		uint32 count = numSamples;
+		int16 *dst = reserve(count);
+		if (!count) {
+			warning("RingQueuingAudioStreamImpl::queueBuffer: Ring is full, dropping %u samples", numSamples);
+			break;
+		}
+
+		// The same conversion as RawStream
+		for (uint32 i = 0; i < count; i++) {
+			if (is16Bit) {
+				dst[i] = (isLE ? READ_LE_UINT16(src) : READ_BE_UINT16(src)) ^ xorMask;
+				src += 2;
+			} else {
+				dst[i] = (*src++ << 8) ^ xorMask;
+			}
+		}
+		commit(count);
+		numSamples -= count;
+	}
+
+	if (disposeAfterUse == DisposeAfterUse::YES)
+		free(data);
+}
+
+RingQueuingAudioStream *makeRingQueuingAudioStream(int rate, bool stereo, uint32 capacity) {
+	return new RingQueuingAudioStreamImpl(rate, stereo, capacity);
+}
+
 Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo) {
 	Timestamp result(where.convertToFramerate(rate * (isStereo ? 2 : 1)));
 
@@ -325,7 +325,7 @@ public:
 	 * @param disposeAfterUse  if equal to DisposeAfterUse::YES, the block is released using free() after use.
 	 * @param flags            a bit-ORed combination of RawFlags describing the audio data format
 	 */
-	void queueBuffer(byte *data, uint32 size, DisposeAfterUse::Flag disposeAfterUse, byte flags);
+	virtual void queueBuffer(byte *data, uint32 size, DisposeAfterUse::Flag disposeAfterUse, byte flags);
 
 	/**
 	 * Mark this stream as finished. That is, signal that no further data
@@ -346,6 +346,56 @@ public:
  */
 QueuingAudioStream *makeQueuingAudioStream(int rate, bool stereo);
 
+/**
+ * A QueuingAudioStream which copies all queued data into one ring buffer
+ * of a fixed number of samples, instead of keeping a stream per queued
+ * block. Streaming into it does not allocate, and producers can decode
+ * straight into the ring with reserve() and commit().
+ *
+ * One thread may queue data while another one reads it, without locking.
+ * Queued blocks and streams are copied right away, so queueBuffer() frees
+ * a block with DisposeAfterUse::YES before it returns. Data that does not
+ * fit into the ring anymore is dropped with a warning; producers should
+ * check getFreeSamples() first.
+ */
+class RingQueuingAudioStream : public QueuingAudioStream {
+public:
+	/**
+	 * Get space for samples in the ring, to be filled with native endian
+	 * signed 16 bit samples and made available with commit().
+	 *
+	 * @param numSamples  the number of samples wanted, set to the number
+	 *                    which fit before the ring wraps around
+	 * @return where to write the samples
+	 */
+	virtual int16 *reserve(uint32 &numSamples) = 0;
+
+	/**
+	 * Make samples written to the space returned by reserve() available
+	 * for playback.
+	 */
+	virtual void commit(uint32 numSamples) = 0;
+
+	/**
+	 * Queue native endian signed 16 bit samples, in up to two pieces.
+	 *
+	 * @return the number of samples queued
+	 */
+	uint32 queueSamples(const int16 *samples, uint32 numSamples);
+
+	/**
+	 * Return the number of samples which can still be queued.
+	 */
+	virtual uint32 getFreeSamples() const = 0;
+};
+
+/**
+ * Factory function for a RingQueuingAudioStream.
+ *
+ * @param capacity  the number of samples the ring holds, rounded up to a power of two
+ */
+RingQueuingAudioStream *makeRingQueuingAudioStream(int rate, bool stereo, uint32 capacity);
+
 /**
  * Converts a point in time to a precise sample offset
  * with the given parameters.
@@ -40,11 +40,12 @@ namespace Audio {
 
 
 /**
- * Channel used by the default Mixer implementation.
+ * Channel used by the default Mixer implementation. It is only ever touched
+ * by the mixer callback, the settings of the channel live in its slot.
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo);
 	~Channel();
 
 	/**
@@ -54,9 +55,11 @@ public:
 	 * @param len  number of sample *pairs*. So a value of
 	 *             10 means that the buffer contains twice 10 sample, each
 	 *             16 bits, for a total of 40 bytes.
+	 * @param volL effective volume of the left channel
+	 * @param volR effective volume of the right channel
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int16 *data, uint len, st_volume_t volL, st_volume_t volR);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -64,106 +67,17 @@ public:
 	bool isFinished() const { return _stream->endOfStream(); }
 
 	/**
-	 * Queries whether the channel is a permanent channel.
-	 * A permanent channel is not affected by a Mixer::stopAll
-	 * call.
+	 * Queries whether the stream has no data right now.
 	 */
-	bool isPermanent() const { return _permanent; }
+	bool isDrained() const { return _stream->endOfData(); }
 
 	/**
-	 * Returns the id of the channel.
+	 * Queries how many samples the channel mixed so far.
 	 */
-	int getId() const { return _id; }
-
-	/**
-	 * Pauses or unpaused the channel in a recursive fashion.
-	 *
-	 * @param paused true, when the channel should be paused.
-	 *               false when it should be unpaused.
-	 */
-	void pause(bool paused);
-
-	/**
-	 * Queries whether the channel is currently paused.
-	 */
-	bool isPaused() const { return (_pauseLevel != 0); }
-
-	/**
-	 * Sets the channel's own volume.
-	 *
-	 * @param volume new volume
-	 */
-	void setVolume(const byte volume);
-
-	/**
-	 * Gets the channel's own volume.
-	 *
-	 * @return volume
-	 */
-	byte getVolume();
-
-	/**
-	 * Sets the channel's balance setting.
-	 *
-	 * @param balance new balance
-	 */
-	void setBalance(const int8 balance);
-
-	/**
-	 * Gets the channel's balance setting.
-	 *
-	 * @return balance
-	 */
-	int8 getBalance();
-
-	/**
-	 * Notifies the channel that the global sound type
-	 * volume settings changed.
-	 */
-	void notifyGlobalVolChange() { updateChannelVolumes(); }
-
-	/**
-	 * Queries how long the channel has been playing.
-	 */
-	Timestamp getElapsedTime();
-
-	/**
-	 * Queries the channel's sound type.
-	 */
-	Mixer::SoundType getType() const { return _type; }
-
-	/**
-	 * Sets the channel's sound handle.
-	 *
-	 * @param handle new handle
-	 */
-	void setHandle(const SoundHandle handle) { _handle = handle; }
-
-	/**
-	 * Queries the channel's sound handle.
-	 */
-	SoundHandle getHandle() const { return _handle; }
+	uint32 getSamplesDecoded() const { return _samplesDecoded; }
 
 private:
-	const Mixer::SoundType _type;
-	SoundHandle _handle;
-	bool _permanent;
-	int _pauseLevel;
-	int _id;
-
-	byte _volume;
-	int8 _balance;
-
-	void updateChannelVolumes();
-	st_volume_t _volL, _volR;
-
-	Mixer *_mixer;
-
-	uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
-	uint32 _mixerTimeStamp;
-	uint32 _pauseStartTime;
-	uint32 _pauseTime;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
@@ -184,6 +98,8 @@ MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
 }
 
 MixerImpl::~MixerImpl() {
+	// Channels which never reached the callback are deleted as well
+	runCommands();
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -196,10 +112,11 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan, SoundType type, int id, byte volume, int8 balance, bool permanent) {
+	// A slot is free once the callback deleted its channel, not when it was stopped
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (_slots[i].handle.load() == kNoHandle) {
 			index = i;
 			break;
 		}
@@ -210,13 +127,32 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
+	ChannelSlot &slot = _slots[index];
+	slot.type = type;
+	slot.id = id;
+	slot.permanent = permanent;
+	slot.pauseStartTime = 0;
+	slot.stopped.store(0);
+	slot.volume.store(volume);
+	slot.balance.store(balance);
+	slot.pauseLevel.store(0);
+	slot.pauseTime.store(0);
+	slot.samplesConsumed.store(0);
+	slot.mixerTimeStamp.store(0);
 
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
-
-	chan->setHandle(chanHandle);
 	_handleSeed++;
+	slot.handle.store(chanHandle._val);
+
+	// Hand the channel to the callback, which picks it up with its next mix
+	uint32 written = _commandsWritten.load();
+	assert(written - _commandsRead.load() < NUM_CHANNELS);
+	PlayCommand &command = _commands[written % NUM_CHANNELS];
+	command.slot = index;
+	command.channel = chan;
+	_commandsWritten.store(written + 1);
+
 	if (handle)
 		*handle = chanHandle;
 }
@@ -242,7 +178,7 @@ void MixerImpl::playStream(
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (isActive(_slots[i]) && _slots[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -260,17 +196,30 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
-	chan->setVolume(volume);
-	chan->setBalance(balance);
-	insertChannel(handle, chan);
+	Channel *chan = new Channel(this, stream, autofreeStream, reverseStereo);
+	insertChannel(handle, chan, type, id, volume, balance, permanent);
+}
+
+void MixerImpl::runCommands() {
+	uint32 read = _commandsRead.load();
+	const uint32 written = _commandsWritten.load();
+	for (; read != written; read++) {
+		const PlayCommand &command = _commands[read % NUM_CHANNELS];
+		assert(!_channels[command.slot]);
+		_channels[command.slot] = command.channel;
+	}
+	_commandsRead.store(read);
+}
+
+void MixerImpl::freeChannel(int index) {
+	delete _channels[index];
+	_channels[index] = 0;
+	_slots[index].handle.store(kNoHandle);
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
-
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -282,41 +231,84 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
+	runCommands();
+
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
-			}
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Channel *chan = _channels[i];
+		if (!chan)
+			continue;
+
+		// Raised before looking at the stop flag, see stopSlot()
+		ChannelSlot &slot = _slots[i];
+		slot.mixing.store(1);
+		if (slot.stopped.load() || chan->isFinished()) {
+			slot.mixing.store(0);
+			freeChannel(i);
+			continue;
 		}
 
+		if (!slot.pauseLevel.load() && !chan->isDrained()) {
+			st_volume_t volL, volR;
+			computeVolumes(slot, volL, volR);
+
+			// getElapsedTime() retries while the sequence is odd
+			const uint32 sequence = slot.timeSequence.load();
+			slot.timeSequence.store(sequence + 1);
+			slot.samplesConsumed.store(chan->getSamplesDecoded());
+			slot.mixerTimeStamp.store(g_system->getMillis(true));
+			slot.pauseTime.store(0);
+			slot.timeSequence.store(sequence + 2);
+
+			tmp = chan->mix(buf, len, volL, volR);
+
+			if (tmp > res)
+				res = tmp;
+		}
+		slot.mixing.store(0);
+	}
+
 	return res;
 }
 
+MixerImpl::ChannelSlot *MixerImpl::findSlot(SoundHandle handle) {
+	if (handle._val == kNoHandle)
+		return 0;
+
+	ChannelSlot &slot = _slots[handle._val % NUM_CHANNELS];
+	if (slot.handle.load() != handle._val || slot.stopped.load())
+		return 0;
+	return &slot;
+}
+
+bool MixerImpl::isActive(const ChannelSlot &slot) const {
+	return slot.handle.load() != kNoHandle && !slot.stopped.load();
+}
+
+void MixerImpl::stopSlot(ChannelSlot &slot) {
+	slot.stopped.store(1);
+
+	// The callback raises its flag before it looks at ours, so it either
+	// skips the stream from now on or is mixing it right now. Callers may
+	// free the stream once we return, so wait for that mix to end.
+	while (slot.mixing.load())
+		g_system->delayMillis(1);
+}
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (isActive(_slots[i]) && !_slots[i].permanent)
+			stopSlot(_slots[i]);
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (isActive(_slots[i]) && _slots[i].id == id)
+			stopSlot(_slots[i]);
 	}
 }
 
@@ -324,63 +316,49 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	delete _channels[index];
-	_channels[index] = 0;
+	ChannelSlot *slot = findSlot(handle);
+	if (slot)
+		stopSlot(*slot);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	_soundTypeSettings[type].mute.store(mute);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	return _soundTypeSettings[type].mute;
+	return _soundTypeSettings[type].mute.load() != 0;
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	ChannelSlot *slot = findSlot(handle);
+	if (slot)
+		slot->volume.store(volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
+	Common::StackLock lock(_mutex);
 
-	return _channels[index]->getVolume();
+	ChannelSlot *slot = findSlot(handle);
+	return slot ? slot->volume.load() : 0;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	ChannelSlot *slot = findSlot(handle);
+	if (slot)
+		slot->balance.store(balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
+	Common::StackLock lock(_mutex);
 
-	return _channels[index]->getBalance();
+	ChannelSlot *slot = findSlot(handle);
+	return slot ? slot->balance.load() : 0;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -390,27 +368,71 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return Timestamp(0, _sampleRate);
+	Audio::Timestamp ts(0, _sampleRate);
+
+	ChannelSlot *slot = findSlot(handle);
+	if (!slot)
+		return ts;
+
+	// The callback updates both values for every mix
+	uint32 sequence, samplesConsumed, mixerTimeStamp;
+	do {
+		sequence = slot->timeSequence.load();
+		samplesConsumed = slot->samplesConsumed.load();
+		mixerTimeStamp = slot->mixerTimeStamp.load();
+	} while ((sequence & 1) || slot->timeSequence.load() != sequence);
+
+	if (mixerTimeStamp == 0)
+		return ts;
+
+	uint32 delta = 0;
+	if (slot->pauseLevel.load())
+		delta = slot->pauseStartTime - mixerTimeStamp;
+	else
+		delta = g_system->getMillis(true) - mixerTimeStamp - slot->pauseTime.load();
+
+	// Convert the number of samples into a time duration.
 
-	return _channels[index]->getElapsedTime();
+	ts = ts.addFrames(samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
+	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
+	// isn't invoked at the regular intervals that I first imagined.
+
+	return ts;
+}
+
+void MixerImpl::pauseSlot(ChannelSlot &slot, bool paused) {
+	const int32 level = slot.pauseLevel.load();
+	if (paused) {
+		if (level == 0)
+			slot.pauseStartTime = g_system->getMillis(true);
+		slot.pauseLevel.store(level + 1);
+	} else if (level > 0) {
+		if (level == 1) {
+			slot.pauseTime.store(g_system->getMillis(true) - slot.pauseStartTime);
+			slot.pauseStartTime = 0;
+		}
+		slot.pauseLevel.store(level - 1);
+	}
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
+		if (isActive(_slots[i]))
+			pauseSlot(_slots[i], paused);
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		if (isActive(_slots[i]) && _slots[i].id == id) {
+			pauseSlot(_slots[i], paused);
 			return;
 		}
 	}
@@ -420,11 +442,9 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	ChannelSlot *slot = findSlot(handle);
+	if (slot)
+		pauseSlot(*slot, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
@@ -435,17 +455,15 @@ bool MixerImpl::isSoundIDActive(int id) {
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isActive(_slots[i]) && _slots[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	ChannelSlot *slot = findSlot(handle);
+	return slot ? slot->id : 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
@@ -455,14 +473,13 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findSlot(handle) != 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isActive(_slots[i]) && _slots[i].type == type)
 			return true;
 	return false;
 }
@@ -479,62 +496,17 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	// The callback picks it up with its next mix
+	_soundTypeSettings[type].volume.store(volume);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 
-	return _soundTypeSettings[type].volume;
-}
-
-
-#pragma mark -
-#pragma mark --- Channel implementations ---
-#pragma mark -
-
-Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
-    : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
-	assert(mixer);
-	assert(stream);
-
-	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	return _soundTypeSettings[type].volume.load();
 }
 
-Channel::~Channel() {
-	delete _converter;
-}
-
-void Channel::setVolume(const byte volume) {
-	_volume = volume;
-	updateChannelVolumes();
-}
-
-byte Channel::getVolume() {
-	return _volume;
-}
-
-void Channel::setBalance(const int8 balance) {
-	_balance = balance;
-	updateChannelVolumes();
-}
-
-int8 Channel::getBalance() {
-	return _balance;
-}
-
-void Channel::updateChannelVolumes() {
+void MixerImpl::computeVolumes(const ChannelSlot &slot, st_volume_t &volL, st_volume_t &volR) const {
 	// From the channel balance/volume and the global volume, we compute
 	// the effective volume for the left and right channel. Note the
 	// slightly odd divisor: the 255 reflects the fact that the maximal
@@ -543,85 +515,49 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
+	if (!isSoundTypeMuted(slot.type)) {
+		const int vol = getVolumeForSoundType(slot.type) * slot.volume.load();
+		const int balance = slot.balance.load();
 
-		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
-		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+		if (balance == 0) {
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = vol / Mixer::kMaxChannelVolume;
+		} else if (balance < 0) {
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = ((127 + balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = ((127 - balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volR = vol / Mixer::kMaxChannelVolume;
 		}
 	} else {
-		_volL = _volR = 0;
+		volL = volR = 0;
 	}
 }
 
-void Channel::pause(bool paused) {
-	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
-	if (paused) {
-		_pauseLevel++;
+#pragma mark -
+#pragma mark --- Channel implementations ---
+#pragma mark -
 
-		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
-	} else if (_pauseLevel > 0) {
-		_pauseLevel--;
+Channel::Channel(Mixer *mixer, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo)
+    : _samplesDecoded(0), _converter(0), _stream(stream, autofreeStream) {
+	assert(mixer);
+	assert(stream);
 
-		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
-			_pauseStartTime = 0;
-		}
-	}
+	// Get a rate converter instance
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
+Channel::~Channel() {
+	delete _converter;
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int16 *data, uint len, st_volume_t volL, st_volume_t volR) {
 	assert(_stream);
+	assert(_converter);
 
-	int res = 0;
-	if (_stream->endOfData()) {
-		// TODO: call drain method
-	} else {
-		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
-		_samplesDecoded += res;
-	}
-
+	int res = _converter->flow(*_stream, data, len, volL, volR);
+	_samplesDecoded += res;
 	return res;
 }
 
@@ -24,8 +24,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -46,6 +48,12 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * The mixer callback never takes a lock. Channel parameters live in atomic
+ * slots which the callback reads at the start of every mix, new channels
+ * reach it through a single producer, single consumer command queue, and
+ * stopped channels are flagged in their slot and deleted by the callback.
+ * The game side methods are serialised among themselves by _mutex.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
@@ -54,6 +62,11 @@ private:
 		NUM_CHANNELS = 32 // ResidualVM specific
 	};
 
+	enum {
+		kNoHandle = 0xFFFFFFFF
+	};
+
+	// Serialises the game side methods, the mixer callback never takes it
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
@@ -63,12 +76,66 @@ private:
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		Common::Atomic<int32> mute;
+		Common::Atomic<int32> volume;
+	};
+
+	/**
+	 * The state of a channel shared between the game and the mixer
+	 * callback. The atomic fields are read or written by the callback, the
+	 * others are only touched by the game side with _mutex held, and are
+	 * set before the slot is handed to the callback.
+	 */
+	struct ChannelSlot {
+		ChannelSlot() : handle(kNoHandle), type(kPlainSoundType), id(-1), permanent(false), pauseStartTime(0) {}
+
+		Common::Atomic<uint32> handle;        // kNoHandle until the callback deleted the channel
+		Common::Atomic<int32> stopped;        // the callback must not touch the stream anymore
+		Common::Atomic<int32> mixing;         // the callback is using the stream right now
+		Common::Atomic<int32> volume;
+		Common::Atomic<int32> balance;
+		Common::Atomic<int32> pauseLevel;
+		Common::Atomic<uint32> pauseTime;
+
+		// Written by the callback for every mix, odd while they are being written
+		Common::Atomic<uint32> timeSequence;
+		Common::Atomic<uint32> samplesConsumed;
+		Common::Atomic<uint32> mixerTimeStamp;
+
+		SoundType type;
+		int id;
+		bool permanent;
+		uint32 pauseStartTime;
+	};
+
+	/**
+	 * A new channel for the mixer callback. Every queued channel holds a
+	 * slot, so the queue can never hold more than NUM_CHANNELS of them.
+	 */
+	struct PlayCommand {
+		int slot;
+		Channel *channel;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
+	ChannelSlot _slots[NUM_CHANNELS];
+	Channel *_channels[NUM_CHANNELS];	// only touched by the mixer callback
+
+	PlayCommand _commands[NUM_CHANNELS];
+	Common::Atomic<uint32> _commandsWritten;
+	Common::Atomic<uint32> _commandsRead;
+
+	/**
+	 * Find the slot of a channel which was neither stopped nor finished.
+	 */
+	ChannelSlot *findSlot(SoundHandle handle);
+	bool isActive(const ChannelSlot &slot) const;
+	void stopSlot(ChannelSlot &slot);
+	void pauseSlot(ChannelSlot &slot, bool paused);
+
+	void runCommands();
+	void freeChannel(int index);
+	void computeVolumes(const ChannelSlot &slot, st_volume_t &volL, st_volume_t &volR) const;
 
 
 public:
@@ -119,7 +186,7 @@ public:
 	virtual uint getOutputRate() const;
 
 protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	void insertChannel(SoundHandle *handle, Channel *chan, SoundType type, int id, byte volume, int8 balance, bool permanent);
 
 public:
 	/**
@@ -30,6 +30,8 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_simd.h"
+#include "audio/rate_sinc.h"
 #include "audio/mixer.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
@@ -47,6 +49,32 @@ namespace Audio {
 #define INTERMEDIATE_BUFFER_SIZE 512
 
 
+/**
+ * Scale the resampled frames by the channel volumes and add them to the
+ * output. The vectorised kernels take what they can, the rest is mixed here.
+ */
+template<bool stereo, bool reverseStereo>
+static void mixFrames(st_sample_t *obuf, const st_sample_t *in, int frames, st_volume_t vol_l, st_volume_t vol_r) {
+	int done = mixFramesSIMD(obuf, in, frames, stereo, reverseStereo, vol_l, vol_r);
+	obuf += done * 2;
+	in += done * (stereo ? 2 : 1);
+
+	for (; done < frames; done++) {
+		st_sample_t out0, out1;
+		out0 = *in++;
+		out1 = (stereo ? *in++ : out0);
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -67,6 +95,12 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	/**
+	 * Pick up to frames frames from the input.
+	 * @return the number of frames, less at the end of the input
+	 */
+	int resample(AudioStream &input, st_sample_t *out, int frames);
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -102,13 +136,8 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
-
-	ostart = obuf;
-	oend = obuf + osamp * 2;
-
-	while (obuf < oend) {
+int SimpleRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *out, int frames) {
+	for (int n = 0; n < frames; n++) {
 
 		// read enough input samples so that opos >= 0
 		do {
@@ -117,7 +146,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return n;
 			}
 			inLen -= (stereo ? 2 : 1);
 			opos--;
@@ -126,20 +155,31 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			}
 		} while (opos >= 0);
 
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
+		*out++ = *inPtr++;
+		if (stereo)
+			*out++ = *inPtr++;
 
 		// Increment output position
 		opos += opos_inc;
+	}
+	return frames;
+}
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+template<bool stereo, bool reverseStereo>
+int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t *ostart, *oend;
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	ostart = obuf;
+	oend = obuf + osamp * 2;
 
-		obuf += 2;
+	while (obuf < oend) {
+		const int frames = MIN<int>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1));
+		const int n = resample(input, outBuf, frames);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, n, vol_l, vol_r);
+		obuf += n * 2;
+		if (n < frames)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -173,6 +213,12 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/**
+	 * Interpolate up to frames frames from the input.
+	 * @return the number of frames, less at the end of the input
+	 */
+	int resample(AudioStream &input, st_sample_t *out, int frames);
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -211,13 +257,8 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
-
-	ostart = obuf;
-	oend = obuf + osamp * 2;
-
-	while (obuf < oend) {
+int LinearRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *out, int frames) {
+	for (int n = 0; n < frames; n++) {
 
 		// read enough input samples so that opos < 0
 		while ((frac_t)FRAC_ONE <= opos) {
@@ -226,7 +267,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 				inPtr = inBuf;
 				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
 				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+					return n;
 			}
 			inLen -= (stereo ? 2 : 1);
 			ilast0 = icur0;
@@ -238,27 +279,154 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 			opos -= FRAC_ONE;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS)) :
-						  out0);
+		// interpolate
+		*out++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
+		if (stereo)
+			*out++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS));
+
+		// Increment output position
+		opos += opos_inc;
+	}
+	return frames;
+}
+
+template<bool stereo, bool reverseStereo>
+int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+		const int frames = MIN<int>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1));
+		const int n = resample(input, outBuf, frames);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, n, vol_l, vol_r);
+		obuf += n * 2;
+		if (n < frames)
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
+/**
+ * Audio rate converter based on a windowed sinc filter, whose coefficients
+ * are precomputed for the pair of rates, see rate_sinc.cpp. It costs a
+ * multiple of linear interpolation, but filters out what would alias.
+ *
+ * Limited to sampling frequency <= 65535 Hz, and to rates dropping to no
+ * less than a quarter.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	enum {
+		kHistorySize = INTERMEDIATE_BUFFER_SIZE + kSincMaxTaps
+	};
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+	/** the input frames of each channel, the filter starts at histPos */
+	st_sample_t hist[stereo ? 2 : 1][kHistorySize];
+	int histPos;
+	int histLen;
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	const SincFilter *filter;
 
-			obuf += 2;
+	/** position of the output stream between two input frames, in 1 / filter->phases */
+	uint32 phase;
 
-			// Increment output position
-			opos += opos_inc;
+	/**
+	 * Filter up to frames frames from the input.
+	 * @return the number of frames, less at the end of the input
+	 */
+	int resample(AudioStream &input, st_sample_t *out, int frames);
+
+public:
+	SincRateConverter(const SincFilter *f);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(const SincFilter *f) {
+	filter = f;
+	phase = 0;
+
+	// Silence before the start, so the first output frame is the first input frame
+	memset(hist, 0, sizeof(hist));
+	histPos = 0;
+	histLen = filter->taps / 2 - 1;
+
+	inLen = 0;
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *out, int frames) {
+	const int taps = filter->taps;
+
+	for (int n = 0; n < frames; n++) {
+
+		// read enough input frames for the whole filter
+		while (histPos + taps > histLen) {
+			// Check if we have to refill the buffer
+			if (inLen == 0) {
+				inPtr = inBuf;
+				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+				if (inLen <= 0)
+					return n;
+			}
+			// Move the frames still needed to the front
+			if (histLen == kHistorySize) {
+				for (int c = 0; c < (stereo ? 2 : 1); c++)
+					memmove(hist[c], hist[c] + histPos, (histLen - histPos) * sizeof(st_sample_t));
+				histLen -= histPos;
+				histPos = 0;
+			}
+			const int count = MIN<int>(inLen / (stereo ? 2 : 1), kHistorySize - histLen);
+			for (int i = 0; i < count; i++) {
+				hist[0][histLen + i] = *inPtr++;
+				if (stereo)
+					hist[1][histLen + i] = *inPtr++;
+			}
+			histLen += count;
+			inLen -= count * (stereo ? 2 : 1);
 		}
+
+		// filter, the coefficients are Q14
+		const int16 *coefs = filter->coefs + (phase * filter->banks / filter->phases) * taps;
+		*out++ = (st_sample_t)CLIP<int32>((dotProduct(hist[0] + histPos, coefs, taps) + (1 << 13)) >> 14, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		if (stereo)
+			*out++ = (st_sample_t)CLIP<int32>((dotProduct(hist[1] + histPos, coefs, taps) + (1 << 13)) >> 14, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+
+		// Increment output position
+		phase += filter->step;
+		histPos += phase / filter->phases;
+		phase %= filter->phases;
+	}
+	return frames;
+}
+
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+		const int frames = MIN<int>((oend - obuf) / 2, ARRAYSIZE(outBuf) / (stereo ? 2 : 1));
+		const int n = resample(input, outBuf, frames);
+		mixFrames<stereo, reverseStereo>(obuf, outBuf, n, vol_l, vol_r);
+		obuf += n * 2;
+		if (n < frames)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -283,11 +451,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -305,21 +470,9 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		const int frames = MAX<int>(len, 0) / (stereo ? 2 : 1);
+		mixFrames<stereo, reverseStereo>(obuf, _buffer, frames, vol_l, vol_r);
+		return frames;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -333,7 +486,13 @@ public:
 template<bool stereo, bool reverseStereo>
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0) {
+		const SincFilter *filter = nullptr;
+		if (useSincResampler() && inrate <= outrate * kSincMaxDownsampling && inrate < 65536 && outrate < 65536)
+			filter = getSincFilter(inrate, outrate);
+
+		if (filter) {
+			return new SincRateConverter<stereo, reverseStereo>(filter);
+		} else if ((inrate % outrate) == 0) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
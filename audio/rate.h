@@ -80,6 +80,20 @@ public:
 
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
 
+/**
+ * Allow the rate converters to mix with the vectorised kernels when the
+ * CPU has them, which is the default. The output is the same either way.
+ */
+void setUseRateSIMD(bool useSIMD);
+
+/**
+ * Let rate converters created from now on resample with a windowed sinc
+ * filter, instead of linear interpolation or dropping frames. It costs
+ * more, but does not alias. Off by default, and not available with the
+ * ARM assembly converters.
+ */
+void setUseSincResampler(bool useSinc);
+
 } // End of namespace Audio
 
 #endif
@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/intrinsics.h"
+
+#include "audio/mixer.h"
+#include "audio/rate_simd.h"
+
+namespace Audio {
+
+static bool useSIMD = true;
+
+void setUseRateSIMD(bool use) {
+	useSIMD = use;
+}
+
+// The kernels mix into signed samples and divide by shifting
+#if defined(HAVE_SSE2_INTRINSICS) && !defined(OUTPUT_UNSIGNED_AUDIO)
+
+bool hasRateSIMD() {
+	// SSE2 is part of every CPU the compiler was allowed to target
+	return Mixer::kMaxMixerVolume == 256;
+}
+
+/**
+ * Scale 8 samples by their volumes. Like the scalar code the division by
+ * kMaxMixerVolume rounds toward zero, and the result always fits 16 bits.
+ */
+static inline __m128i scale8(__m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	const __m128i bias = _mm_set1_epi32(Mixer::kMaxMixerVolume - 1);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+static inline void accumulate8(st_sample_t *obuf, __m128i samples) {
+	__m128i out = _mm_loadu_si128((const __m128i *)obuf);
+	_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, samples));
+}
+
+int mixFramesSIMD(st_sample_t *obuf, const st_sample_t *in, int frames, bool stereo, bool reverseStereo,
+                  st_volume_t vol_l, st_volume_t vol_r) {
+	if (!useSIMD || !hasRateSIMD())
+		return 0;
+
+	// The left output always gets vol_l, swapping the input takes care of the rest
+	const int16 l = reverseStereo ? vol_r : vol_l;
+	const int16 r = reverseStereo ? vol_l : vol_r;
+	const __m128i vol = _mm_set_epi16(r, l, r, l, r, l, r, l);
+
+	int done = 0;
+	if (stereo) {
+		for (; done + 4 <= frames; done += 4) {
+			__m128i samples = _mm_loadu_si128((const __m128i *)(in + done * 2));
+			if (reverseStereo) {
+				samples = _mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+				samples = _mm_shufflehi_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+			}
+			accumulate8(obuf + done * 2, scale8(samples, vol));
+		}
+	} else {
+		for (; done + 8 <= frames; done += 8) {
+			const __m128i samples = _mm_loadu_si128((const __m128i *)(in + done));
+			accumulate8(obuf + done * 2, scale8(_mm_unpacklo_epi16(samples, samples), vol));
+			accumulate8(obuf + done * 2 + 8, scale8(_mm_unpackhi_epi16(samples, samples), vol));
+		}
+	}
+	return done;
+}
+
+#else
+
+bool hasRateSIMD() {
+	return false;
+}
+
+int mixFramesSIMD(st_sample_t *obuf, const st_sample_t *in, int frames, bool stereo, bool reverseStereo,
+                  st_volume_t vol_l, st_volume_t vol_r) {
+	return 0;
+}
+
+#endif
+
+int32 dotProduct(const st_sample_t *samples, const int16 *coefs, int length) {
+#ifdef HAVE_SSE2_INTRINSICS
+	// The pairwise sums cannot overflow, the filter coefficients are Q14
+	if (useSIMD) {
+		__m128i sum = _mm_setzero_si128();
+		for (int i = 0; i < length; i += 8) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)(samples + i));
+			const __m128i c = _mm_loadu_si128((const __m128i *)(coefs + i));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(s, c));
+		}
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(sum);
+	}
+#endif
+
+	int32 sum = 0;
+	for (int i = 0; i < length; i++)
+		sum += samples[i] * coefs[i];
+	return sum;
+}
+
+} // End of namespace Audio
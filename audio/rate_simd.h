@@ -0,0 +1,66 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * Vectorised mixing and filter kernels for the rate converters. They
+ * produce exactly the same samples as the scalar code.
+ */
+
+#ifndef AUDIO_RATE_SIMD_H
+#define AUDIO_RATE_SIMD_H
+
+#include "common/scummsys.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Whether the vectorised kernels are available on this build and CPU.
+ */
+bool hasRateSIMD();
+
+/**
+ * Scale frames by the channel volumes and add them to a stereo buffer with
+ * saturation, in blocks of 4 stereo or 8 mono frames.
+ *
+ * @param obuf          the stereo output
+ * @param in            the input frames, interleaved when stereo
+ * @param frames        the number of input frames
+ * @param stereo        whether the input is stereo, mono input goes to both sides
+ * @param reverseStereo whether the input channels are swapped in the output
+ * @return the number of frames mixed, the caller mixes the rest
+ */
+int mixFramesSIMD(st_sample_t *obuf, const st_sample_t *in, int frames, bool stereo, bool reverseStereo,
+                  st_volume_t vol_l, st_volume_t vol_r);
+
+/**
+ * Multiply samples by as many filter coefficients and sum the products,
+ * vectorised when possible. The sum is the same either way.
+ *
+ * @param length  the number of samples, a multiple of 8
+ */
+int32 dotProduct(const st_sample_t *samples, const int16 *coefs, int length);
+
+} // End of namespace Audio
+
+#endif
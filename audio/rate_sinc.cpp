@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/algorithm.h"
+#include "common/atomic.h"
+#include "common/math.h"
+#include "common/system.h"
+#include "common/util.h"
+
+#include "audio/rate_sinc.h"
+
+namespace Audio {
+
+enum {
+	/** Rate pairs with more phases use the nearest of this many */
+	kSincMaxBanks = 1024,
+	/** The most pairs of rates with a filter bank */
+	kSincMaxFilters = 64
+};
+
+/** The passband, as part of the lower of the two Nyquist frequencies */
+static const double kSincCutoff = 0.9;
+/** The shape of the Kaiser window, for about 70 dB of stopband attenuation */
+static const double kSincBeta = 7.0;
+
+static bool useSinc = false;
+
+void setUseSincResampler(bool use) {
+	useSinc = use;
+}
+
+bool useSincResampler() {
+	return useSinc;
+}
+
+/**
+ * The modified Bessel function of the first kind and order zero, which
+ * shapes the Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+static SincFilter *makeSincFilter(st_rate_t inrate, st_rate_t outrate) {
+	assert(inrate <= outrate * kSincMaxDownsampling);
+	const uint32 divisor = Common::gcd<uint32>(inrate, outrate);
+	SincFilter *filter = new SincFilter();
+	filter->phases = outrate / divisor;
+	filter->step = inrate / divisor;
+	filter->banks = MIN<uint32>(filter->phases, kSincMaxBanks);
+
+	// Downsampling moves the cutoff below the input Nyquist frequency, the
+	// filter gets as much longer to keep its transition band as steep
+	const double scale = MIN(1.0, (double)outrate / inrate);
+	const int taps = (int)ceil(kSincBaseTaps / scale);
+	filter->taps = MIN<int>((taps + 7) & ~7, kSincMaxTaps);
+	filter->coefs = new int16[filter->banks * filter->taps];
+
+	const double cutoff = kSincCutoff * scale;
+	const int half = filter->taps / 2;
+	for (uint32 bank = 0; bank < filter->banks; bank++) {
+		const double frac = (double)bank / filter->banks;
+		double coefs[kSincMaxTaps];
+		double sum = 0.0;
+		for (int k = 0; k < filter->taps; k++) {
+			// Input frame half - 1 is the one at or right before the output frame
+			const double x = frac + half - 1 - k;
+			const double r = x / half;
+			const double window = (fabs(r) < 1.0) ? besselI0(kSincBeta * sqrt(1.0 - r * r)) / besselI0(kSincBeta) : 0.0;
+			const double sinc = (x == 0.0) ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			coefs[k] = sinc * window;
+			sum += coefs[k];
+		}
+
+		// Every phase passes DC unchanged. The magnitudes of the coefficients
+		// add up to about twice their sum, Q14 keeps the 32 bit sums of full
+		// scale input from overflowing.
+		int16 *dst = filter->coefs + bank * filter->taps;
+		int32 total = 0;
+		for (int k = 0; k < filter->taps; k++) {
+			dst[k] = (int16)floor(coefs[k] * 16384.0 / sum + 0.5);
+			total += ABS<int32>(dst[k]);
+		}
+		assert(total < 65536);
+	}
+	return filter;
+}
+
+enum FilterSlotState {
+	kSlotFree,
+	kSlotBuilding,
+	kSlotReady
+};
+
+/**
+ * The filter banks, in the order they were first asked for. The game thread
+ * and timer threads create converters, so a slot is claimed before its bank
+ * is built, and anyone asking for the same rates meanwhile sleeps until it
+ * is done.
+ */
+static Common::Atomic<uint32> slotStates[kSincMaxFilters];
+static uint32 slotKeys[kSincMaxFilters];
+static SincFilter *slotFilters[kSincMaxFilters];
+
+const SincFilter *getSincFilter(st_rate_t inrate, st_rate_t outrate) {
+	const uint32 key = (inrate << 16) | outrate;
+	for (int i = 0; i < kSincMaxFilters; i++) {
+		if (slotStates[i].compareExchange(kSlotFree, kSlotBuilding)) {
+			slotKeys[i] = key;
+			slotFilters[i] = makeSincFilter(inrate, outrate);
+			slotStates[i].store(kSlotReady);
+			return slotFilters[i];
+		}
+		while (slotStates[i].load() != kSlotReady)
+			g_system->delayMillis(1);
+		if (slotKeys[i] == key)
+			return slotFilters[i];
+	}
+	return nullptr;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * Filter banks of the windowed sinc rate converter.
+ */
+
+#ifndef AUDIO_RATE_SINC_H
+#define AUDIO_RATE_SINC_H
+
+#include "common/scummsys.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+enum {
+	/** The coefficients per phase when upsampling, downsampling needs more */
+	kSincBaseTaps = 32,
+	/** The most input frames per output frame the filters handle */
+	kSincMaxDownsampling = 4,
+	/** The most coefficients a filter bank has per phase */
+	kSincMaxTaps = kSincBaseTaps * kSincMaxDownsampling
+};
+
+/**
+ * A polyphase filter bank for one pair of rates. Every output frame moves
+ * step / phases input frames further; phase p interpolates p / phases of
+ * the way from one input frame to the next.
+ */
+struct SincFilter {
+	uint32 phases;	///< the output rate divided by the GCD of both rates
+	uint32 step;	///< the input rate divided by the GCD of both rates
+	uint32 banks;	///< the number of coefficient sets, phases or fewer
+	int taps;		///< the coefficients per set, a multiple of 8
+	int16 *coefs;	///< banks sets of Q14 coefficients, oldest input frame first
+};
+
+/**
+ * Whether new rate converters resample with the windowed sinc filters.
+ */
+bool useSincResampler();
+
+/**
+ * Get the filter bank for a pair of rates. Banks are computed on first use
+ * and kept for the rest of the run, so the mixer thread can drop converters
+ * without releasing anything.
+ *
+ * @return the bank, or 0 when there are too many pairs of rates already
+ */
+const SincFilter *getSincFilter(st_rate_t inrate, st_rate_t outrate);
+
+} // End of namespace Audio
+
+#endif
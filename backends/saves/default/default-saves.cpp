@@ -143,6 +143,23 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 }
 
+bool DefaultSaveFileManager::renameSavefile(const Common::String &oldFilename, const Common::String &newFilename) {
+	Common::String savePathName = getSavePath();
+	checkPath(Common::FSNode(savePathName));
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	Common::FSNode savePath(savePathName);
+	Common::FSNode oldFile = savePath.getChild(oldFilename);
+	Common::FSNode newFile = savePath.getChild(newFilename);
+
+	// Replaces newFilename in one go where the system allows it. Where it does
+	// not (rename does not replace existing files on Windows), copy the file.
+	if (rename(oldFile.getPath().c_str(), newFile.getPath().c_str()) == 0)
+		return true;
+	return Common::SaveFileManager::renameSavefile(oldFilename, newFilename);
+}
+
 Common::String DefaultSaveFileManager::getSavePath() const {
 
 	Common::String dir;
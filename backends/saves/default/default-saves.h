@@ -40,6 +40,7 @@ public:
 	virtual Common::InSaveFile *openForLoading(const Common::String &filename);
 	virtual Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true);
 	virtual bool removeSavefile(const Common::String &filename);
+	virtual bool renameSavefile(const Common::String &oldFilename, const Common::String &newFilename);
 
 protected:
 	/**
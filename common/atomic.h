@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+extern "C" long _InterlockedExchange(long volatile *target, long value);
+extern "C" long _InterlockedCompareExchange(long volatile *target, long value, long comparand);
+extern "C" void _ReadWriteBarrier();
+#pragma intrinsic(_InterlockedExchange)
+#pragma intrinsic(_InterlockedCompareExchange)
+#pragma intrinsic(_ReadWriteBarrier)
+#endif
+
+namespace Common {
+
+/**
+ * A 32 bit value shared between threads without a mutex, for instance
+ * between the game and the audio callback. Loads and stores are
+ * sequentially consistent, so a store followed by a load of another
+ * Atomic is never reordered.
+ *
+ * On compilers without atomic operations this is a plain volatile
+ * value, which is only good enough on single core machines.
+ */
+template<class T>
+class Atomic {
+public:
+	Atomic(T value = 0) : _value(value) {}
+
+	T load() const {
+#if GCC_ATLEAST(4, 7) || defined(__clang__)
+		return __atomic_load_n(&_value, __ATOMIC_SEQ_CST);
+#elif defined(__GNUC__)
+		__sync_synchronize();
+		T value = _value;
+		__sync_synchronize();
+		return value;
+#elif defined(_MSC_VER)
+		_ReadWriteBarrier();
+		T value = _value;
+		_ReadWriteBarrier();
+		return value;
+#else
+		return _value;
+#endif
+	}
+
+	void store(T value) {
+#if GCC_ATLEAST(4, 7) || defined(__clang__)
+		__atomic_store_n(&_value, value, __ATOMIC_SEQ_CST);
+#elif defined(__GNUC__)
+		__sync_synchronize();
+		_value = value;
+		__sync_synchronize();
+#elif defined(_MSC_VER)
+		_InterlockedExchange((long volatile *)&_value, (long)value);
+#else
+		_value = value;
+#endif
+	}
+
+	/**
+	 * Replace the value with desired if it is still expected.
+	 *
+	 * @return whether the value was replaced
+	 */
+	bool compareExchange(T expected, T desired) {
+#if GCC_ATLEAST(4, 7) || defined(__clang__)
+		return __atomic_compare_exchange_n(&_value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(__GNUC__)
+		return __sync_bool_compare_and_swap(&_value, expected, desired);
+#elif defined(_MSC_VER)
+		return _InterlockedCompareExchange((long volatile *)&_value, (long)desired, (long)expected) == (long)expected;
+#else
+		if (_value != expected)
+			return false;
+		_value = desired;
+		return true;
+#endif
+	}
+
+private:
+	// Sharing the value is the point, copying it is not
+	Atomic(const Atomic &);
+	Atomic &operator=(const Atomic &);
+
+	volatile T _value;
+};
+
+} // End of namespace Common
+
+#endif
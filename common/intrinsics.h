@@ -0,0 +1,51 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_INTRINSICS_H
+#define COMMON_INTRINSICS_H
+
+/**
+ * @file
+ * The SIMD intrinsics the compiler may use without special flags.
+ *
+ * Defines HAVE_SSE_INTRINSICS and HAVE_SSE2_INTRINSICS when the SSE and
+ * SSE2 intrinsics are available, which they always are on x86-64.
+ *
+ * The intrinsics headers pull in system headers, so this file has to be
+ * included before any other header, and in particular before forbidden.h.
+ */
+
+#if defined(COMMON_FORBIDDEN_H) && !defined(FORBIDDEN_SYMBOL_ALLOW_ALL)
+#error "common/intrinsics.h must be included before any other header"
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+#endif
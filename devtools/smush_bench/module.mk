@@ -0,0 +1,18 @@
+MODULE := devtools/smush_bench
+
+MODULE_OBJS := \
+	smush_bench.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := smush_bench
+
+# The decoder is taken from the engine, the rest from libcommon
+TOOL_DEPS := \
+	engines/grim/movie/codecs/blocky16.o \
+	common/libcommon.a
+
+# zlib, for the compressed movies
+$(MODULE)/$(TOOL_EXECUTABLE)$(EXEEXT): TOOL_LIBS := $(LIBS)
+
+# Include common rules
+include $(srcdir)/rules.mk
@@ -0,0 +1,181 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Decodes the video of a retail Grim Fandango SMUSH movie (.snm) without
+// the engine, once with the wide Blocky16 copies and once without, and
+// compares the frames of both runs. Usage: smush_bench <file.snm> [runs]
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common/array.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/zlib.h"
+
+#include "engines/grim/movie/codecs/blocky16.h"
+
+struct Movie {
+	int width, height;
+	// The Bl16 chunk of every frame
+	Common::Array<Common::Array<byte> > frames;
+};
+
+static bool readMovie(Common::SeekableReadStream *stream, Movie &movie) {
+	if (stream->readUint32BE() != MKTAG('S', 'A', 'N', 'M')) {
+		fprintf(stderr, "Not a retail SMUSH movie\n");
+		return false;
+	}
+	stream->readUint32BE();
+
+	if (stream->readUint32BE() != MKTAG('S', 'H', 'D', 'R'))
+		return false;
+	uint32 size = stream->readUint32BE();
+	int32 pos = stream->pos();
+	stream->readUint16LE();
+	stream->readUint32LE(); // number of frames
+	stream->readUint16LE();
+	movie.width = stream->readUint16LE();
+	movie.height = stream->readUint16LE();
+	stream->seek(pos + size + (size & 1), SEEK_SET);
+
+	if (stream->readUint32BE() != MKTAG('F', 'L', 'H', 'D'))
+		return false;
+	size = stream->readUint32BE();
+	stream->seek(size, SEEK_CUR);
+
+	while (!stream->eos()) {
+		uint32 tag = stream->readUint32BE();
+		size = stream->readUint32BE();
+		if (stream->eos())
+			break;
+		if (tag != MKTAG('F', 'R', 'M', 'E')) {
+			stream->seek(size + (size & 1), SEEK_CUR);
+			continue;
+		}
+
+		int32 end = stream->pos() + size;
+		while (stream->pos() < end) {
+			uint32 subType = stream->readUint32BE();
+			uint32 subSize = stream->readUint32BE();
+			if (subType == MKTAG('B', 'l', '1', '6')) {
+				movie.frames.push_back(Common::Array<byte>());
+				Common::Array<byte> &frame = movie.frames.back();
+				frame.resize(subSize);
+				stream->read(&frame[0], subSize);
+				stream->seek(subSize & 1, SEEK_CUR);
+			} else {
+				stream->seek(subSize + (subSize & 1), SEEK_CUR);
+			}
+		}
+		stream->seek(end, SEEK_SET);
+	}
+	return !movie.frames.empty();
+}
+
+// Decodes all the frames runs times, returns the time in ms of the fastest run
+static double decodeMovie(const Movie &movie, int runs, Common::Array<Common::String> &checksums) {
+	const uint32 frameSize = movie.width * movie.height * 2;
+	byte *pixels = new byte[frameSize];
+	double best = 0;
+
+	for (int run = 0; run < runs; run++) {
+		Grim::Blocky16 blocky16;
+		blocky16.init(movie.width, movie.height);
+		checksums.clear();
+
+		double time = 0;
+		for (uint i = 0; i < movie.frames.size(); i++) {
+			clock_t start = clock();
+			blocky16.decode(pixels, &movie.frames[i][0]);
+			time += (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+			Common::MemoryReadStream frame(pixels, frameSize);
+			checksums.push_back(Common::computeStreamMD5AsString(frame));
+		}
+		if (run == 0 || time < best)
+			best = time;
+	}
+
+	delete[] pixels;
+	return best;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <file.snm> [runs]\n", argv[0]);
+		return 1;
+	}
+	const int runs = argc > 2 ? MAX(atoi(argv[2]), 1) : 5;
+
+	FILE *file = fopen(argv[1], "rb");
+	if (!file) {
+		fprintf(stderr, "Could not open %s\n", argv[1]);
+		return 1;
+	}
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	byte *data = (byte *)malloc(fileSize);
+	if (fread(data, 1, fileSize, file) != (size_t)fileSize) {
+		fprintf(stderr, "Could not read %s\n", argv[1]);
+		fclose(file);
+		free(data);
+		return 1;
+	}
+	fclose(file);
+
+	// The movies in the game archives are gzip compressed
+	Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+		new Common::MemoryReadStream(data, fileSize, DisposeAfterUse::YES));
+	Movie movie;
+	bool loaded = readMovie(stream, movie);
+	delete stream;
+	if (!loaded) {
+		fprintf(stderr, "Could not read the frames of %s\n", argv[1]);
+		return 1;
+	}
+
+	Common::Array<Common::String> checksums, reference;
+	Grim::Blocky16::setWideCopies(true);
+	double wide = decodeMovie(movie, runs, checksums);
+	Grim::Blocky16::setWideCopies(false);
+	double scalar = decodeMovie(movie, runs, reference);
+
+	const uint frames = movie.frames.size();
+	printf("%dx%d, %u frames\n", movie.width, movie.height, frames);
+	printf("wide:   %.1f ms, %.1f fps\n", wide, wide > 0 ? frames * 1000.0 / wide : 0.0);
+	printf("scalar: %.1f ms, %.1f fps\n", scalar, scalar > 0 ? frames * 1000.0 / scalar : 0.0);
+
+	for (uint i = 0; i < frames; i++) {
+		if (checksums[i] != reference[i]) {
+			printf("Frame %u differs: %s, scalar %s\n", i, checksums[i].c_str(), reference[i].c_str());
+			return 1;
+		}
+	}
+	printf("All frames match\n");
+	return 0;
+}
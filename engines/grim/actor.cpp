@@ -2222,18 +2222,10 @@ Math::Vector3d Actor::getHeadPos() const {
 		ModelNode *allNodes = (*i)->getModelNodes();
 		ModelNode *node = allNodes + headJoint;
 
-		node->_needsUpdate = true;
-		ModelNode *root = node;
-		while (root->_parent) {
-			root = root->_parent;
-			root->_needsUpdate = true;
-		}
-
 		Math::Matrix4 matrix;
 		matrix.setPosition(_pos);
 		matrix.buildFromXYZ(_yaw, _pitch, _roll, Math::EO_ZXY);
-		root->setMatrix(matrix);
-		root->update();
+		node->updateFromRoot(matrix);
 
 		return node->_pivotMatrix.getPosition();
 	}
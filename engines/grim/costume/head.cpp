@@ -46,14 +46,7 @@ void Head::Joint::orientTowards(bool entering, const Math::Vector3d &point, floa
 		return;
 
 	// Make sure we have up-to-date world transform matrices computed for the joint nodes of this character.
-	_node->_needsUpdate = true;
-	ModelNode *p = _node;
-	while (p->_parent) {
-		p = p->_parent;
-		p->_needsUpdate = true;
-	}
-	p->setMatrix(matrix);
-	p->update();
+	_node->updateFromRoot(matrix);
 
 	Math::Vector3d modelFront; // the modeling convention for the forward direction.
 	Math::Vector3d modelUp; // the modeling convention for the upward direction.
@@ -148,7 +141,7 @@ void Head::Joint::orientTowards(bool entering, const Math::Vector3d &point, floa
 	// This matrix is the head orientation with respect to parent-with-keyframe-animation space.
 	lookAtTM.buildFromXYZ(y, pt, r, Math::EO_ZXY);
 
-	// What follows is a hack: Since translateObject(ModelNode *node, bool reset) in this file,
+	// What follows is a hack: Since ModelComponent::translateObject(bool reset),
 	// and GfxOpenGL/GfxTinyGL::drawHierachyNode concatenate transforms incorrectly, by summing up
 	// euler angles, do a hack here where we do the proper transform here already, and *subtract off*
 	// the YPR scalars from the animYPR scalars to cancel out the values that those pieces of code
@@ -71,11 +71,6 @@ void MeshComponent::reset() {
 // 	_node->_meshVisible = true;
 }
 
-int MeshComponent::update(uint /*time*/) {
-	_node->setMatrix(_matrix);
-	return 0;
-}
-
 void MeshComponent::saveState(SaveGame *state) {
 	state->writeBool(_node->_meshVisible);
 	state->writeVector3d(_matrix.getPosition());
@@ -85,7 +80,6 @@ void MeshComponent::restoreState(SaveGame *state) {
 	_node->_meshVisible = state->readBool();
 	if (state->saveMinorVersion() >= 14) {
 		_matrix.setPosition(state->readVector3d());
-		_node->setMatrix(_matrix);
 	}
 }
 
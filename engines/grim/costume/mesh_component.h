@@ -37,7 +37,6 @@ public:
 	void init() override;
 	CMap *cmap();
 	void setKey(int val) override;
-	int update(uint time) override;
 	void reset() override;
 	void saveState(SaveGame *state) override;
 	void restoreState(SaveGame *state) override;
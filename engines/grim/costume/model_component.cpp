@@ -160,22 +160,21 @@ int ModelComponent::getNumNodes() {
 	return _obj->getNumNodes();
 }
 
-void ModelComponent::translateObject(ModelNode *node, bool reset) {
-	if (node->_parent)
-		translateObject(node->_parent, reset);
-
-	if (reset) {
-		node->translateViewpointBack();
-	} else {
-		node->translateViewpoint();
-	}
-}
-
 void ModelComponent::translateObject(bool res) {
 	ModelNode *node = _hier->_parent;
-	if (node) {
-		translateObject(node, res);
+	if (!node)
+		return;
+
+	if (res) {
+		g_driver->translateViewpointFinish();
+		return;
 	}
+
+	Math::Matrix4 matrix = node->computeLocalMatrix();
+	for (node = node->_parent; node; node = node->_parent)
+		matrix = node->computeLocalMatrix() * matrix;
+	g_driver->translateViewpointStart();
+	g_driver->transformViewpoint(matrix);
 }
 
 void ModelComponent::draw() {
@@ -188,7 +187,7 @@ void ModelComponent::draw() {
 	// with the setup of the parent
 	translateObject(false);
 
-	_hier->draw();
+	_nodeList.draw(_hier);
 
 	// Need to un-translate when done
 	translateObject(true);
@@ -204,7 +203,7 @@ void ModelComponent::getBoundingBox(int *x1, int *y1, int *x2, int *y2) {
 	// with the setup of the parent
 	translateObject(false);
 
-	_hier->getBoundingBox(x1, y1, x2, y2);
+	_nodeList.getBoundingBox(_hier, x1, y1, x2, y2);
 
 	// Need to un-translate when done
 	translateObject(true);
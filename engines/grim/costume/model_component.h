@@ -23,11 +23,11 @@
 #ifndef GRIM_MODEL_COMPONENT_H
 #define GRIM_MODEL_COMPONENT_H
 
+#include "engines/grim/model.h"
 #include "engines/grim/costume/component.h"
 
 namespace Grim {
 
-class Model;
 class AnimManager;
 
 class ModelComponent : public Component {
@@ -43,7 +43,6 @@ public:
 	void resetColormap();
 	void restoreState(SaveGame *state);
 	void translateObject(bool reset);
-	static void translateObject(ModelNode *node, bool reset);
 	AnimManager *getAnimManager() const;
 
 	ModelNode *getHierarchy() { return _hier; }
@@ -55,6 +54,7 @@ public:
 protected:
 	Model *_obj;
 	ModelNode *_hier;
+	ModelNodeList _nodeList;
 	AnimManager *_animation;
 	Component *_prevComp;
 	bool _animated;
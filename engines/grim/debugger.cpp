@@ -23,6 +23,26 @@
 #include "engines/grim/debugger.h"
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
+#include "engines/grim/soundcache.h"
+#include "engines/grim/lua/luadebug.h"
+#include "engines/grim/lua/lprofiler.h"
+#include "engines/grim/movie/movie.h"
+#include "engines/grim/movie/codecs/blocky16.h"
+
+#include "common/algorithm.h"
+#include "common/config-manager.h"
+#include "common/random.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "math/skinning.h"
 
 namespace Grim {
 
@@ -32,6 +52,12 @@ Debugger::Debugger() :
 	DCmd_Register("check_gamedata", WRAP_METHOD(Debugger, cmd_checkFiles));
 	DCmd_Register("lua_do", WRAP_METHOD(Debugger, cmd_lua_do));
 	DCmd_Register("emi_jump", WRAP_METHOD(Debugger, cmd_emi_jump));
+	DCmd_Register("lua_opstats", WRAP_METHOD(Debugger, cmd_lua_opstats));
+	DCmd_Register("lua_profile", WRAP_METHOD(Debugger, cmd_lua_profile));
+	DCmd_Register("movie_bench", WRAP_METHOD(Debugger, cmd_movie_bench));
+	DCmd_Register("mixer_bench", WRAP_METHOD(Debugger, cmd_mixer_bench));
+	DCmd_Register("sound_cache", WRAP_METHOD(Debugger, cmd_sound_cache));
+	DCmd_Register("skin_bench", WRAP_METHOD(Debugger, cmd_skin_bench));
 }
 
 Debugger::~Debugger() {
@@ -76,4 +102,365 @@ bool Debugger::cmd_emi_jump(int argc, const char **argv) {
 	return true;
 }
 
+static bool compareOpcodeCycles(int a, int b) {
+	if (luaV_opcodeStats.cycles[a] != luaV_opcodeStats.cycles[b])
+		return luaV_opcodeStats.cycles[a] > luaV_opcodeStats.cycles[b];
+	return luaV_opcodeStats.count[a] > luaV_opcodeStats.count[b];
+}
+
+bool Debugger::cmd_lua_opstats(int argc, const char **argv) {
+	if (argc < 2) {
+		DebugPrintf("Usage: lua_opstats <on|off|reset|show>\n");
+		DebugPrintf("Collection is currently %s.\n", luaV_opcodeStats.enabled ? "on" : "off");
+		return true;
+	}
+
+	Common::String arg(argv[1]);
+	if (arg == "on") {
+		luaV_opcodeStats.enabled = true;
+	} else if (arg == "off") {
+		luaV_opcodeStats.enabled = false;
+	} else if (arg == "reset") {
+		luaV_resetOpcodeStats();
+	} else if (arg == "show") {
+		int order[NUM_OPCODES];
+		uint64 totalCount = 0, totalCycles = 0;
+		for (int i = 0; i < NUM_OPCODES; ++i) {
+			order[i] = i;
+			totalCount += luaV_opcodeStats.count[i];
+			totalCycles += luaV_opcodeStats.cycles[i];
+		}
+		Common::sort(order, order + NUM_OPCODES, compareOpcodeCycles);
+
+		DebugPrintf("%-16s %12s %6s %16s %6s %10s\n", "opcode", "count", "%", "cycles", "%", "cyc/op");
+		for (int i = 0; i < NUM_OPCODES; ++i) {
+			int op = order[i];
+			uint32 count = luaV_opcodeStats.count[op];
+			uint64 cycles = luaV_opcodeStats.cycles[op];
+			if (count == 0)
+				continue;
+			DebugPrintf("%-16s %12u %6.2f %16llu %6.2f %10.1f\n", luaV_opcodeName(op), count,
+			            100.0 * count / totalCount, (unsigned long long)cycles,
+			            totalCycles ? 100.0 * cycles / totalCycles : 0.0, (double)cycles / count);
+		}
+		DebugPrintf("%llu instructions, %llu cycles\n", (unsigned long long)totalCount, (unsigned long long)totalCycles);
+	} else {
+		DebugPrintf("Unknown argument: %s\n", argv[1]);
+	}
+	return true;
+}
+
+bool Debugger::cmd_lua_profile(int argc, const char **argv) {
+	if (argc < 2) {
+		DebugPrintf("Usage: lua_profile <on|off|reset|show [entries]|folded <file>>\n");
+		DebugPrintf("The profiler is currently %s.\n", lua_profiling ? "on" : "off");
+		return true;
+	}
+
+	Common::String arg(argv[1]);
+	if (arg == "on") {
+		luaP_start();
+	} else if (arg == "off") {
+		luaP_stop();
+	} else if (arg == "reset") {
+		luaP_reset();
+	} else if (arg == "show") {
+		uint32 entries = argc > 2 ? atoi(argv[2]) : 20;
+		DebugPrintf("%s", luaP_flatprofile(entries).c_str());
+	} else if (arg == "folded" && argc > 2) {
+		Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(argv[2], false);
+		if (!out) {
+			DebugPrintf("Could not open %s for writing\n", argv[2]);
+			return true;
+		}
+		luaP_writefolded(out);
+		out->finalize();
+		delete out;
+		DebugPrintf("Folded stacks written to %s\n", argv[2]);
+	} else {
+		DebugPrintf("Unknown argument: %s\n", argv[1]);
+	}
+	return true;
+}
+
+bool Debugger::cmd_movie_bench(int argc, const char **argv) {
+	if (argc < 2) {
+		DebugPrintf("Usage: movie_bench <movie> [verify]\n");
+		DebugPrintf("Decodes the whole movie without showing it and reports the frame rate.\n");
+		DebugPrintf("With verify the movie is decoded again without the vectorised paths\n");
+		DebugPrintf("and the frames of both runs are compared.\n");
+		return true;
+	}
+
+	bool verify = argc > 2 && !strcmp(argv[2], "verify");
+	Common::Array<Common::String> checksums, reference;
+	uint32 frames, msecs;
+	if (g_movie->isPlaying()) {
+		DebugPrintf("A movie is playing, wait until it is finished.\n");
+		return true;
+	}
+	if (!g_movie->benchmark(argv[1], frames, msecs, verify ? &checksums : nullptr)) {
+		DebugPrintf("Could not load %s.\n", argv[1]);
+		return true;
+	}
+	DebugPrintf("%u frames in %u ms, %.2f fps\n", frames, msecs, msecs ? frames * 1000.0 / msecs : 0.0);
+	if (!verify)
+		return true;
+
+	Blocky16::setWideCopies(false);
+	YUVToRGBMan.setUseSIMD(false);
+	YUVAToRGBAMan.setUseSIMD(false);
+	g_movie->benchmark(argv[1], frames, msecs, &reference);
+	Blocky16::setWideCopies(true);
+	YUVToRGBMan.setUseSIMD(true);
+	YUVAToRGBAMan.setUseSIMD(true);
+	DebugPrintf("scalar: %u frames in %u ms, %.2f fps\n", frames, msecs, msecs ? frames * 1000.0 / msecs : 0.0);
+
+	if (reference.size() != checksums.size()) {
+		DebugPrintf("Frame count differs: %u, scalar %u\n", checksums.size(), reference.size());
+		return true;
+	}
+	for (uint i = 0; i < checksums.size(); i++) {
+		if (checksums[i] != reference[i]) {
+			DebugPrintf("Frame %u differs: %s, scalar %s\n", i, checksums[i].c_str(), reference[i].c_str());
+			return true;
+		}
+	}
+	DebugPrintf("All frames match\n");
+	return true;
+}
+
+/**
+ * Mix channels of synthetic noise into one buffer, the way the mixer does,
+ * and return how many milliseconds that took.
+ *
+ * @param resampled  whether all sources are at 22050 Hz, like the iMuse and
+ *                   movie audio, instead of mostly at the output rate
+ */
+static uint32 benchmarkMixing(uint outRate, int channels, int seconds, bool resampled) {
+	// Sources at the output rate, in stereo and mono, and mono at half the rate
+	const uint rates[] = { resampled ? 22050 : outRate, resampled ? 22050 : outRate, resampled ? 22050 : outRate / 2 };
+	const bool stereo[] = { true, false, false };
+
+	Common::Array<Audio::AudioStream *> streams;
+	Common::Array<Audio::RateConverter *> converters;
+	Common::RandomSource rnd("grimBenchmark");
+	// The same data on every run
+	rnd.setSeed(1);
+	for (int i = 0; i < channels; i++) {
+		const int kind = i % ARRAYSIZE(rates);
+		const uint32 size = rates[kind] * (stereo[kind] ? 4 : 2);
+		byte *noise = (byte *)malloc(size);
+		for (uint32 j = 0; j < size; j++)
+			noise[j] = rnd.getRandomNumber(255);
+		Audio::SeekableAudioStream *raw = Audio::makeRawStream(noise, size, rates[kind],
+			Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo[kind] ? Audio::FLAG_STEREO : 0));
+		streams.push_back(Audio::makeLoopingAudioStream(raw, 0));
+		converters.push_back(Audio::makeRateConverter(rates[kind], outRate, stereo[kind]));
+	}
+
+	int16 buffer[2 * 1024];
+	uint32 start = g_system->getMillis();
+	for (uint32 frames = 0; frames < outRate * seconds; frames += ARRAYSIZE(buffer) / 2) {
+		memset(buffer, 0, sizeof(buffer));
+		for (int i = 0; i < channels; i++)
+			converters[i]->flow(*streams[i], buffer, ARRAYSIZE(buffer) / 2, 200, 180);
+	}
+	uint32 msecs = g_system->getMillis() - start;
+
+	for (int i = 0; i < channels; i++) {
+		delete converters[i];
+		delete streams[i];
+	}
+	return msecs;
+}
+
+bool Debugger::cmd_mixer_bench(int argc, const char **argv) {
+	int channels = argc > 1 ? atoi(argv[1]) : 32;
+	int seconds = argc > 2 ? atoi(argv[2]) : 60;
+	if (channels <= 0 || seconds <= 0) {
+		DebugPrintf("Usage: mixer_bench [channels] [seconds]\n");
+		DebugPrintf("Mixes that many channels of synthetic audio for that long, with and\n");
+		DebugPrintf("without the vectorised kernels, and then resampled from 22050 Hz with\n");
+		DebugPrintf("and without the sinc filters. Reports how many channels one core could\n");
+		DebugPrintf("mix in real time.\n");
+		return true;
+	}
+
+	const uint outRates[] = { 44100, 48000 };
+	for (int i = 0; i < ARRAYSIZE(outRates); i++) {
+		for (int simd = 1; simd >= 0; simd--) {
+			Audio::setUseRateSIMD(simd);
+			uint32 msecs = MAX<uint32>(benchmarkMixing(outRates[i], channels, seconds, false), 1);
+			DebugPrintf("%u Hz, %s: %d channels for %d s in %u ms, %.1f channels per core\n",
+			            outRates[i], simd ? "vectorised" : "scalar", channels, seconds, msecs,
+			            channels * seconds * 1000.0 / msecs);
+		}
+	}
+	Audio::setUseRateSIMD(true);
+
+	const bool useSinc = ConfMan.getBool("sinc_resampler");
+	for (int i = 0; i < ARRAYSIZE(outRates); i++) {
+		for (int sinc = 0; sinc <= 1; sinc++) {
+			Audio::setUseSincResampler(sinc);
+			uint32 msecs = MAX<uint32>(benchmarkMixing(outRates[i], channels, seconds, true), 1);
+			DebugPrintf("22050 to %u Hz, %s: %d channels for %d s in %u ms, %.1f channels per core\n",
+			            outRates[i], sinc ? "sinc" : "linear", channels, seconds, msecs,
+			            channels * seconds * 1000.0 / msecs);
+		}
+	}
+	Audio::setUseSincResampler(useSinc);
+	return true;
+}
+
+bool Debugger::cmd_sound_cache(int argc, const char **argv) {
+	if (!g_soundCache) {
+		DebugPrintf("The sound cache is disabled, see the sound_cache_size option.\n");
+		return true;
+	}
+	if (argc < 2) {
+		DebugPrintf("Usage: sound_cache <show|reset|flush>\n");
+		return true;
+	}
+
+	Common::String arg(argv[1]);
+	if (arg == "show") {
+		SoundCache::Stats stats = g_soundCache->getStats();
+		uint32 lookups = stats.hits + stats.misses;
+		DebugPrintf("%u sounds, %u of %u KB\n", stats.numEntries,
+		            stats.memorySize / 1024, g_soundCache->getBudget() / 1024);
+		DebugPrintf("%u hits, %u misses, %.1f%% hit rate\n", stats.hits, stats.misses,
+		            lookups ? 100.0 * stats.hits / lookups : 0.0);
+	} else if (arg == "reset") {
+		g_soundCache->resetStats();
+	} else if (arg == "flush") {
+		g_soundCache->flush();
+	} else {
+		DebugPrintf("Unknown argument: %s\n", argv[1]);
+	}
+	return true;
+}
+
+static float randomFloat(Common::RandomSource &rnd, float range) {
+	return rnd.getRandomNumber(0xFFFFFF) / float(1 << 24) * range;
+}
+
+/**
+ * Skin a synthetic mesh of the size of an EMI actor for some frames and
+ * return how many milliseconds that took.
+ *
+ * @param perInfluence  whether to skin the way EMIModel used to, one
+ *                      influence at a time with the bind pose inverted
+ *                      on the fly, instead of with the kernels
+ */
+static uint32 benchmarkSkinning(int numVertices, int numJoints, int frames, bool perInfluence) {
+	const int kInfluences = Math::SkinnedMesh::kMaxInfluences;
+	Common::RandomSource rnd("grimBenchmark");
+	// The same data on every run
+	rnd.setSeed(1);
+
+	Math::Matrix4 *bind = new Math::Matrix4[numJoints];
+	Math::Matrix4 *pose = new Math::Matrix4[numJoints];
+	Math::Matrix4 *skin = new Math::Matrix4[numJoints];
+	for (int j = 0; j < numJoints; j++) {
+		bind[j].buildFromXYZ(randomFloat(rnd, 360.f), randomFloat(rnd, 360.f), randomFloat(rnd, 360.f), Math::EO_XYZ);
+		bind[j].setPosition(Math::Vector3d(randomFloat(rnd, 1.f), randomFloat(rnd, 1.f), randomFloat(rnd, 1.f)));
+		pose[j].buildFromXYZ(randomFloat(rnd, 360.f), randomFloat(rnd, 360.f), randomFloat(rnd, 360.f), Math::EO_XYZ);
+		pose[j].setPosition(Math::Vector3d(randomFloat(rnd, 1.f), randomFloat(rnd, 1.f), randomFloat(rnd, 1.f)));
+	}
+
+	// Between one and four influences per vertex, like the EMI meshes
+	Math::Vector3d *vertices = new Math::Vector3d[numVertices];
+	Math::Vector3d *normals = new Math::Vector3d[numVertices];
+	Math::Vector3d *drawVertices = new Math::Vector3d[numVertices];
+	Math::Vector3d *drawNormals = new Math::Vector3d[numVertices];
+	int *counts = new int[numVertices];
+	int *joints = new int[numVertices * kInfluences];
+	float *weights = new float[numVertices * kInfluences];
+	Math::SkinnedMesh mesh;
+	mesh.setup(numVertices);
+	for (int v = 0; v < numVertices; v++) {
+		vertices[v].set(randomFloat(rnd, 1.f), randomFloat(rnd, 1.f), randomFloat(rnd, 1.f));
+		normals[v].set(randomFloat(rnd, 1.f), randomFloat(rnd, 1.f), randomFloat(rnd, 1.f) + 0.1f);
+		counts[v] = 1 + v % kInfluences;
+		for (int k = 0; k < counts[v]; k++) {
+			joints[v * kInfluences + k] = rnd.getRandomNumber(numJoints - 1);
+			weights[v * kInfluences + k] = 1.f / counts[v];
+		}
+		mesh.setVertex(v, vertices[v], normals[v]);
+		mesh.setInfluences(v, joints + v * kInfluences, weights + v * kInfluences, counts[v]);
+	}
+
+	uint32 start = g_system->getMillis();
+	for (int f = 0; f < frames; f++) {
+		if (perInfluence) {
+			for (int v = 0; v < numVertices; v++) {
+				drawVertices[v].set(0.f, 0.f, 0.f);
+				drawNormals[v].set(0.f, 0.f, 0.f);
+				for (int k = 0; k < counts[v]; k++) {
+					const int joint = joints[v * kInfluences + k];
+					const float weight = weights[v * kInfluences + k];
+					Math::Vector3d vert = vertices[v];
+					bind[joint].inverseTranslate(&vert);
+					bind[joint].inverseRotate(&vert);
+					pose[joint].transform(&vert, true);
+					drawVertices[v] += vert * weight;
+
+					Math::Vector3d normal = normals[v];
+					bind[joint].inverseRotate(&normal);
+					pose[joint].transform(&normal, false);
+					drawNormals[v] += normal * weight;
+				}
+				drawNormals[v].normalize();
+			}
+		} else {
+			// The skinning matrices are part of the cost of every frame
+			for (int j = 0; j < numJoints; j++) {
+				Math::Matrix4 inverseBind = bind[j];
+				inverseBind.invertAffineOrthonormal();
+				skin[j] = pose[j] * inverseBind;
+			}
+			mesh.skin(skin, drawVertices, drawNormals);
+		}
+	}
+	uint32 msecs = g_system->getMillis() - start;
+
+	delete[] bind;
+	delete[] pose;
+	delete[] skin;
+	delete[] vertices;
+	delete[] normals;
+	delete[] drawVertices;
+	delete[] drawNormals;
+	delete[] counts;
+	delete[] joints;
+	delete[] weights;
+	return msecs;
+}
+
+bool Debugger::cmd_skin_bench(int argc, const char **argv) {
+	int vertices = argc > 1 ? atoi(argv[1]) : 2000;
+	int frames = argc > 2 ? atoi(argv[2]) : 1000;
+	if (vertices <= 0 || frames <= 0) {
+		DebugPrintf("Usage: skin_bench [vertices] [frames]\n");
+		DebugPrintf("Skins a synthetic mesh with 60 joints for that many frames, one\n");
+		DebugPrintf("influence at a time as EMI models used to, and with the scalar and\n");
+		DebugPrintf("the vectorised kernels.\n");
+		return true;
+	}
+
+	const int kJoints = 60;
+	const char *names[] = { "per influence", "scalar", "vectorised" };
+	for (int i = 0; i < ARRAYSIZE(names); i++) {
+		if (i == 2 && !Math::hasSkinningSIMD())
+			break;
+		Math::setUseSkinningSIMD(i == 2);
+		uint32 msecs = MAX<uint32>(benchmarkSkinning(vertices, kJoints, frames, i == 0), 1);
+		DebugPrintf("%s: %d vertices for %d frames in %u ms, %.1f million vertices per second\n",
+		            names[i], vertices, frames, msecs, (double)vertices * frames / msecs / 1000.0);
+	}
+	Math::setUseSkinningSIMD(true);
+	return true;
+}
+
 }
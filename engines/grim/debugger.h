@@ -35,6 +35,12 @@ public:
 	bool cmd_checkFiles(int argc, const char **argv);
 	bool cmd_lua_do(int argc, const char **argv);
 	bool cmd_emi_jump(int argc, const char **argv);
+	bool cmd_lua_opstats(int argc, const char **argv);
+	bool cmd_lua_profile(int argc, const char **argv);
+	bool cmd_movie_bench(int argc, const char **argv);
+	bool cmd_mixer_bench(int argc, const char **argv);
+	bool cmd_sound_cache(int argc, const char **argv);
+	bool cmd_skin_bench(int argc, const char **argv);
 };
 
 }
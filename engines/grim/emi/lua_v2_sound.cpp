@@ -399,19 +399,22 @@ void Lua_V2::PlaySound() {
 
 	SoundTrack *track;
 
-	Common::SeekableReadStream *stream = g_resourceloader->openNewStreamFile(filename, true);
-	if (!stream) {
-		Debug::debug(Debug::Sound | Debug::Scripts, "Lua_V2::PlaySound: Could not find sound '%s'", filename.c_str());
-		return;
-	}
-
 	if (g_grim->getGamePlatform() != Common::kPlatformPS2) {
 		track = new AIFFTrack(Audio::Mixer::kSFXSoundType);
 	} else {
 		track = new SCXTrack(Audio::Mixer::kSFXSoundType);
 	}
 
-	track->openSound(filename, stream);
+	// The file is only needed if the sound is not cached
+	if (!track->openCachedSound(filename)) {
+		Common::SeekableReadStream *stream = g_resourceloader->openNewStreamFile(filename, true);
+		if (!stream) {
+			Debug::debug(Debug::Sound | Debug::Scripts, "Lua_V2::PlaySound: Could not find sound '%s'", filename.c_str());
+			delete track;
+			return;
+		}
+		track->openSound(filename, stream);
+	}
 	if (g_grim->getGameFlags() != ADGF_DEMO) {
 		track->setVolume(volume);
 	}
@@ -457,19 +460,22 @@ void Lua_V2::PlaySoundFrom() {
 
 	SoundTrack *track;
 
-	Common::SeekableReadStream *stream = g_resourceloader->openNewStreamFile(filename, true);
-	if (!stream) {
-		warning("Lua_V2::PlaySoundFrom: Could not find sound '%s'", filename.c_str());
-		return;
-	}
-
 	if (g_grim->getGamePlatform() != Common::kPlatformPS2) {
 		track = new AIFFTrack(Audio::Mixer::kSFXSoundType);
 	} else {
 		track = new SCXTrack(Audio::Mixer::kSFXSoundType);
 	}
 
-	track->openSound(filename, stream);
+	// The file is only needed if the sound is not cached
+	if (!track->openCachedSound(filename)) {
+		Common::SeekableReadStream *stream = g_resourceloader->openNewStreamFile(filename, true);
+		if (!stream) {
+			warning("Lua_V2::PlaySoundFrom: Could not find sound '%s'", filename.c_str());
+			delete track;
+			return;
+		}
+		track->openSound(filename, stream);
+	}
 
 	int newvolume = volume;
 	int newbalance = 64;
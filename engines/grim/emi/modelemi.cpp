@@ -50,6 +50,13 @@ struct BoneInfo {
 	float _weight;
 };
 
+// The skinning transforms are rigid, so the vertices which a joint moves
+// stay within the same distance of the joint in every pose
+struct JointBound {
+	int _joint;
+	float _radius;
+};
+
 Common::String readLAString(Common::ReadStream *ms) {
 	int strLength = ms->readUint32LE();
 	char *readString = new char[strLength];
@@ -144,6 +151,7 @@ void EMIModel::loadMesh(Common::SeekableReadStream *data) {
 	for (int i = 0; i < _numVertices; i++) {
 		_vertices[i].readFromStream(data);
 		_drawVertices[i] = _vertices[i];
+		_bindBounds.expand(_vertices[i]);
 	}
 	_normals = new Math::Vector3d[_numVertices];
 	_drawNormals = new Math::Vector3d[_numVertices];
@@ -212,6 +220,11 @@ void EMIModel::setSkeleton(Skeleton *skel) {
 		return;
 	}
 	_skeleton = skel;
+	// The vertices were skinned with the old skeleton. They are skinned
+	// again when the model is drawn, not here.
+	_skinnedPoseVersion = 0;
+	delete[] _jointBounds; _jointBounds = nullptr;
+	_numJointBounds = 0;
 	if (!skel || !_numBoneInfos) {
 		return;
 	}
@@ -220,44 +233,87 @@ void EMIModel::setSkeleton(Skeleton *skel) {
 	for (int i = 0; i < _numBoneInfos; i++) {
 		_vertexBoneInfo[i] = _skeleton->findJointIndex(_boneNames[_boneInfos[i]._joint]);
 	}
+	setupSkinning();
 }
 
-void EMIModel::prepareForRender() {
-	if (!_skeleton || !_vertexBoneInfo)
-		return;
-
+void EMIModel::setupSkinning() {
+	_skin.setup(_numVertices);
 	for (int i = 0; i < _numVertices; i++) {
-		_drawVertices[i].set(0.0f, 0.0f, 0.0f);
-		_drawNormals[i].set(0.0f, 0.0f, 0.0f);
+		_skin.setVertex(i, _vertices[i], _normals[i]);
+	}
+
+	float *radii = new float[_skeleton->_numJoints];
+	for (int i = 0; i < _skeleton->_numJoints; i++) {
+		radii[i] = -1.0f;
 	}
 
+	// The influences of a vertex follow each other, _incFac starts the next vertex
+	bool valid = true;
+	Common::Array<int> joints;
+	Common::Array<float> weights;
 	int boneVert = -1;
-	for (int i = 0; i < _numBoneInfos; i++) {
-		if (_boneInfos[i]._incFac == 1) {
+	for (int i = 0; i <= _numBoneInfos; i++) {
+		if (i == _numBoneInfos || _boneInfos[i]._incFac == 1) {
+			if (boneVert >= 0 && boneVert < _numVertices) {
+				float total = 0.0f;
+				for (uint j = 0; j < weights.size(); j++) {
+					total += weights[j];
+				}
+				// A blend of the transformed vertices only stays inside the
+				// bounds of the joints if the weights add up to one
+				if (fabs(total - 1.0f) > 0.001f)
+					valid = false;
+				if (!joints.empty())
+					_skin.setInfluences(boneVert, &joints[0], &weights[0], joints.size());
+			}
+			if (i == _numBoneInfos)
+				break;
 			boneVert++;
+			joints.clear();
+			weights.clear();
 		}
 
 		int jointIndex = _vertexBoneInfo[i];
-		const Math::Matrix4 &jointMatrix = _skeleton->_joints[jointIndex]._finalMatrix;
-		const Math::Matrix4 &bindPose = _skeleton->_joints[jointIndex]._absMatrix;
-
-		Math::Vector3d vert = _vertices[boneVert];
-		bindPose.inverseTranslate(&vert);
-		bindPose.inverseRotate(&vert);
-		jointMatrix.transform(&vert, true);
-		_drawVertices[boneVert] += vert * _boneInfos[i]._weight;
-
-		Math::Vector3d normal = _normals[boneVert];
-		bindPose.inverseRotate(&normal);
-		jointMatrix.transform(&normal, false);
-		_drawNormals[boneVert] += normal * _boneInfos[i]._weight;
+		if (jointIndex < 0 || boneVert < 0 || boneVert >= _numVertices) {
+			valid = false;
+			continue;
+		}
+		const Math::Vector3d &jointPos = _skeleton->_joints[jointIndex]._absMatrix.getPosition();
+		radii[jointIndex] = MAX(radii[jointIndex], (_vertices[boneVert] - jointPos).getMagnitude());
+		joints.push_back(jointIndex);
+		weights.push_back(_boneInfos[i]._weight);
 	}
-
-	for (int i = 0; i < _numVertices; i++) {
-		_drawNormals[i].normalize();
+	// Vertices without any influences stay at the origin
+	if (boneVert < _numVertices - 1)
+		valid = false;
+
+	if (valid) {
+		for (int i = 0; i < _skeleton->_numJoints; i++) {
+			if (radii[i] >= 0.0f)
+				_numJointBounds++;
+		}
+		_jointBounds = new JointBound[_numJointBounds];
+		int bound = 0;
+		for (int i = 0; i < _skeleton->_numJoints; i++) {
+			if (radii[i] >= 0.0f) {
+				_jointBounds[bound]._joint = i;
+				_jointBounds[bound]._radius = radii[i];
+				bound++;
+			}
+		}
 	}
 
-	g_driver->updateEMIModel(this);
+	delete[] radii;
+}
+
+void EMIModel::prepareForRender() {
+	if (!_skeleton || !_vertexBoneInfo || _skinnedPoseVersion == _skeleton->getPoseVersion())
+		return;
+
+	_skin.skin(_skeleton->getSkinMatrices(), _drawVertices, _drawNormals);
+
+	_skinnedPoseVersion = _skeleton->getPoseVersion();
+	_uploadPending = true;
 }
 
 void EMIModel::prepareTextures() {
@@ -271,16 +327,26 @@ void EMIModel::prepareTextures() {
 	}
 }
 
-void EMIModel::draw() {
-	prepareForRender();
+bool EMIModel::isCulled(const Math::Matrix4 &modelToWorld) const {
+	if (_costume->getOwner()->isInOverworld())
+		return false;
 
+	Math::AABB bounds = calculateWorldBounds(modelToWorld);
+	return bounds.isValid() && !g_grim->getCurrSet()->getFrustum().isInside(bounds);
+}
+
+void EMIModel::draw() {
 	Actor *actor = _costume->getOwner();
 	Math::Matrix4 modelToWorld = actor->getFinalMatrix();
 
-	if (!actor->isInOverworld()) {
-		Math::AABB bounds = calculateWorldBounds(modelToWorld);
-		if (bounds.isValid() && !g_grim->getCurrSet()->getFrustum().isInside(bounds))
-			return;
+	if (isCulled(modelToWorld))
+		return;
+
+	// Does nothing if another draw skinned this pose already
+	prepareForRender();
+	if (_uploadPending) {
+		g_driver->updateEMIModel(this);
+		_uploadPending = false;
 	}
 
 	Actor::LightMode lightMode = actor->getLightMode();
@@ -403,10 +469,19 @@ void EMIModel::getBoundingBox(int *x1, int *y1, int *x2, int *y2) const {
 
 Math::AABB EMIModel::calculateWorldBounds(const Math::Matrix4 &matrix) const {
 	Math::AABB bounds;
-	for (int i = 0; i < _numVertices; i++) {
-		bounds.expand(_drawVertices[i]);
+	if (_skeleton && _vertexBoneInfo) {
+		for (int i = 0; i < _numJointBounds; i++) {
+			const JointBound &jointBound = _jointBounds[i];
+			Math::Vector3d pos = _skeleton->_joints[jointBound._joint]._finalMatrix.getPosition();
+			Math::Vector3d radius(jointBound._radius, jointBound._radius, jointBound._radius);
+			bounds.expand(pos - radius);
+			bounds.expand(pos + radius);
+		}
+	} else {
+		bounds = _bindBounds;
 	}
-	bounds.transform(matrix);
+	if (bounds.isValid())
+		bounds.transform(matrix);
 	return bounds;
 }
 
@@ -438,6 +513,10 @@ EMIModel::EMIModel(const Common::String &filename, Common::SeekableReadStream *d
 	_boneNames = nullptr;
 	_lighting = nullptr;
 	_lightingDirty = true;
+	_skinnedPoseVersion = 0;
+	_uploadPending = false;
+	_numJointBounds = 0;
+	_jointBounds = nullptr;
 
 	loadMesh(data);
 	g_driver->createEMIModel(this);
@@ -455,6 +534,7 @@ EMIModel::~EMIModel() {
 	delete[] _mats;
 	delete[] _boneInfos;
 	delete[] _vertexBoneInfo;
+	delete[] _jointBounds;
 	delete[] _boneNames;
 	delete[] _lighting;
 	delete _center;
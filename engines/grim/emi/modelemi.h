@@ -29,6 +29,7 @@
 #include "math/vector3d.h"
 #include "math/vector4d.h"
 #include "math/aabb.h"
+#include "math/skinning.h"
 
 namespace Common {
 class SeekableReadStream;
@@ -48,6 +49,7 @@ struct Vector3int;
 class EMICostume;
 class EMIModel;
 struct BoneInfo;
+struct JointBound;
 struct Bone;
 class Skeleton;
 
@@ -98,6 +100,7 @@ public:
 	BoneInfo *_boneInfos;
 	Common::String *_boneNames;
 	int *_vertexBoneInfo;
+	Math::SkinnedMesh _skin;
 
 	// Stuff we dont know how to use:
 	float _radius;
@@ -112,18 +115,41 @@ public:
 
 	void *_userData;
 	bool _lightingDirty;
+	// The pose version of the skeleton which the vertices were skinned with
+	uint32 _skinnedPoseVersion;
+	bool _uploadPending;
+
+	// See calculateWorldBounds()
+	Math::AABB _bindBounds;
+	int _numJointBounds;
+	JointBound *_jointBounds;
 
 public:
 	EMIModel(const Common::String &filename, Common::SeekableReadStream *data, EMICostume *costume);
 	~EMIModel();
 	void setTex(uint32 index);
 	void setSkeleton(Skeleton *skel);
+	void setupSkinning();
 	void loadMesh(Common::SeekableReadStream *data);
+	/**
+	 * Skin the vertices with the current pose of the skeleton, unless they
+	 * already are. This only touches the model itself, the vertices are
+	 * handed to the renderer when the model is drawn.
+	 */
 	void prepareForRender();
+	/**
+	 * Whether the model is outside of the view frustum. This does not need
+	 * the vertices to be skinned.
+	 */
+	bool isCulled(const Math::Matrix4 &modelToWorld) const;
 	void prepareTextures();
 	void draw();
 	void updateLighting(const Math::Matrix4 &modelToWorld);
 	void getBoundingBox(int *x1, int *y1, int *x2, int *y2) const;
+	/**
+	 * A box which contains the model in the current pose of the skeleton,
+	 * or an invalid one if that can't be known without skinning.
+	 */
 	Math::AABB calculateWorldBounds(const Math::Matrix4 &matrix) const;
 };
 
@@ -71,14 +71,19 @@ void PoolSound::stop() {
 }
 
 void PoolSound::openFile(const Common::String &filename) {
-	Common::SeekableReadStream *stream = g_resourceloader->openNewStreamFile(filename, true);
-	if (!stream) {
-		warning("Could not open PoolSound file %s", filename.c_str());
-		return;
+	AIFFTrack *track = new AIFFTrack(Audio::Mixer::kSFXSoundType, DisposeAfterUse::NO);
+	// The file is only needed if the sound is not cached
+	if (!track->openCachedSound(filename)) {
+		Common::SeekableReadStream *stream = g_resourceloader->openNewStreamFile(filename, true);
+		if (!stream) {
+			warning("Could not open PoolSound file %s", filename.c_str());
+			delete track;
+			return;
+		}
+		track->openSound(filename, stream);
 	}
 	_filename = filename;
-	_track = new AIFFTrack(Audio::Mixer::kSFXSoundType, DisposeAfterUse::NO);
-	_track->openSound(filename, stream);
+	_track = track;
 }
 
 void PoolSound::saveState(SaveGame *state) {
@@ -34,7 +34,7 @@ namespace Grim {
 #define TRANSLATE_OP 3
 
 Skeleton::Skeleton(const Common::String &filename, Common::SeekableReadStream *data) :
-		_numJoints(0), _joints(nullptr), _animLayers(nullptr) {
+		_numJoints(0), _joints(nullptr), _animLayers(nullptr), _poseVersion(1), _skinMatrices(nullptr) {
 	loadSkeleton(data);
 }
 
@@ -44,6 +44,7 @@ Skeleton::~Skeleton() {
 	}
 	delete[] _animLayers;
 	delete[] _joints;
+	delete[] _skinMatrices;
 }
 
 void Skeleton::loadSkeleton(Common::SeekableReadStream *data) {
@@ -67,6 +68,13 @@ void Skeleton::loadSkeleton(Common::SeekableReadStream *data) {
 	}
 	initBones();
 	resetAnim();
+
+	// Start out in the bind pose, where the skin matrices are the identity.
+	// commitAnim() keeps _skinMatrices in step with _poseMatrix.
+	_skinMatrices = new Math::Matrix4[_numJoints];
+	for (int i = 0; i < _numJoints; i++) {
+		_joints[i]._poseMatrix = _joints[i]._absMatrix;
+	}
 }
 
 void Skeleton::initBone(int index) {
@@ -82,6 +90,8 @@ void Skeleton::initBone(int index) {
 		// Might be the other way around.
 		_joints[index]._absMatrix =  _joints[index]._absMatrix * _joints[index]._relMatrix;
 	}
+	_joints[index]._invAbsMatrix = _joints[index]._absMatrix;
+	_joints[index]._invAbsMatrix.invertAffineOrthonormal();
 }
 
 void Skeleton::initBones() {
@@ -177,6 +187,19 @@ void Skeleton::commitAnim() {
 			_joints[m]._finalQuat = parent->_finalQuat * _joints[m]._finalQuat;
 		}
 	}
+
+	// Most actors stand still most of the time, their models need not be
+	// skinned again
+	bool poseChanged = false;
+	for (int m = 0; m < _numJoints; ++m) {
+		if (!(_joints[m]._finalMatrix == _joints[m]._poseMatrix)) {
+			_joints[m]._poseMatrix = _joints[m]._finalMatrix;
+			_skinMatrices[m] = _joints[m]._finalMatrix * _joints[m]._invAbsMatrix;
+			poseChanged = true;
+		}
+	}
+	if (poseChanged)
+		_poseVersion++;
 }
 
 int Skeleton::findJointIndex(const Common::String &name) const {
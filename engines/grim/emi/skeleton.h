@@ -46,9 +46,12 @@ struct Joint {
 	Math::Quaternion _quat;
 	int _parentIndex;
 	Math::Matrix4 _absMatrix;
+	Math::Matrix4 _invAbsMatrix;
 	Math::Matrix4 _relMatrix;
 	Math::Matrix4 _finalMatrix;
 	Math::Quaternion _finalQuat;
+	// The final matrix of the current pose version
+	Math::Matrix4 _poseMatrix;
 };
 
 struct JointAnimation {
@@ -90,8 +93,20 @@ public:
 	Joint *getParentJoint(const Joint *j) const;
 	int getJointIndex(const Joint *j) const;
 	AnimationLayer* getLayer(int priority) const;
+	/**
+	 * A number which changes whenever animate() moves a joint, so that
+	 * the models skinned with the skeleton know when to skin again.
+	 */
+	uint32 getPoseVersion() const { return _poseVersion; }
+	/**
+	 * For every joint the final matrix multiplied by the inverse of the
+	 * bind pose, which is what the skinning needs.
+	 */
+	const Math::Matrix4 *getSkinMatrices() const { return _skinMatrices; }
 private:
 	AnimationLayer *_animLayers;
+	uint32 _poseVersion;
+	Math::Matrix4 *_skinMatrices;
 	Common::List<AnimationStateEmi*> _activeAnims;
 };
 
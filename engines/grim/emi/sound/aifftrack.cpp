@@ -26,10 +26,31 @@
 #include "audio/decoders/aiff.h"
 #include "engines/grim/debug.h"
 #include "engines/grim/resource.h"
+#include "engines/grim/soundcache.h"
 #include "engines/grim/emi/sound/aifftrack.h"
 
 namespace Grim {
 
+static Audio::SeekableAudioStream *makeCachedAIFFStream(const Common::String &soundName, Common::SeekableReadStream *file) {
+	int size, rate;
+	byte flags;
+	int32 start = file->pos();
+	if (!Audio::loadAIFFFromStream(*file, size, rate, flags))
+		return nullptr;
+	if (!g_soundCache->isCacheable(size)) {
+		file->seek(start, SEEK_SET);
+		return Audio::makeAIFFStream(file, DisposeAfterUse::NO);
+	}
+
+	SoundCache::Entry *entry = g_soundCache->create(soundName, size, 0, rate, flags);
+	if (file->read(g_soundCache->getData(entry), size) != (uint32)size) {
+		entry->release();
+		return nullptr;
+	}
+	entry = g_soundCache->insert(entry);
+	return SoundCache::makeStream(entry);
+}
+
 AIFFTrack::AIFFTrack(Audio::Mixer::SoundType soundType, DisposeAfterUse::Flag disposeOfStream) {
 	_soundType = soundType;
 	_looping = false;
@@ -41,13 +62,27 @@ AIFFTrack::~AIFFTrack() {
 	delete _handle;
 }
 
+bool AIFFTrack::openCachedSound(const Common::String &soundName) {
+	SoundCache::Entry *entry = g_soundCache ? g_soundCache->find(soundName) : nullptr;
+	if (!entry)
+		return false;
+	_soundName = soundName;
+	// Replays share the decoded data instead of reading the file again
+	_stream = SoundCache::makeStream(entry);
+	_handle = new Audio::SoundHandle();
+	return true;
+}
+
 bool AIFFTrack::openSound(const Common::String &soundName, Common::SeekableReadStream *file) {
 	if (!file) {
 		Debug::debug(Debug::Sound, "Stream for %s not open", soundName.c_str());
 		return false;
 	}
 	_soundName = soundName;
-	_stream = Audio::makeAIFFStream(file, DisposeAfterUse::NO);
+	if (g_soundCache)
+		_stream = makeCachedAIFFStream(soundName, file);
+	else
+		_stream = Audio::makeAIFFStream(file, DisposeAfterUse::NO);
 	if (!_stream)
 		return false;
 	_handle = new Audio::SoundHandle();
@@ -39,6 +39,7 @@ public:
 	AIFFTrack(Audio::Mixer::SoundType soundType, DisposeAfterUse::Flag disposeOfStream = DisposeAfterUse::YES);
 	~AIFFTrack();
 	bool openSound(const Common::String &soundName, Common::SeekableReadStream *file) override;
+	bool openCachedSound(const Common::String &soundName) override;
 	bool isPlaying() override;
 	bool isStreamOpen() { return _stream != NULL; }
 	void setLooping(bool looping);
@@ -45,7 +45,7 @@ namespace Grim {
 
 class SoundTrack;
 
-EMISound::EMISound() {
+EMISound::EMISound() : _channelIndex(NUM_CHANNELS) {
 	_channels = new SoundTrack*[NUM_CHANNELS];
 	for (int i = 0; i < NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
@@ -70,9 +70,9 @@ int32 EMISound::getFreeChannel() {
 	return -1;
 }
 
-int32 EMISound::getChannelByName(const Common::String &name) {
-	for (int i = 0; i < NUM_CHANNELS; i++) {
-		if (_channels[i] && _channels[i]->getSoundName() == name)
+int32 EMISound::getChannelByName(const char *name) {
+	for (int i = _channelIndex.first(name); i != -1; i = _channelIndex.next(i)) {
+		if (_channels[i] && _channels[i]->getSoundName().equalsIgnoreCase(name))
 			return i;
 	}
 	return -1;
@@ -81,6 +81,7 @@ int32 EMISound::getChannelByName(const Common::String &name) {
 void EMISound::freeChannel(int32 channel) {
 	delete _channels[channel];
 	_channels[channel] = nullptr;
+	_channelIndex.remove(channel);
 }
 
 void EMISound::freeAllChannels() {
@@ -98,6 +99,7 @@ bool EMISound::startVoice(const char *soundName, int volume, int pan) {
 		_channels[channel] = new SCXTrack(Audio::Mixer::kSpeechSoundType);
 	else
 		_channels[channel] = new VimaTrack(soundName);
+	_channelIndex.insert(channel, soundName);
 
 	Common::SeekableReadStream *str = g_resourceloader->openNewStreamFile(soundName);
 
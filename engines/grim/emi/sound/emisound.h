@@ -26,6 +26,8 @@
 #include "common/str.h"
 #include "common/stack.h"
 
+#include "engines/grim/soundindex.h"
+
 namespace Grim {
 
 class SoundTrack;
@@ -46,6 +48,7 @@ struct MusicEntry {
 // changing iMuse.
 class EMISound {
 	SoundTrack **_channels;
+	SoundNameIndex _channelIndex;
 	SoundTrack *_music;
 	MusicEntry *_musicTable;
 	Common::String _musicPrefix;
@@ -53,7 +56,7 @@ class EMISound {
 
 	void removeItem(SoundTrack *item);
 	int32 getFreeChannel();
-	int32 getChannelByName(const Common::String &name);
+	int32 getChannelByName(const char *name);
 	void freeChannel(int32 channel);
 	void initMusicTable();
 public:
@@ -47,7 +47,7 @@ SoundTrack::~SoundTrack() {
 		delete _stream;
 }
 
-Common::String SoundTrack::getSoundName() {
+const Common::String &SoundTrack::getSoundName() const {
 	return _soundName;
 }
 
@@ -53,6 +53,11 @@ public:
 	SoundTrack();
 	virtual ~SoundTrack();
 	virtual bool openSound(const Common::String &voiceName, Common::SeekableReadStream *file) = 0;
+	/**
+	 * Open a sound from the sound cache, without opening its file.
+	 * Returns false if the sound is not cached, or this codec is never cached.
+	 */
+	virtual bool openCachedSound(const Common::String &voiceName) { return false; }
 	virtual bool isPlaying() = 0;
 	virtual bool play();
 	virtual void pause();
@@ -61,7 +66,7 @@ public:
 	void setVolume(int volume);
 	virtual int getVolume() { return _volume; };
 	Audio::SoundHandle *getHandle() { return _handle; }
-	Common::String getSoundName();
+	const Common::String &getSoundName() const;
 	void setSoundName(const Common::String &name);
 	virtual bool hasLooped() { return false; }
 };
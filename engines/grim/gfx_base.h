@@ -23,6 +23,8 @@
 #ifndef GRIM_GFX_BASE_H
 #define GRIM_GFX_BASE_H
 
+#include "common/rect.h"
+
 #include "math/vector3d.h"
 #include "math/quat.h"
 
@@ -141,6 +143,7 @@ public:
 	virtual void translateViewpointStart() = 0;
 	virtual void translateViewpoint(const Math::Vector3d &vec) = 0;
 	virtual void rotateViewpoint(const Math::Angle &angle, const Math::Vector3d &axis) = 0;
+	virtual void transformViewpoint(const Math::Matrix4 &matrix) = 0;
 	virtual void translateViewpointFinish() = 0;
 
 	virtual void drawEMIModelFace(const EMIModel *model, const EMIMeshFace *face) = 0;
@@ -234,13 +237,13 @@ public:
 	 * Prepare a movie-frame for drawing
 	 * performing any necessary conversion
 	 *
-	 * @param width         the width of the movie-frame.
-	 * @param height        the height of the movie-frame.
-	 * @param bitmap        a pointer to the data for the movie-frame.
+	 * @param frame         the movie-frame.
+	 * @param dirty         the part of the frame that changed since the
+	 *                      frame prepared before, the rest may be kept.
 	 * @see drawMovieFrame
 	 * @see releaseMovieFrame
 	 */
-	virtual void prepareMovieFrame(Graphics::Surface *frame) = 0;
+	virtual void prepareMovieFrame(Graphics::Surface *frame, const Common::Rect &dirty) = 0;
 	virtual void drawMovieFrame(int offsetX, int offsetY) = 0;
 
 	/**
@@ -263,6 +266,7 @@ public:
 	virtual Material *getSpecialtyTexture(int n) { return &_specialty[n]; }
 
 	virtual void createModel(Mesh *mesh) {}
+	virtual void destroyModel(Mesh *mesh) {}
 	virtual void createEMIModel(EMIModel *model) {}
 	virtual void updateEMIModel(const EMIModel *model) {}
 
@@ -96,6 +96,7 @@ static char dimFragSrc[] =
 
 GfxOpenGL::GfxOpenGL() : _smushNumTex(0),
 		_smushTexIds(nullptr), _smushWidth(0), _smushHeight(0),
+		_smushTexWidth(0), _smushTexHeight(0),
 		_useDepthShader(false), _fragmentProgram(0), _useDimShader(0),
 		_dimFragProgram(0), _maxLights(0), _storedDisplay(nullptr),
 		_emergFont(0), _alpha(1.f) {
@@ -857,6 +858,12 @@ void GfxOpenGL::rotateViewpoint(const Math::Angle &angle, const Math::Vector3d &
 	glRotatef(angle.getDegrees(), axis.x(), axis.y(), axis.z());
 }
 
+void GfxOpenGL::transformViewpoint(const Math::Matrix4 &matrix) {
+	Math::Matrix4 m = matrix;
+	m.transpose();
+	glMultMatrixf(m.getData());
+}
+
 void GfxOpenGL::translateViewpointFinish() {
 	glMatrixMode(GL_MODELVIEW);
 	glPopMatrix();
@@ -1481,30 +1488,40 @@ void GfxOpenGL::drawDepthBitmap(int x, int y, int w, int h, char *data) {
 	glDepthFunc(_depthFunc);
 }
 
-void GfxOpenGL::prepareMovieFrame(Graphics::Surface *frame) {
+void GfxOpenGL::prepareMovieFrame(Graphics::Surface *frame, const Common::Rect &dirty) {
 	int height = frame->h;
 	int width = frame->w;
 	byte *bitmap = (byte *)frame->getPixels();
 
-	// remove if already exist
-	if (_smushNumTex > 0) {
+	// Only the changed rows are uploaded into textures that are kept
+	int dirtyTop = dirty.top;
+	int dirtyBottom = dirty.bottom;
+
+	// The textures are kept as long as the frames keep the same size
+	if (_smushNumTex > 0 && (width != _smushTexWidth || height != _smushTexHeight)) {
 		glDeleteTextures(_smushNumTex, _smushTexIds);
 		delete[] _smushTexIds;
 		_smushNumTex = 0;
 	}
 
 	// create texture
-	_smushNumTex = ((width + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE) *
-				   ((height + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE);
-	_smushTexIds = new GLuint[_smushNumTex];
-	glGenTextures(_smushNumTex, _smushTexIds);
-	for (int i = 0; i < _smushNumTex; i++) {
-		glBindTexture(GL_TEXTURE_2D, _smushTexIds[i]);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, BITMAP_TEXTURE_SIZE, BITMAP_TEXTURE_SIZE, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, nullptr);
+	if (_smushNumTex == 0) {
+		_smushNumTex = ((width + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE) *
+					   ((height + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE);
+		_smushTexIds = new GLuint[_smushNumTex];
+		glGenTextures(_smushNumTex, _smushTexIds);
+		for (int i = 0; i < _smushNumTex; i++) {
+			glBindTexture(GL_TEXTURE_2D, _smushTexIds[i]);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, BITMAP_TEXTURE_SIZE, BITMAP_TEXTURE_SIZE, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, nullptr);
+		}
+		_smushTexWidth = width;
+		_smushTexHeight = height;
+		dirtyTop = 0;
+		dirtyBottom = height;
 	}
 
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
@@ -1512,11 +1529,15 @@ void GfxOpenGL::prepareMovieFrame(Graphics::Surface *frame) {
 
 	int curTexIdx = 0;
 	for (int y = 0; y < height; y += BITMAP_TEXTURE_SIZE) {
+		int t_height = (y + BITMAP_TEXTURE_SIZE >= height) ? (height - y) : BITMAP_TEXTURE_SIZE;
+		int top = MAX(y, dirtyTop);
+		int bottom = MIN(y + t_height, dirtyBottom);
 		for (int x = 0; x < width; x += BITMAP_TEXTURE_SIZE) {
 			int t_width = (x + BITMAP_TEXTURE_SIZE >= width) ? (width - x) : BITMAP_TEXTURE_SIZE;
-			int t_height = (y + BITMAP_TEXTURE_SIZE >= height) ? (height - y) : BITMAP_TEXTURE_SIZE;
-			glBindTexture(GL_TEXTURE_2D, _smushTexIds[curTexIdx]);
-			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, t_width, t_height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, bitmap + (y * 2 * width) + (2 * x));
+			if (top < bottom) {
+				glBindTexture(GL_TEXTURE_2D, _smushTexIds[curTexIdx]);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, top - y, t_width, bottom - top, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, bitmap + (top * 2 * width) + (2 * x));
+			}
 			curTexIdx++;
 		}
 	}
@@ -79,6 +79,7 @@ public:
 	void translateViewpointStart() override;
 	void translateViewpoint(const Math::Vector3d &vec) override;
 	void rotateViewpoint(const Math::Angle &angle, const Math::Vector3d &axis) override;
+	void transformViewpoint(const Math::Matrix4 &matrix) override;
 	void translateViewpointFinish() override;
 
 	void drawEMIModelFace(const EMIModel *model, const EMIMeshFace *face) override;
@@ -119,7 +120,7 @@ public:
 	void drawLine(const PrimitiveObject *primitive) override;
 	void drawPolygon(const PrimitiveObject *primitive) override;
 
-	void prepareMovieFrame(Graphics::Surface *frame) override;
+	void prepareMovieFrame(Graphics::Surface *frame, const Common::Rect &dirty) override;
 	void drawMovieFrame(int offsetX, int offsetY) override;
 	void releaseMovieFrame() override;
 
@@ -138,6 +139,8 @@ private:
 	GLuint *_smushTexIds;
 	int _smushWidth;
 	int _smushHeight;
+	int _smushTexWidth;
+	int _smushTexHeight;
 	byte *_storedDisplay;
 	bool _useDepthShader;
 	GLuint _fragmentProgram;
@@ -768,6 +768,12 @@ void GfxOpenGLS::rotateViewpoint(const Math::Angle &angle, const Math::Vector3d
 	_matrixStack.top() = temp;
 }
 
+void GfxOpenGLS::transformViewpoint(const Math::Matrix4 &matrix) {
+	Math::Matrix4 temp = matrix;
+	temp.transpose();
+	_matrixStack.top() = temp * _matrixStack.top();
+}
+
 void GfxOpenGLS::translateViewpointFinish() {
 	_matrixStack.pop();
 }
@@ -1641,7 +1647,7 @@ void GfxOpenGLS::drawPolygon(const PrimitiveObject *primitive) {
 	drawGenericPrimitive(data, 8, primitive);
 }
 
-void GfxOpenGLS::prepareMovieFrame(Graphics::Surface* frame) {
+void GfxOpenGLS::prepareMovieFrame(Graphics::Surface* frame, const Common::Rect &dirty) {
 	int width = frame->w;
 	int height = frame->h;
 	const byte *bitmap = (const byte *)frame->getPixels();
@@ -1664,20 +1670,32 @@ void GfxOpenGLS::prepareMovieFrame(Graphics::Surface* frame) {
 		return;
 	}
 
-	// create texture
+	// create texture, the storage is only respecified when the frame changes shape
+	bool respecify = false;
 	if (_smushTexId == 0) {
 		glGenTextures(1, &_smushTexId);
+		respecify = true;
 	}
 	glBindTexture(GL_TEXTURE_2D, _smushTexId);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexImage2D(GL_TEXTURE_2D, 0, frameFormat, nextHigher2(width), nextHigher2(height), 0, frameFormat, frameType, NULL);
+	// Only the changed rows are uploaded while the texture is kept
+	int top = dirty.top;
+	int bottom = dirty.bottom;
+	if (respecify || width != _smushWidth || height != _smushHeight || frame->format != _smushTexFormat) {
+		top = 0;
+		bottom = height;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, frameFormat, nextHigher2(width), nextHigher2(height), 0, frameFormat, frameType, NULL);
+		_smushTexFormat = frame->format;
+	}
 
-	glPixelStorei(GL_UNPACK_ALIGNMENT, frame->format.bytesPerPixel);
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, frameFormat, frameType, bitmap);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	if (top < bottom) {
+		glPixelStorei(GL_UNPACK_ALIGNMENT, frame->format.bytesPerPixel);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, top, width, bottom - top, frameFormat, frameType, bitmap + top * frame->pitch);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
 
 	_smushWidth = (int)(width);
 	_smushHeight = (int)(height);
@@ -82,6 +82,7 @@ public:
 	virtual void translateViewpointStart() override;
 	virtual void translateViewpoint(const Math::Vector3d &vec) override;
 	virtual void rotateViewpoint(const Math::Angle &angle, const Math::Vector3d &axis) override;
+	virtual void transformViewpoint(const Math::Matrix4 &matrix) override;
 	virtual void translateViewpointFinish() override;
 
 	virtual void drawEMIModelFace(const EMIModel* model, const EMIMeshFace* face) override;
@@ -180,7 +181,7 @@ public:
 	 * @see drawMovieFrame
 	 * @see releaseMovieFrame
 	 */
-	virtual void prepareMovieFrame(Graphics::Surface* frame) override;
+	virtual void prepareMovieFrame(Graphics::Surface* frame, const Common::Rect &dirty) override;
 	virtual void drawMovieFrame(int offsetX, int offsetY) override;
 
 	/**
@@ -232,6 +233,7 @@ private:
 	int _smushWidth;
 	int _smushHeight;
 	GLuint _smushTexId;
+	Graphics::PixelFormat _smushTexFormat;
 	bool _smushSwizzle;
 	void setupTexturedQuad();
 	void setupQuadEBO();
@@ -232,7 +232,7 @@ TGLint tgluProject(TGLfloat objx, TGLfloat objy, TGLfloat objz, const TGLfloat m
 }
 
 GfxTinyGL::GfxTinyGL() :
-		_smushWidth(0), _smushHeight(0), _zb(nullptr), _alpha(1.f),
+		_smushWidth(0), _smushHeight(0), _smushDstWidth(0), _smushDstHeight(0), _zb(nullptr), _alpha(1.f),
 		_bufferId(0), _currentActor(nullptr) {
 	g_driver = this;
 	_storedDisplay = nullptr;
@@ -826,7 +826,25 @@ void GfxTinyGL::drawEMIModelFace(const EMIModel *model, const EMIMeshFace *face)
 	tglEnable(TGL_ALPHA_TEST);
 }
 
+void GfxTinyGL::createModel(Mesh *mesh) {
+	// The vertices are transformed and lit once for all the faces sharing
+	// them, and not at all while neither the mesh nor the lights move
+	mesh->_userData = tglGenVertexCache(mesh->_numVertices, mesh->_vertices, mesh->_vertNormals);
+}
+
+void GfxTinyGL::destroyModel(Mesh *mesh) {
+	tglDeleteVertexCache((TinyGL::GLVertexCache *)mesh->_userData);
+	mesh->_userData = nullptr;
+}
+
 void GfxTinyGL::drawModelFace(const Mesh *mesh, const MeshFace *face) {
+	TinyGL::GLVertexCache *cache = (TinyGL::GLVertexCache *)mesh->_userData;
+	if (cache) {
+		tglDrawCachedPolygon(cache, face->getNumVertices(), face->getVertices(),
+							 face->hasTexture() ? mesh->_textureVerts : nullptr, face->getTextureVertices());
+		return;
+	}
+
 	float *vertices = mesh->_vertices;
 	float *vertNormals = mesh->_vertNormals;
 	float *textureVerts = mesh->_textureVerts;
@@ -974,6 +992,12 @@ void GfxTinyGL::rotateViewpoint(const Math::Angle &angle, const Math::Vector3d &
 	tglRotatef(angle.getDegrees(), axis.x(), axis.y(), axis.z());
 }
 
+void GfxTinyGL::transformViewpoint(const Math::Matrix4 &matrix) {
+	Math::Matrix4 m = matrix;
+	m.transpose();
+	tglMultMatrixf(m.getData());
+}
+
 void GfxTinyGL::translateViewpointFinish() {
 	tglPopMatrix();
 }
@@ -1401,20 +1425,94 @@ void GfxTinyGL::destroyMaterial(Texture *material) {
 	delete[] (TGLuint *)material->_texture;
 }
 
-void GfxTinyGL::prepareMovieFrame(Graphics::Surface *frame) {
-	_smushWidth = frame->w;
-	_smushHeight = frame->h;
+void GfxTinyGL::prepareMovieFrame(Graphics::Surface *frame, const Common::Rect &dirty) {
+	// The frame is converted and scaled in one pass into a bitmap of the size
+	// it has on screen, which is kept while the frames keep their size
+	int width = (int)(frame->w * _scaleW);
+	int height = (int)(frame->h * _scaleH);
+	int top = dirty.top;
+	int bottom = dirty.bottom;
+	if (!_smushBitmap.getRawBuffer() || frame->w != _smushWidth || frame->h != _smushHeight ||
+	    width != _smushDstWidth || height != _smushDstHeight) {
+		_smushBitmap.create(_pixelFormat, width * height, DisposeAfterUse::YES);
+		_smushRow.create(_pixelFormat, frame->w, DisposeAfterUse::YES);
+		_smushColumns.resize(width);
+		for (int x = 0; x < width; x++) {
+			_smushColumns[x] = x * frame->w / width;
+		}
+		_smushWidth = frame->w;
+		_smushHeight = frame->h;
+		_smushDstWidth = width;
+		_smushDstHeight = height;
+		top = 0;
+		bottom = frame->h;
+	}
+	if (top >= bottom)
+		return;
 
 	Graphics::PixelBuffer srcBuf(frame->format, (byte *)frame->getPixels());
-	_smushBitmap.create(_pixelFormat, frame->w * frame->h, DisposeAfterUse::YES);
-	_smushBitmap.copyBuffer(0, frame->w * frame->h, srcBuf);
+	if (width == frame->w && height == frame->h) {
+		_smushBitmap.copyBuffer(top * width, top * frame->w, (bottom - top) * width, srcBuf);
+		return;
+	}
+
+	// Nearest neighbour, every destination row whose source row changed
+	int bpp = _pixelFormat.bytesPerPixel;
+	int dstTop = (top * height + frame->h - 1) / frame->h;
+	int dstBottom = MIN((bottom * height + frame->h - 1) / frame->h, height);
+	int lastSrcY = -1;
+	for (int y = dstTop; y < dstBottom; y++) {
+		byte *dst = _smushBitmap.getRawBuffer(y * width);
+		int srcY = y * frame->h / height;
+		if (srcY == lastSrcY) {
+			memcpy(dst, dst - width * bpp, width * bpp);
+			continue;
+		}
+		lastSrcY = srcY;
+
+		_smushRow.copyBuffer(0, srcY * frame->w, frame->w, srcBuf);
+		if (bpp == 2) {
+			const uint16 *src = (const uint16 *)_smushRow.getRawBuffer();
+			for (int x = 0; x < width; x++) {
+				((uint16 *)dst)[x] = src[_smushColumns[x]];
+			}
+		} else if (bpp == 4) {
+			const uint32 *src = (const uint32 *)_smushRow.getRawBuffer();
+			for (int x = 0; x < width; x++) {
+				((uint32 *)dst)[x] = src[_smushColumns[x]];
+			}
+		} else {
+			for (int x = 0; x < width; x++) {
+				_smushBitmap.setPixelAt(y * width + x, _smushRow, _smushColumns[x]);
+			}
+		}
+	}
 }
 
 void GfxTinyGL::drawMovieFrame(int offsetX, int offsetY) {
-	if (_smushWidth == _gameWidth && _smushHeight == _gameHeight) {
-		_zb->pbuf.copyBuffer(0, _gameWidth * _gameHeight, _smushBitmap);
-	} else {
-		blit(_pixelFormat, nullptr, (byte *)_zb->pbuf.getRawBuffer(), _smushBitmap.getRawBuffer(), offsetX, offsetY, _smushWidth, _smushHeight, false);
+	int dstX = (int)(offsetX * _scaleW);
+	int dstY = (int)(offsetY * _scaleH);
+	if (dstX == 0 && dstY == 0 && _smushDstWidth == _screenWidth && _smushDstHeight == _screenHeight) {
+		_zb->pbuf.copyBuffer(0, _screenWidth * _screenHeight, _smushBitmap);
+		return;
+	}
+
+	int srcX = 0, srcY = 0;
+	if (dstX < 0) {
+		srcX = -dstX;
+		dstX = 0;
+	}
+	if (dstY < 0) {
+		srcY = -dstY;
+		dstY = 0;
+	}
+	int width = MIN(_smushDstWidth - srcX, _screenWidth - dstX);
+	int height = MIN(_smushDstHeight - srcY, _screenHeight - dstY);
+	// The frame is entirely off the screen
+	if (width <= 0 || height <= 0)
+		return;
+	for (int l = 0; l < height; l++) {
+		_zb->pbuf.copyBuffer((dstY + l) * _screenWidth + dstX, (srcY + l) * _smushDstWidth + srcX, width, _smushBitmap);
 	}
 }
 
@@ -76,6 +76,7 @@ public:
 	void translateViewpointStart() override;
 	void translateViewpoint(const Math::Vector3d &vec) override;
 	void rotateViewpoint(const Math::Angle &angle, const Math::Vector3d &axis) override;
+	void transformViewpoint(const Math::Matrix4 &matrix) override;
 	void translateViewpointFinish() override;
 
 	void drawEMIModelFace(const EMIModel *model, const EMIMeshFace *face) override;
@@ -117,10 +118,13 @@ public:
 	void drawLine(const PrimitiveObject *primitive) override;
 	void drawPolygon(const PrimitiveObject *primitive) override;
 
-	void prepareMovieFrame(Graphics::Surface *frame) override;
+	void prepareMovieFrame(Graphics::Surface *frame, const Common::Rect &dirty) override;
 	void drawMovieFrame(int offsetX, int offsetY) override;
 	void releaseMovieFrame() override;
 
+	void createModel(Mesh *mesh) override;
+	void destroyModel(Mesh *mesh) override;
+
 	void createSpecialtyTextures() override;
 
 	int genBuffer() override;
@@ -134,9 +138,13 @@ protected:
 
 private:
 	TinyGL::FrameBuffer *_zb;
-	Graphics::PixelBuffer _smushBitmap;
+	Graphics::PixelBuffer _smushBitmap;     // the movie frame as large as it is on screen
+	Graphics::PixelBuffer _smushRow;        // one converted row of the frame, for scaling
+	Common::Array<int> _smushColumns;       // the frame column of every column of _smushBitmap
 	int _smushWidth;
 	int _smushHeight;
+	int _smushDstWidth;
+	int _smushDstHeight;
 	Graphics::PixelBuffer _storedDisplay;
 	float _alpha;
 	Common::HashMap<int, TinyGL::Buffer *> _buffers;
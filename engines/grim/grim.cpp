@@ -34,6 +34,8 @@
 
 #include "graphics/pixelbuffer.h"
 
+#include "audio/rate.h"
+
 #include "gui/error.h"
 #include "gui/gui-manager.h"
 #include "gui/message.h"
@@ -50,6 +52,7 @@
 #include "engines/grim/emi/layer.h"
 #include "engines/grim/actor.h"
 #include "engines/grim/movie/movie.h"
+#include "engines/grim/movie/codecs/smush_decoder.h"
 #include "engines/grim/savegame.h"
 #include "engines/grim/registry.h"
 #include "engines/grim/resource.h"
@@ -61,6 +64,7 @@
 #include "engines/grim/objectstate.h"
 #include "engines/grim/set.h"
 #include "engines/grim/sound.h"
+#include "engines/grim/soundcache.h"
 #include "engines/grim/stuffit.h"
 #include "engines/grim/debugger.h"
 #include "engines/grim/cursor.h"
@@ -69,6 +73,7 @@
 #include "engines/grim/imuse/imuse.h"
 
 #include "engines/grim/lua/lua.h"
+#include "engines/grim/lua/lcache.h"
 
 namespace Grim {
 
@@ -76,6 +81,10 @@ GrimEngine *g_grim = nullptr;
 GfxBase *g_driver = nullptr;
 int g_imuseState = -1;
 
+// Bytes of a pending savegame compressed and written per frame, small enough
+// not to make the frame noticeably longer
+static const uint32 kSaveWriteStep = 16 * 1024;
+
 GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, Common::Platform platform, Common::Language language) :
 		Engine(syst), _currSet(nullptr), _selectedActor(nullptr), _pauseStartTime(0), _opMode(0), _devMode(false) {
 	g_grim = this;
@@ -102,8 +111,17 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 	ConfMan.registerDefault("fullscreen", false);
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("use_arb_shaders", true);
+	ConfMan.registerDefault("lua_chunk_cache", true);
+	ConfMan.registerDefault("sound_cache_size", SoundCache::kDefaultBudget / 1024);
+	ConfMan.registerDefault("movie_index_cache", true);
+	ConfMan.registerDefault("movie_audio_lead", 500);
+	ConfMan.registerDefault("sinc_resampler", false);
 
 	_showFps = ConfMan.getBool("show_fps");
+	lua_chunkcache = ConfMan.getBool("lua_chunk_cache");
+	SmushDecoder::setIndexCache(ConfMan.getBool("movie_index_cache"));
+	SmushDecoder::setAudioLead(ConfMan.getInt("movie_audio_lead"));
+	Audio::setUseSincResampler(ConfMan.getBool("sinc_resampler"));
 
 	_softRenderer = true;
 
@@ -135,6 +153,7 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 	ConfMan.setInt("engine_speed", 1000 / _speedLimitMs);
 	_listFilesIter = nullptr;
 	_savedState = nullptr;
+	_pendingSave = nullptr;
 	_fps[0] = 0;
 	_iris = new Iris();
 	_buildActiveActorsList = false;
@@ -173,6 +192,8 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 }
 
 GrimEngine::~GrimEngine() {
+	finishPendingSave();
+
 	delete[] _controlsEnabled;
 	delete[] _controlsState;
 
@@ -190,6 +211,8 @@ GrimEngine::~GrimEngine() {
 	g_imuse = nullptr;
 	delete g_sound;
 	g_sound = nullptr;
+	delete g_soundCache;
+	g_soundCache = nullptr;
 	delete g_localizer;
 	g_localizer = nullptr;
 	delete g_resourceloader;
@@ -289,6 +312,10 @@ Common::Error GrimEngine::run() {
 		else
 			g_movie = CreateBinkPlayer(demo);
 	}
+	// Size in KB, 0 disables caching decoded sounds
+	int soundCacheSize = ConfMan.getInt("sound_cache_size");
+	if (soundCacheSize > 0)
+		g_soundCache = new SoundCache(soundCacheSize * 1024);
 	g_imuse = new Imuse(20, demo);
 	g_sound = new SoundPlayer();
 
@@ -526,7 +553,8 @@ void GrimEngine::updateDisplayScene() {
 		if (g_movie->isPlaying()) {
 			_movieTime = g_movie->getMovieTime();
 			if (g_movie->isUpdateNeeded()) {
-				g_driver->prepareMovieFrame(g_movie->getDstSurface());
+				Graphics::Surface *frame = g_movie->getDstSurface();
+				g_driver->prepareMovieFrame(frame, g_movie->getDirtyRect());
 				g_movie->clearUpdateNeeded();
 			}
 			int frame = g_movie->getFrame();
@@ -596,7 +624,8 @@ void GrimEngine::drawNormalMode() {
 	if (g_movie->isPlaying() && _movieSetup == _currSet->getCurrSetup()->_name) {
 		_movieTime = g_movie->getMovieTime();
 		if (g_movie->isUpdateNeeded()) {
-			g_driver->prepareMovieFrame(g_movie->getDstSurface());
+			Graphics::Surface *frame = g_movie->getDstSurface();
+			g_driver->prepareMovieFrame(frame, g_movie->getDirtyRect());
 			g_movie->clearUpdateNeeded();
 		}
 		if (g_movie->getFrame() >= 0)
@@ -699,6 +728,9 @@ void GrimEngine::mainLoop() {
 		if (shouldQuit())
 			return;
 
+		if (_pendingSave && _pendingSave->writeSnapshot(kSaveWriteStep)) {
+			finishPendingSave();
+		}
 		if (_savegameLoadRequest) {
 			savegameRestore();
 		}
@@ -954,6 +986,7 @@ void GrimEngine::loadGame(const Common::String &file) {
 void GrimEngine::savegameRestore() {
 	debug("GrimEngine::savegameRestore() started.");
 	_savegameLoadRequest = false;
+	finishPendingSave();
 	Common::String filename;
 	if (_savegameFileName.size() == 0) {
 		filename = "grim.sav";
@@ -1128,7 +1161,9 @@ void GrimEngine::savegameSave() {
 	if (getGameType() == GType_MONKEY4 && filename.contains('/')) {
 		filename = Common::lastPathComponent(filename, '/');
 	}
-	_savedState = SaveGame::openForSaving(filename);
+	finishPendingSave();
+	// Only the snapshot is taken now, the main loop writes it a bit every frame
+	_savedState = SaveGame::openForSaving(filename, true);
 	if (!_savedState) {
 		//TODO: Translate this!
 		GUI::displayErrorDialog("Error: the game could not be saved.");
@@ -1191,7 +1226,8 @@ void GrimEngine::savegameSave() {
 	_hotspotManager->saveState(_savedState);
 	Debug::debug(Debug::Engine, "HotspotMan saved successfully.");
 
-	delete _savedState;
+	_pendingSave = _savedState;
+	_savedState = nullptr;
 
 	g_imuse->pause(false);
 	g_movie->pause(false);
@@ -1201,6 +1237,25 @@ void GrimEngine::savegameSave() {
 	clearEventQueue();
 }
 
+/**
+ * Write what is left of the pending savegame and close it. Called once the
+ * snapshot is written, or when the file is about to be needed.
+ */
+void GrimEngine::finishPendingSave() {
+	if (!_pendingSave)
+		return;
+
+	bool failed = !_pendingSave->finishSaving();
+	delete _pendingSave;
+	_pendingSave = nullptr;
+	debug("GrimEngine::finishPendingSave() finished.");
+
+	if (failed) {
+		//TODO: Translate this!
+		GUI::displayErrorDialog("Error: the game could not be saved.");
+	}
+}
+
 void GrimEngine::saveGRIM() {
 	_savedState->beginSection('GRIM');
 
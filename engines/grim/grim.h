@@ -110,6 +110,7 @@ public:
 	void setSpeechMode(SpeechMode mode) { _speechMode = mode; }
 	SpeechMode getSpeechMode() { return _speechMode; }
 	SaveGame *savedState() { return _savedState; }
+	void finishPendingSave();
 
 	void handleDebugLoadResource();
 	void luaUpdate();
@@ -225,6 +226,8 @@ protected:
 	bool _savegameSaveRequest;
 	Common::String _savegameFileName;
 	SaveGame *_savedState;
+	// A snapshot of the game being written to disk a bit every frame
+	SaveGame *_pendingSave;
 
 	Set *_currSet;
 	EngineMode _mode, _previousMode;
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/endian.h"
 #include "common/textconsole.h"
 #include "common/timer.h"
 
@@ -48,7 +49,7 @@ void Imuse::timerHandler(void *refCon) {
 	imuse->callback();
 }
 
-Imuse::Imuse(int fps, bool demo) {
+Imuse::Imuse(int fps, bool demo) : _trackIndex(MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS) {
 	_demo = demo;
 	_pause = false;
 	_sound = new ImuseSndMgr(_demo);
@@ -97,6 +98,7 @@ void Imuse::restoreState(SaveGame *savedState) {
 		_attributes[r] = savedState->readLESint32();
 	}
 
+	_trackIndex.clear();
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		Track *track = _track[l];
 		memset(track, 0, sizeof(Track));
@@ -142,11 +144,12 @@ void Imuse::restoreState(SaveGame *savedState) {
 		if (channels == 2)
 			track->mixerFlags |= kFlagStereo | kFlagReverseStereo;
 
-		track->stream = Audio::makeQueuingAudioStream(freq, (track->mixerFlags & kFlagStereo) != 0);
+		track->stream = makeTrackStream(freq, track->mixerFlags);
 		g_system->getMixer()->playStream(track->getType(), &track->handle, track->stream, -1, track->getVol(),
 											track->getPan(), DisposeAfterUse::YES, false,
 											(track->mixerFlags & kFlagReverseStereo) != 0);
 		g_system->getMixer()->pauseHandle(track->handle, true);
+		_trackIndex.insert(l, track->soundName);
 	}
 	savedState->endSection();
 	g_system->getMixer()->pauseAll(false);
@@ -187,17 +190,10 @@ void Imuse::saveState(SaveGame *savedState) {
 	savedState->endSection();
 }
 
-int32 Imuse::makeMixerFlags(int32 flags) {
-	int32 mixerFlags = 0;
-	if (flags & kFlagUnsigned)
-		mixerFlags |= Audio::FLAG_UNSIGNED;
-	if (flags & kFlag16Bits)
-		mixerFlags |= Audio::FLAG_16BITS;
-	if (flags & kFlagLittleEndian)
-		mixerFlags |= Audio::FLAG_LITTLE_ENDIAN;
-	if (flags & kFlagStereo)
-		mixerFlags |= Audio::FLAG_STEREO;
-	return mixerFlags;
+Audio::RingQueuingAudioStream *Imuse::makeTrackStream(int freq, int32 flags) {
+	// A second of audio, the callback queues a fraction of that at a time
+	int channels = (flags & kFlagStereo) ? 2 : 1;
+	return Audio::makeRingQueuingAudioStream(freq, channels == 2, freq * channels);
 }
 
 void Imuse::callback() {
@@ -265,7 +261,6 @@ void Imuse::callback() {
 			}
 
 			assert(track->stream);
-			byte *data = nullptr;
 			int32 result = 0;
 
 			if (track->curRegion == -1) {
@@ -274,6 +269,18 @@ void Imuse::callback() {
 					continue;
 			}
 
+			// Tracks which cannot be heard only keep their position, until they can
+			if (!isAudible(track)) {
+				if (!track->virtualVoice) {
+					g_system->getMixer()->pauseHandle(track->handle, true);
+					track->virtualVoice = true;
+				}
+				skipTrackData(track);
+				continue;
+			} else if (track->virtualVoice) {
+				resumeVirtualTrack(track);
+			}
+
 			int channels = _sound->getChannels(track->soundDesc);
 			int32 mixer_size = track->feedSize / _callbackFps;
 
@@ -281,6 +288,7 @@ void Imuse::callback() {
 				mixer_size *= 2;
 			}
 
+			mixer_size = MIN<int32>(mixer_size, track->stream->getFreeSamples() * 2);
 			if (channels == 1)
 				mixer_size &= ~1;
 			if (channels == 2)
@@ -290,7 +298,10 @@ void Imuse::callback() {
 				continue;
 
 			do {
-				result = _sound->getDataFromRegion(track->soundDesc, track->curRegion, &data, track->regionOffset, mixer_size);
+				// Read straight into the ring, up to where it wraps around
+				uint32 numSamples = mixer_size / 2;
+				int16 *data = track->stream->reserve(numSamples);
+				result = _sound->getDataFromRegion(track->soundDesc, track->curRegion, (byte *)data, track->regionOffset, numSamples * 2);
 				if (channels == 1) {
 					result &= ~1;
 				}
@@ -298,14 +309,13 @@ void Imuse::callback() {
 					result &= ~3;
 				}
 
-				if (result > mixer_size)
-					result = mixer_size;
-
 				if (g_system->getMixer()->isReady()) {
-					track->stream->queueBuffer(data, result, DisposeAfterUse::YES, makeMixerFlags(track->mixerFlags));
+					// The sound files are big endian
+					for (int32 i = 0; i < result / 2; i++)
+						data[i] = (int16)READ_BE_UINT16(data + i);
+					track->stream->commit(result / 2);
 					track->regionOffset += result;
-				} else
-					delete[] data;
+				}
 
 				if (_sound->isEndOfRegion(track->soundDesc, track->curRegion)) {
 					switchToNextRegion(track);
@@ -323,6 +333,45 @@ void Imuse::callback() {
 	}
 }
 
+bool Imuse::isAudible(Track *track) {
+	// The same volume as the mixer computes, without the balance
+	Audio::Mixer *mixer = g_system->getMixer();
+	Audio::Mixer::SoundType type = track->getType();
+	if (mixer->isSoundTypeMuted(type))
+		return false;
+	return mixer->getVolumeForSoundType(type) * track->getVol() >= Audio::Mixer::kMaxChannelVolume;
+}
+
+void Imuse::skipTrackData(Track *track) {
+	int32 size = track->feedSize / _callbackFps;
+	if (_sound->getChannels(track->soundDesc) == 2)
+		size &= ~3;
+	else
+		size &= ~1;
+
+	while (size > 0) {
+		int32 regionLength = _sound->getRegionLength(track->soundDesc, track->curRegion);
+		int32 skip = CLIP(regionLength - track->regionOffset, 0, size);
+		track->regionOffset += skip;
+		size -= skip;
+		if (track->regionOffset >= regionLength) {
+			switchToNextRegion(track);
+			if (!track->stream)
+				break;
+		}
+	}
+}
+
+void Imuse::resumeVirtualTrack(Track *track) {
+	// The paused channel still holds audio from before, start a new one
+	g_system->getMixer()->stopHandle(track->handle);
+	track->stream = makeTrackStream(_sound->getFreq(track->soundDesc), track->mixerFlags);
+	g_system->getMixer()->playStream(track->getType(), &track->handle, track->stream, -1, track->getVol(),
+										track->getPan(), DisposeAfterUse::YES, false,
+										(track->mixerFlags & kFlagReverseStereo) != 0);
+	track->virtualVoice = false;
+}
+
 void Imuse::switchToNextRegion(Track *track) {
 	assert(track);
 
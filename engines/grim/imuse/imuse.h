@@ -25,6 +25,7 @@
 
 #include "common/mutex.h"
 
+#include "engines/grim/soundindex.h"
 #include "engines/grim/imuse/imuse_track.h"
 
 namespace Grim {
@@ -41,6 +42,8 @@ private:
 	int _callbackFps;
 
 	Track *_track[MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS];
+	// Track ids by sound name, updated whenever a track gets a name
+	SoundNameIndex _trackIndex;
 
 	Common::Mutex _mutex;
 	ImuseSndMgr *_sound;
@@ -55,10 +58,13 @@ private:
 	const ImuseTable *_stateMusicTable;
 	const ImuseTable *_seqMusicTable;
 
-	int32 makeMixerFlags(int32 flags);
+	Audio::RingQueuingAudioStream *makeTrackStream(int freq, int32 flags);
 	static void timerHandler(void *refConf);
 	void callback();
 	void switchToNextRegion(Track *track);
+	bool isAudible(Track *track);
+	void skipTrackData(Track *track);
+	void resumeVirtualTrack(Track *track);
 	int allocSlot(int priority);
 	void selectVolumeGroup(const char *soundName, int volGroupId);
 
@@ -70,6 +76,7 @@ private:
 	void playMusic(const ImuseTable *table, int atribPos, bool sequence);
 
 	void flushTrack(Track *track);
+	Track *findFadeTrack(const char *soundName);
 
 public:
 	Imuse(int fps, bool demo);
@@ -51,6 +51,7 @@ public:
 
 	bool openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData);
 	int32 decompressSample(int32 offset, int32 size, byte **comp_final);
+	int32 decompressSample(int32 offset, int32 size, byte *comp_final);
 };
 
 } // end of namespace Grim
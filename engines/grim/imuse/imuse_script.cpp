@@ -44,6 +44,12 @@ void Imuse::flushTrack(Track *track) {
 		}
 	}
 
+	// The paused channel of a virtual track would never run out
+	if (track->virtualVoice) {
+		g_system->getMixer()->stopHandle(track->handle);
+		track->virtualVoice = false;
+	}
+
 	if (!g_system->getMixer()->isSoundHandleActive(track->handle)) {
 		memset(track, 0, sizeof(Track));
 	}
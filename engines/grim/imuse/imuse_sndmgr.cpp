@@ -21,6 +21,7 @@
  */
 
 #include "common/endian.h"
+#include "common/memstream.h"
 #include "common/stream.h"
 
 #include "engines/grim/resource.h"
@@ -186,12 +187,16 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGro
 	sound->volGroupId = volGroupId;
 	sound->inStream = nullptr;
 
+	if (openCachedSound(sound))
+		return sound;
+
 	sound->inStream = g_resourceloader->openNewStreamFile(soundName);
 	if (!sound->inStream) {
 		closeSound(sound);
 		return nullptr;
 	}
 
+	int32 headerStart = 0;
 	if (!_demo && scumm_stricmp(extension, "imu") == 0) {
 		parseSoundHeader(sound, headerSize);
 		sound->mcmpData = false;
@@ -203,15 +208,74 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGro
 			closeSound(sound);
 			return nullptr;
 		}
+		headerStart = sound->inStream->pos();
 		parseSoundHeader(sound, headerSize);
 		sound->mcmpData = true;
 	} else {
 		error("ImuseSndMgr::openSound() Unrecognized extension for sound file %s", soundName);
 	}
 
+	cacheSound(sound, headerStart);
 	return sound;
 }
 
+bool ImuseSndMgr::openCachedSound(SoundDesc *sound) {
+	if (!g_soundCache)
+		return false;
+
+	SoundCache::Entry *entry = g_soundCache->find(sound->name);
+	if (!entry)
+		return false;
+
+	// The header is parsed again, the data is played from the cache
+	Common::MemoryReadStream header(entry->getHeader(), entry->getHeaderSize());
+	int headerSize = 0;
+	sound->inStream = &header;
+	parseSoundHeader(sound, headerSize);
+	sound->inStream = nullptr;
+	sound->mcmpData = false;
+	sound->cached = entry;
+	return true;
+}
+
+void ImuseSndMgr::cacheSound(SoundDesc *sound, int32 headerStart) {
+	if (!g_soundCache)
+		return;
+
+	int32 dataSize = 0;
+	for (int i = 0; i < sound->numRegions; i++) {
+		dataSize = MAX(dataSize, sound->region[i].offset + sound->region[i].length);
+	}
+	if (dataSize <= 0 || !g_soundCache->isCacheable(dataSize))
+		return;
+
+	Common::SeekableReadStream *data = sound->inStream;
+	int32 headerEnd = data->pos();
+	SoundCache::Entry *entry = g_soundCache->create(sound->name, dataSize, headerEnd - headerStart, sound->freq);
+	data->seek(headerStart, SEEK_SET);
+	data->read(g_soundCache->getHeader(entry), headerEnd - headerStart);
+
+	int32 size;
+	if (sound->mcmpData) {
+		size = sound->mcmpMgr->decompressSample(0, dataSize, g_soundCache->getData(entry));
+	} else {
+		data->seek(sound->headerSize, SEEK_SET);
+		size = data->read(g_soundCache->getData(entry), dataSize);
+	}
+	if (size != dataSize) {
+		entry->release();
+		return;
+	}
+	entry = g_soundCache->insert(entry);
+
+	delete sound->mcmpMgr;
+	sound->mcmpMgr = nullptr;
+	delete sound->inStream;
+	sound->inStream = nullptr;
+	sound->mcmpData = false;
+	sound->cached = entry;
+}
+
 void ImuseSndMgr::closeSound(SoundDesc *sound) {
 	assert(checkForProperHandle(sound));
 
@@ -235,6 +299,11 @@ void ImuseSndMgr::closeSound(SoundDesc *sound) {
 		sound->inStream = nullptr;
 	}
 
+	if (sound->cached) {
+		sound->cached->release();
+		sound->cached = nullptr;
+	}
+
 	memset(sound, 0, sizeof(SoundDesc));
 }
 
@@ -338,7 +407,7 @@ int ImuseSndMgr::getJumpFade(SoundDesc *sound, int number) {
 	return sound->jump[number].fadeDelay;
 }
 
-int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size) {
+int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte *buf, int32 offset, int32 size) {
 	assert(checkForProperHandle(sound));
 	assert(buf && offset >= 0 && size >= 0);
 	assert(region >= 0 && region < sound->numRegions);
@@ -353,12 +422,13 @@ int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, i
 		sound->endFlag = false;
 	}
 
-	if (sound->mcmpData) {
+	if (sound->cached) {
+		memcpy(buf, sound->cached->getData() + region_offset + offset, size);
+	} else if (sound->mcmpData) {
 		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, buf);
 	} else {
-		*buf = (byte *)malloc(sizeof(byte) * size);
 		sound->inStream->seek(region_offset + offset + sound->headerSize, SEEK_SET);
-		sound->inStream->read(*buf, size);
+		sound->inStream->read(buf, size);
 	}
 
 	return size;
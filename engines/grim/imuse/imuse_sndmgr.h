@@ -26,6 +26,8 @@
 #include "audio/mixer.h"
 #include "audio/audiostream.h"
 
+#include "engines/grim/soundcache.h"
+
 namespace Grim {
 
 class McmpMgr;
@@ -77,6 +79,7 @@ public:
 		bool mcmpData;
 		uint32 headerSize;
 		Common::SeekableReadStream *inStream;
+		SoundCache::Entry *cached;   // decoded data, replaces inStream and mcmpMgr
 	};
 
 private:
@@ -88,6 +91,8 @@ private:
 	SoundDesc *allocSlot();
 	void parseSoundHeader(SoundDesc *sound, int &headerSize);
 	void countElements(SoundDesc *sound);
+	bool openCachedSound(SoundDesc *sound);
+	void cacheSound(SoundDesc *sound, int32 headerStart);
 
 public:
 
@@ -111,7 +116,7 @@ public:
 	int getJumpHookId(SoundDesc *sound, int number);
 	int getJumpFade(SoundDesc *sound, int number);
 
-	int32 getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size);
+	int32 getDataFromRegion(SoundDesc *sound, int region, byte *buf, int32 offset, int32 size);
 };
 
 } // end of namespace Grim
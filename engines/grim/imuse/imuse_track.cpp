@@ -42,10 +42,12 @@ int Imuse::allocSlot(int priority) {
 
 	if (trackId == -1) {
 		warning("Imuse::startSound(): All slots are full");
+		// Of the tracks with the lowest priority, one which cannot be heard goes first
 		for (l = 0; l < MAX_IMUSE_TRACKS; l++) {
 			Track *track = _track[l];
 			if (track->used && !track->toBeRemoved &&
-					(lowest_priority > track->priority)) {
+					(lowest_priority > track->priority ||
+					 (lowest_priority == track->priority && trackId != -1 && track->virtualVoice && !_track[trackId]->virtualVoice))) {
 				lowest_priority = track->priority;
 				trackId = l;
 			}
@@ -76,35 +78,35 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 	int i;
 
 	// If the track is fading out bring it back to the normal running tracks
-	for (i = MAX_IMUSE_TRACKS; i < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; i++) {
-		if (!scumm_stricmp(_track[i]->soundName, soundName) && !_track[i]->toBeRemoved) {
+	Track *fadeTrack = findFadeTrack(soundName);
+	if (fadeTrack) {
+		i = fadeTrack->trackId;
+		track = _track[i - MAX_IMUSE_TRACKS];
 
-			Track *fadeTrack = _track[i];
-			track = _track[i - MAX_IMUSE_TRACKS];
-
-			if (track->used) {
-				flushTrack(track);
-				g_system->getMixer()->stopHandle(track->handle);
-			}
-
-			// Clone the settings of the given track
-			memcpy(track, fadeTrack, sizeof(Track));
-			track->trackId = i - MAX_IMUSE_TRACKS;
-			// Reset the track
-			memset(fadeTrack, 0, sizeof(Track));
-			// Mark as used for now so the track won't be reused again this frame
-			track->used = true;
-
-			return true;
+		if (track->used) {
+			flushTrack(track);
+			g_system->getMixer()->stopHandle(track->handle);
 		}
+
+		// Clone the settings of the given track
+		memcpy(track, fadeTrack, sizeof(Track));
+		track->trackId = i - MAX_IMUSE_TRACKS;
+		_trackIndex.insert(track->trackId, track->soundName);
+		// Reset the track
+		memset(fadeTrack, 0, sizeof(Track));
+		_trackIndex.remove(i);
+		// Mark as used for now so the track won't be reused again this frame
+		track->used = true;
+
+		return true;
 	}
 
 	// If the track is already playing then there is absolutely no
 	// reason to start it again, the existing track should be modified
 	// instead of starting a new copy of the track
-	for (i = 0; i < MAX_IMUSE_TRACKS; i++) {
+	for (i = _trackIndex.first(soundName); i != -1; i = _trackIndex.next(i)) {
 		// Filenames are case insensitive, see findTrack
-		if (!scumm_stricmp(_track[i]->soundName, soundName) && !_track[i]->toBeRemoved) {
+		if (i < MAX_IMUSE_TRACKS && !scumm_stricmp(_track[i]->soundName, soundName) && !_track[i]->toBeRemoved) {
 			Debug::debug(Debug::Sound, "Imuse::startSound(): Track '%s' already playing.", soundName);
 			return true;
 		}
@@ -137,6 +139,7 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 	int bits = 0, freq = 0, channels = 0;
 
 	strcpy(track->soundName, soundName);
+	_trackIndex.insert(l, soundName);
 	track->soundDesc = _sound->openSound(soundName, volGroupId);
 
 	if (!track->soundDesc)
@@ -161,7 +164,7 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 		track->regionOffset = otherTrack->regionOffset;
 	}
 
-	track->stream = Audio::makeQueuingAudioStream(freq, track->mixerFlags & kFlagStereo);
+	track->stream = makeTrackStream(freq, track->mixerFlags);
 	g_system->getMixer()->playStream(track->getType(), &track->handle, track->stream, -1,
 											track->getVol(), track->getPan(), DisposeAfterUse::YES,
 											false, (track->mixerFlags & kFlagReverseStereo) != 0);
@@ -171,13 +174,24 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 }
 
 Track *Imuse::findTrack(const char *soundName) {
-	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
+	for (int l = _trackIndex.first(soundName); l != -1; l = _trackIndex.next(l)) {
 		Track *track = _track[l];
 
 		// Since the audio (at least for Eva's keystrokes) can be referenced
 		// two ways: keyboard.IMU and keyboard.imu, make a case insensitive
 		// search for the track to make sure we can find it
-		if (track->used && !track->toBeRemoved
+		if (l < MAX_IMUSE_TRACKS && track->used && !track->toBeRemoved
+				&& strlen(track->soundName) != 0 && scumm_stricmp(track->soundName, soundName) == 0) {
+			return track;
+		}
+	}
+	return nullptr;
+}
+
+Track *Imuse::findFadeTrack(const char *soundName) {
+	for (int l = _trackIndex.first(soundName); l != -1; l = _trackIndex.next(l)) {
+		Track *track = _track[l];
+		if (l >= MAX_IMUSE_TRACKS && !track->toBeRemoved
 				&& strlen(track->soundName) != 0 && scumm_stricmp(track->soundName, soundName) == 0) {
 			return track;
 		}
@@ -251,9 +265,9 @@ int Imuse::getCountPlayedTracks(const char *soundName) {
 	Common::StackLock lock(_mutex);
 	int count = 0;
 
-	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
+	for (int l = _trackIndex.first(soundName); l != -1; l = _trackIndex.next(l)) {
 		Track *track = _track[l];
-		if (track->used && !track->toBeRemoved && (scumm_stricmp(track->soundName, soundName) == 0)) {
+		if (l < MAX_IMUSE_TRACKS && track->used && !track->toBeRemoved && (scumm_stricmp(track->soundName, soundName) == 0)) {
 			count++;
 		}
 	}
@@ -384,6 +398,8 @@ Track *Imuse::cloneToFadeOutTrack(Track *track, int fadeDelay) {
 	// Clone the settings of the given track
 	memcpy(fadeTrack, track, sizeof(Track));
 	fadeTrack->trackId = track->trackId + MAX_IMUSE_TRACKS;
+	fadeTrack->virtualVoice = false;
+	_trackIndex.insert(fadeTrack->trackId, fadeTrack->soundName);
 
 	// Clone the sound.
 	// leaving bug number for now #1635361
@@ -398,7 +414,7 @@ Track *Imuse::cloneToFadeOutTrack(Track *track, int fadeDelay) {
 	fadeTrack->volFadeUsed = true;
 
 	// Create an appendable output buffer
-	fadeTrack->stream = Audio::makeQueuingAudioStream(_sound->getFreq(fadeTrack->soundDesc), track->mixerFlags & kFlagStereo);
+	fadeTrack->stream = makeTrackStream(_sound->getFreq(fadeTrack->soundDesc), track->mixerFlags);
 	g_system->getMixer()->playStream(track->getType(), &fadeTrack->handle, fadeTrack->stream, -1, fadeTrack->getVol(),
 											fadeTrack->getPan(), DisposeAfterUse::YES, false,
 											(track->mixerFlags & kFlagReverseStereo) != 0);
@@ -441,8 +457,10 @@ Track *Imuse::moveToFadeOutTrack(Track *track, int fadeDelay) {
 	// Clone the settings of the given track
 	memcpy(fadeTrack, track, sizeof(Track));
 	fadeTrack->trackId = track->trackId + MAX_IMUSE_TRACKS;
+	_trackIndex.insert(fadeTrack->trackId, fadeTrack->soundName);
 
 	// Reset the track
+	_trackIndex.remove(track->trackId);
 	memset(track, 0, sizeof(Track));
 
 	// Mark as used for now so the track won't be reused again this frame
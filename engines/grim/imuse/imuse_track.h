@@ -52,6 +52,7 @@ struct Track {
 	char soundName[32];
 	bool used;
 	bool toBeRemoved;
+	bool virtualVoice;	// inaudible, only the position moves on while the channel is paused
 	int32 priority;
 	int32 regionOffset;
 	int32 dataOffset;
@@ -63,7 +64,7 @@ struct Track {
 
 	ImuseSndMgr::SoundDesc *soundDesc;
 	Audio::SoundHandle handle;
-	Audio::QueuingAudioStream *stream;
+	Audio::RingQueuingAudioStream *stream;
 
 	Track() : used(false), stream(NULL) {
 		soundName[0] = 0;
@@ -116,6 +116,7 @@ void KeyframeAnim::loadBinary(Common::SeekableReadStream *data) {
 		}
 		_nodes[nodeNum] = new KeyframeNode();
 		_nodes[nodeNum]->loadBinary(data, nameHandle);
+		_nodes[nodeNum]->setupRotations(_numFrames);
 	}
 }
 
@@ -149,6 +150,7 @@ void KeyframeAnim::loadText(TextSplitter &ts) {
 		ts.scanString("node %d", 1, &which);
 		_nodes[which] = new KeyframeNode;
 		_nodes[which]->loadText(ts);
+		_nodes[which]->setupRotations(_numFrames);
 	}
 }
 
@@ -194,6 +196,69 @@ int KeyframeAnim::getMarker(float startTime, float stopTime) const {
 	return 0;
 }
 
+/**
+ * The same rotation as Math::Matrix4::buildFromXYZ(yaw, pitch, roll, Math::EO_ZXY).
+ */
+static Math::Quaternion eulerToQuaternion(const Math::Angle &yaw, const Math::Angle &pitch, const Math::Angle &roll) {
+	const Math::Angle halfYaw = yaw / 2, halfPitch = pitch / 2, halfRoll = roll / 2;
+	const Math::Quaternion aroundZ(0.f, 0.f, halfYaw.getSine(), halfYaw.getCosine());
+	const Math::Quaternion aroundX(halfPitch.getSine(), 0.f, 0.f, halfPitch.getCosine());
+	const Math::Quaternion aroundY(0.f, halfRoll.getSine(), 0.f, halfRoll.getCosine());
+	return aroundZ * aroundX * aroundY;
+}
+
+static float angleDistance(const Math::Angle &yaw, const Math::Angle &pitch, const Math::Angle &roll,
+						   const Math::Angle &toYaw, const Math::Angle &toPitch, const Math::Angle &toRoll) {
+	return fabsf((yaw - toYaw).normalize(-180).getDegrees()) +
+		   fabsf((pitch - toPitch).normalize(-180).getDegrees()) +
+		   fabsf((roll - toRoll).normalize(-180).getDegrees());
+}
+
+/**
+ * Find the pitch and the roll which together with the given yaw make up the
+ * rotation in the matrix.
+ */
+static void solvePitchRoll(const Math::Matrix4 &m, const Math::Angle &yaw, Math::Angle &pitch, Math::Angle &roll) {
+	// Undo the yaw, what is left is the pitch followed by the roll
+	const float c = yaw.getCosine(), s = yaw.getSine();
+	pitch = Math::Angle::arcTangent2(m(2, 1), c * m(1, 1) - s * m(0, 1));
+	roll = Math::Angle::arcTangent2(c * m(0, 2) + s * m(1, 2), c * m(0, 0) + s * m(1, 0));
+}
+
+/**
+ * Convert a rotation back to the angles of the model nodes. Every rotation
+ * can be written with two sets of angles, so this picks the one closer to
+ * the angles passed in and keeps the animations which are blended by
+ * adding their angles working.
+ */
+static void quaternionToEuler(const Math::Quaternion &rot, Math::Angle &yaw, Math::Angle &pitch, Math::Angle &roll) {
+	const Math::Matrix4 m = rot.toMatrix();
+
+	// Math::Matrix4::getXYZ() computes the yaw and the roll independently, from
+	// values which get as small as the cosine of the pitch. Close to a pitch
+	// of 90 degrees their errors no longer cancel out, so only the yaw is taken
+	// from there and the pitch and the roll are solved to match it. At exactly
+	// 90 degrees any yaw works, so the one passed in is kept.
+	Math::Angle y = yaw;
+	if (fabsf(m(0, 1)) + fabsf(m(1, 1)) > 1e-5f)
+		y = Math::Angle::arcTangent2(-m(0, 1), m(1, 1));
+
+	Math::Angle p, r;
+	solvePitchRoll(m, y, p, r);
+	const Math::Angle otherYaw = y + 180;
+	Math::Angle otherPitch, otherRoll;
+	solvePitchRoll(m, otherYaw, otherPitch, otherRoll);
+	if (angleDistance(otherYaw, otherPitch, otherRoll, yaw, pitch, roll) < angleDistance(y, p, r, yaw, pitch, roll)) {
+		y = otherYaw;
+		p = otherPitch;
+		r = otherRoll;
+	}
+
+	yaw += (y - yaw).normalize(-180);
+	pitch += (p - pitch).normalize(-180);
+	roll += (r - roll).normalize(-180);
+}
+
 void KeyframeAnim::KeyframeEntry::loadBinary(const char *data) {
 	_frame = get_float(data);
 	_flags = READ_LE_UINT32(data + 4);
@@ -243,6 +308,27 @@ void KeyframeAnim::KeyframeNode::loadText(TextSplitter &ts) {
 	}
 }
 
+void KeyframeAnim::KeyframeEntry::setupRotation(float endFrame) {
+	_length = endFrame - _frame;
+	_startRot = eulerToQuaternion(_yaw, _pitch, _roll);
+	_endRot = eulerToQuaternion(_yaw + _dyaw * _length, _pitch + _dpitch * _length, _roll + _droll * _length);
+
+	const float turnYaw = fabsf(_dyaw.getDegrees() * _length);
+	const float turnPitch = fabsf(_dpitch.getDegrees() * _length);
+	const float turnRoll = fabsf(_droll.getDegrees() * _length);
+	const bool spins = turnYaw > 180.f || turnPitch > 180.f || turnRoll > 180.f;
+	const int numTurning = (turnYaw > 0.f) + (turnPitch > 0.f) + (turnRoll > 0.f);
+	_slerp = _length > 0.f && !spins && numTurning > 1;
+}
+
+void KeyframeAnim::KeyframeNode::setupRotations(int numFrames) {
+	// An entry lasts until the next one, the last one until the end of the animation
+	for (int i = 0; i < _numEntries; i++) {
+		float endFrame = (i + 1 < _numEntries) ? _entries[i + 1]._frame : numFrames;
+		_entries[i].setupRotation(endFrame);
+	}
+}
+
 KeyframeAnim::KeyframeNode::~KeyframeNode() {
 	delete[] _entries;
 }
@@ -262,23 +348,26 @@ bool KeyframeAnim::KeyframeNode::animate(ModelNode &node, float frame, float fad
 			high = mid;
 	}
 
-	float dt = frame - _entries[low]._frame;
-	Math::Vector3d pos = _entries[low]._pos;
-	Math::Angle pitch = _entries[low]._pitch;
-	Math::Angle yaw = _entries[low]._yaw;
-	Math::Angle roll = _entries[low]._roll;
-
-	/** @bug Interpolating between two orientations specified by Euler angles (yaw/pitch/roll)
-	 *	by linearly interpolating the YPR values does not compute proper in-between
-	 *	poses, i.e. the rotation from start to finish does not go via the shortest arc.
-	 *	Though, if the start and end poses are very similar to each other, this can look
-	 *	acceptable without visual artifacts.
-	 */
+	const KeyframeEntry &entry = _entries[low];
+	float dt = frame - entry._frame;
+	Math::Vector3d pos = entry._pos;
+	Math::Angle pitch = entry._pitch;
+	Math::Angle yaw = entry._yaw;
+	Math::Angle roll = entry._roll;
+
 	if (useDelta) {
-		pos += dt * _entries[low]._dpos;
-		pitch += dt * _entries[low]._dpitch;
-		yaw += dt * _entries[low]._dyaw;
-		roll += dt * _entries[low]._droll;
+		pos += dt * entry._dpos;
+		pitch += dt * entry._dpitch;
+		yaw += dt * entry._dyaw;
+		roll += dt * entry._droll;
+
+		// Linearly interpolating more than one angle does not rotate along
+		// the shortest arc between the two orientations, slerping the
+		// quaternions does.
+		if (entry._slerp && dt > 0.f) {
+			Math::Quaternion rot = entry._startRot.slerpQuat(entry._endRot, MIN(dt / entry._length, 1.f));
+			quaternionToEuler(rot, yaw, pitch, roll);
+		}
 	}
 
 	node._animPos += (pos - node._pos) * fade;
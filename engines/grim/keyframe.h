@@ -23,6 +23,7 @@
 #ifndef GRIM_KEYFRAME_H
 #define GRIM_KEYFRAME_H
 
+#include "math/quat.h"
 #include "math/vector3d.h"
 
 #include "engines/grim/object.h"
@@ -71,16 +72,28 @@ private:
 
 	struct KeyframeEntry {
 		void loadBinary(const char *data);
+		/**
+		 * Convert the orientation at the start of the entry and the one the
+		 * deltas lead to at the end of it to quaternions.
+		 */
+		void setupRotation(float endFrame);
 
 		float _frame;
 		int _flags;
 		Math::Vector3d _pos, _dpos;
 		Math::Angle _pitch, _yaw, _roll, _dpitch, _dyaw, _droll;
+		Math::Quaternion _startRot, _endRot;
+		float _length;
+		// More than one angle turns, by less than half a turn. Turning a single
+		// angle already is the shortest arc, and slerp cannot follow more than
+		// half a turn.
+		bool _slerp;
 	};
 
 	struct KeyframeNode {
 		void loadBinary(Common::SeekableReadStream *data, char *meshName);
 		void loadText(TextSplitter &ts);
+		void setupRotations(int numFrames);
 		~KeyframeNode();
 
 		bool animate(ModelNode &node, float frame, float fade, bool useDelta) const;
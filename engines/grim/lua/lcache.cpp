@@ -0,0 +1,145 @@
+/*
+** Cache of compiled chunks
+** See Copyright Notice in lua.h
+*/
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
+#define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+#include "engines/grim/lua/lcache.h"
+#include "engines/grim/lua/lgc.h"
+#include "engines/grim/lua/lparser.h"
+#include "engines/grim/lua/lstate.h"
+#include "engines/grim/lua/lundump.h"
+
+#include "engines/grim/resource.h"
+
+namespace Grim {
+
+bool lua_chunkcache = false;
+
+#define MAX_MEMOISED	256
+#define MAX_SOURCEKEY	256
+#define MAX_CACHEFILES	512
+
+typedef Common::HashMap<Common::String, int32> ChunkMap;
+
+// Chunk key -> locked reference to the prototype
+static ChunkMap *memoised = nullptr;
+
+static Common::String chunkKey(ZIO *z) {
+	Common::String key(zname(z));
+	key += '\n';
+	// Short chunks are their own key, hashing them would cost more than it saves
+	if (z->n <= MAX_SOURCEKEY) {
+		key += Common::String((const char *)z->p, z->n);
+	} else {
+		Common::MemoryReadStream source(z->p, z->n);
+		key += Common::String::format("%d:", (int)z->n);
+		key += Common::computeStreamMD5AsString(source);
+	}
+	return key;
+}
+
+static Common::String cacheFileName(const Common::String &key) {
+	Common::MemoryReadStream stream((const byte *)key.c_str(), key.size());
+	return "luacache-" + Common::computeStreamMD5AsString(stream) + ".luac";
+}
+
+static TProtoFunc *loadCached(const Common::String &fileName) {
+	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(fileName);
+	if (!in)
+		return nullptr;
+	int32 size = in->size();
+	char *buffer = new char[size];
+	size = in->read(buffer, size);
+	delete in;
+
+	ZIO z;
+	luaZ_mopen(&z, buffer, size, fileName.c_str());
+	TProtoFunc *tf;
+	jmp_buf myErrorJmp;
+	jmp_buf *oldErr = lua_state->errorJmp;
+	lua_state->errorJmp = &myErrorJmp;
+	if (setjmp(myErrorJmp) == 0) {
+		tf = luaU_undump1(&z);
+	} else {
+		// Damaged or from another version, the source gets parsed again
+		tf = nullptr;
+	}
+	lua_state->errorJmp = oldErr;
+	delete[] buffer;
+	return tf;
+}
+
+static void saveCached(const Common::String &fileName, TProtoFunc *tf) {
+	// Chunks of older script versions are never looked up again
+	ResourceLoader::pruneCacheFiles("luacache-*.luac", MAX_CACHEFILES);
+	Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(fileName, false);
+	if (!out)
+		return;
+	luaU_dump(tf, out);
+	out->finalize();
+	delete out;
+}
+
+static void memoise(const Common::String &key, TProtoFunc *tf) {
+	if (memoised && memoised->size() >= MAX_MEMOISED)
+		luaK_flush();
+	if (!memoised)
+		memoised = new ChunkMap();
+
+	TObject o;
+	ttype(&o) = LUA_T_PROTO;
+	tfvalue(&o) = tf;
+	(*memoised)[key] = luaC_ref(&o, 1);
+}
+
+TProtoFunc *luaK_parser(ZIO *z, bool persistent) {
+	Common::String key = chunkKey(z);
+	if (memoised) {
+		ChunkMap::iterator i = memoised->find(key);
+		if (i != memoised->end()) {
+			TObject *o = luaC_getref(i->_value);
+			if (o && ttype(o) == LUA_T_PROTO)
+				return tfvalue(o);
+			memoised->erase(i);
+		}
+	}
+
+	TProtoFunc *tf = nullptr;
+	Common::String fileName;
+	if (persistent && lua_chunkcache) {
+		fileName = cacheFileName(key);
+		tf = loadCached(fileName);
+	}
+	if (!tf) {
+		tf = luaY_parser(z);
+		if (!fileName.empty())
+			saveCached(fileName, tf);
+	}
+	memoise(key, tf);
+	return tf;
+}
+
+/*
+** Drop the cached prototypes, so that the collector can free them and
+** they do not end up in savegames.
+*/
+void luaK_flush() {
+	if (!memoised)
+		return;
+	for (ChunkMap::iterator i = memoised->begin(); i != memoised->end(); ++i)
+		lua_unref(i->_value);
+	delete memoised;
+	memoised = nullptr;
+}
+
+} // end of namespace Grim
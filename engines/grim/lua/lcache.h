@@ -0,0 +1,28 @@
+/*
+** Cache of compiled chunks
+** See Copyright Notice in lua.h
+*/
+
+#ifndef GRIM_LCACHE_H
+#define GRIM_LCACHE_H
+
+#include "engines/grim/lua/lobject.h"
+#include "engines/grim/lua/lzio.h"
+
+namespace Grim {
+
+/*
+** Source chunks are compiled only once. The prototypes are remembered in
+** memory, keyed by the hash of the source and the chunk name, so repeated
+** lua_dostring calls skip the parser. Named chunks are also written to the
+** savefile directory in the format of luaU_undump1 when lua_chunkcache is
+** set, and loaded from there on the next run.
+*/
+extern bool lua_chunkcache;
+
+TProtoFunc *luaK_parser(ZIO *z, bool persistent);
+void luaK_flush();
+
+} // end of namespace Grim
+
+#endif
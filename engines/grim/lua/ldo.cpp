@@ -13,6 +13,7 @@
 #pragma warning(disable:4611)
 #endif
 
+#include "engines/grim/lua/lcache.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lfunc.h"
 #include "engines/grim/lua/lgc.h"
@@ -20,6 +21,7 @@
 #include "engines/grim/lua/lobject.h"
 #include "engines/grim/lua/lopcodes.h"
 #include "engines/grim/lua/lparser.h"
+#include "engines/grim/lua/lprofiler.h"
 #include "engines/grim/lua/lstate.h"
 #include "engines/grim/lua/ltask.h"
 #include "engines/grim/lua/ltm.h"
@@ -141,9 +143,15 @@ static StkId callC(lua_CFunction f, StkId base) {
 		TObject *r = lua_state->stack.stack + base - 1;
 		(*lua_callhook)(Ref(r), "(C)", -1);
 	}
+	if (lua_profiling) {
+		luaP_callC(f);
+		luaP_sample();
+	}
 	lua_state->state_counter2++;
 	(*f)();  // do the actual call
 	lua_state->state_counter2--;
+	if (lua_profiling)
+		luaP_sample();
 //	if (lua_callhook)  // func may have changed lua_callhook
 //		(*lua_callhook)(LUA_NOOBJECT, "(return)", 0);
 	firstResult = CS->base;
@@ -175,6 +183,9 @@ void luaD_callTM(TObject *f, int32 nParams, int32 nResults) {
 }
 
 int32 luaD_call(StkId base, int32 nResults) {
+	if (lua_profiling)
+		luaP_enter();
+
 	lua_Task *tmpTask = lua_state->task;
 	if (!lua_state->task || lua_state->state_counter2) {
 		lua_Task *t = luaM_new(lua_Task);
@@ -249,6 +260,8 @@ int32 luaD_call(StkId base, int32 nResults) {
 				luaM_free(t);
 
 				warning("Lua: call expression not a function");
+				if (lua_profiling)
+					luaP_leave();
 				return 1;
 // 				lua_error("call expression not a function");
 			}
@@ -284,6 +297,8 @@ int32 luaD_call(StkId base, int32 nResults) {
 			if (function == break_here || function == sleep_for) {
 				if (!lua_state->state_counter1)  {
 					lua_state->some_task = tmpTask;
+					if (lua_profiling)
+						luaP_leave();
 					return 1;
 				}
 			}
@@ -293,6 +308,8 @@ int32 luaD_call(StkId base, int32 nResults) {
 			break;
 	}
 
+	if (lua_profiling)
+		luaP_leave();
 	return 0;
 }
 
@@ -358,6 +375,7 @@ int32 luaD_protectedrun(int32 nResults) {
 	lua_state->errorJmp = &myErrorJmp;
 	lua_state->state_counter1++;
 	lua_Task *tmpTask = lua_state->task;
+	int32 profileDepth = luaP_depth();
 	if (setjmp(myErrorJmp) == 0) {
 		do_callinc(nResults);
 		status = 0;
@@ -369,6 +387,8 @@ int32 luaD_protectedrun(int32 nResults) {
 			lua_state->task = lua_state->task->next;
 			luaM_free(t);
 		}
+		if (lua_profiling)
+			luaP_unwind(profileDepth);
 		status = 1;
 	}
 	lua_state->state_counter1--;
@@ -379,14 +399,14 @@ int32 luaD_protectedrun(int32 nResults) {
 /*
 ** returns 0 = chunk loaded; 1 = error; 2 = no more chunks to load
 */
-static int32 protectedparser(ZIO *z, int32 bin) {
+static int32 protectedparser(ZIO *z, int32 bin, bool persistent) {
 	int32 status;
 	TProtoFunc *tf;
 	jmp_buf myErrorJmp;
 	jmp_buf *oldErr = lua_state->errorJmp;
 	lua_state->errorJmp = &myErrorJmp;
 	if (setjmp(myErrorJmp) == 0) {
-		tf = bin ? luaU_undump1(z) : luaY_parser(z);
+		tf = bin ? luaU_undump1(z) : luaK_parser(z, persistent);
 		status = 0;
 	} else {
 		tf = nullptr;
@@ -404,11 +424,11 @@ static int32 protectedparser(ZIO *z, int32 bin) {
 	return 0;
 }
 
-static int32 do_main(ZIO *z, int32 bin) {
+static int32 do_main(ZIO *z, int32 bin, bool persistent) {
 	int32 status;
 	do {
 		int32 old_blocks = (luaC_checkGC(), nblocks);
-		status = protectedparser(z, bin);
+		status = protectedparser(z, bin, persistent);
 		if (status == 1)
 			return 1;  // error
 		else if (status == 2)
@@ -457,13 +477,15 @@ int32 lua_dobuffer(const char *buff, int32 size, const char *name) {
 	char newname[SIZE_PREF + 25];
 	ZIO z;
 	int32 status;
+	// Only named chunks are worth keeping on disk
+	bool persistent = name != nullptr;
 
 	if (!name) {
 		build_name(buff, newname);
 		name = newname;
 	}
 	luaZ_mopen(&z, buff, size, name);
-	status = do_main(&z, buff[0] == ID_CHUNK);
+	status = do_main(&z, buff[0] == ID_CHUNK, persistent);
 	return status;
 }
 
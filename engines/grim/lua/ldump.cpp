@@ -0,0 +1,151 @@
+/*
+** save pre-compiled Lua chunks
+** See Copyright Notice in lua.h
+*/
+
+#include "common/stream.h"
+
+#include "engines/grim/lua/lopcodes.h"
+#include "engines/grim/lua/lundump.h"
+
+namespace Grim {
+
+// Size of every instruction, opcode byte included
+static int32 opcodeSizeTable[] = {
+	1, 2, 1, 2, 1, 1, 1, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1,
+	1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3,
+	1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1,
+	3, 2, 1, 1, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1,
+	1, 1, 1, 3, 1, 2, 3, 2, 4, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 1, 1,
+	3, 2, 2, 2, 2, 3, 2, 1, 1, 1, 2, 1, 2, 1, 1, 1, 3, 2, 1, 1,
+	1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+	1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3,
+	2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 3, 2, 1, 1, 1, 1, 1,
+	1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 2, 3, 2, 4, 2, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 2, 3, 2, 3,
+	2, 3, 2, 3, 2, 3, 2, 1, 1, 3, 2, 2, 2, 2, 3, 2, 1, 1
+};
+
+/*
+** size in bytes of the code of a function, up to and including ENDCODE
+*/
+int32 luaU_codesize(TProtoFunc *tf) {
+	byte *codePtr = tf->code + 2;
+	byte *tmpPtr = codePtr;
+	int32 opcodeId;
+	do {
+		opcodeId = *tmpPtr;
+		tmpPtr += opcodeSizeTable[opcodeId];
+	} while (opcodeId != ENDCODE);
+	return (tmpPtr - codePtr) + 2;
+}
+
+static void DumpWord(int32 w, Common::WriteStream *D) {
+	D->writeByte((w >> 8) & 0xff);
+	D->writeByte(w & 0xff);
+}
+
+static void DumpSize(uint32 s, Common::WriteStream *D) {
+	DumpWord(s >> 16, D);
+	DumpWord(s & 0xffff, D);
+}
+
+// The loader reads numbers back as the little endian image of a float
+static void DumpFloat(float f, Common::WriteStream *D) {
+	uint32 v;
+	memcpy(&v, &f, 4);
+	D->writeUint32LE(v);
+}
+
+static void DumpTString(TaggedString *s, Common::WriteStream *D) {
+	if (!s) {
+		DumpWord(0, D);
+		return;
+	}
+	int32 size = strlen(s->str) + 1;
+	DumpWord(size, D);
+	for (int32 i = 0; i < size; i++)
+		D->writeByte(s->str[i] ^ 0xff);
+}
+
+static void DumpConstants(TProtoFunc *tf, Common::WriteStream *D) {
+	DumpWord(tf->nconsts, D);
+	for (int32 i = 0; i < tf->nconsts; i++) {
+		TObject *o = tf->consts + i;
+		switch (ttype(o)) {
+		case LUA_T_NUMBER:
+			D->writeByte(ID_NUM);
+			DumpFloat(nvalue(o), D);
+			break;
+		case LUA_T_STRING:
+			D->writeByte(ID_STR);
+			DumpTString(tsvalue(o), D);
+			break;
+		case LUA_T_PROTO:
+			D->writeByte(ID_FUN);
+			break;
+		default:
+			// never generated by the parser
+			D->writeByte('?');
+			break;
+		}
+	}
+}
+
+static void DumpLocals(TProtoFunc *tf, Common::WriteStream *D) {
+	int32 n = 0;
+	if (tf->locvars) {
+		while (tf->locvars[n].line != -1)
+			n++;
+	}
+	DumpWord(n, D);
+	for (int32 i = 0; i < n; i++) {
+		DumpWord(tf->locvars[i].line, D);
+		DumpTString(tf->locvars[i].varname, D);
+	}
+}
+
+static void DumpFunction(TProtoFunc *tf, Common::WriteStream *D);
+
+static void DumpFunctions(TProtoFunc *tf, Common::WriteStream *D) {
+	for (int32 i = 0; i < tf->nconsts; i++) {
+		TObject *o = tf->consts + i;
+		if (ttype(o) == LUA_T_PROTO) {
+			D->writeByte(ID_FUNCTION);
+			DumpWord(i, D);
+			DumpFunction(tfvalue(o), D);
+		}
+	}
+	D->writeByte(ID_END);
+}
+
+static void DumpFunction(TProtoFunc *tf, Common::WriteStream *D) {
+	DumpWord(tf->lineDefined, D);
+	DumpTString(tf->fileName, D);
+	int32 size = luaU_codesize(tf);
+	DumpSize(size, D);
+	D->write(tf->code, size);
+	DumpConstants(tf, D);
+	DumpLocals(tf, D);
+	DumpFunctions(tf, D);
+}
+
+static void DumpHeader(Common::WriteStream *D) {
+	D->writeByte(ID_CHUNK);
+	D->write(SIGNATURE, strlen(SIGNATURE));
+	D->writeByte(VERSION);
+	D->writeByte(sizeof(float));
+	// ignored by the loader
+	DumpFloat((float)TEST_FLOAT, D);
+}
+
+/*
+** write one chunk in the format read by luaU_undump1
+*/
+void luaU_dump(TProtoFunc *tf, Common::WriteStream *D) {
+	DumpHeader(D);
+	DumpFunction(tf, D);
+}
+
+} // end of namespace Grim
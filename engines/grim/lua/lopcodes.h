@@ -171,6 +171,8 @@ typedef enum {
 	POP1			//	-		-				-				TOP-=2
 } OpCode;
 
+#define NUM_OPCODES (POP1 + 1)
+
 #define RFIELDS_PER_FLUSH 32	// records (SETMAP)
 #define LFIELDS_PER_FLUSH 64    // lists (SETLIST)
 #define ZEROVARARG	64
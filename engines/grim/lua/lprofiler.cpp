@@ -0,0 +1,294 @@
+/*
+** Script profiler
+** See Copyright Notice in lua.h
+*/
+
+// Not used here, but lstate.h includes <setjmp.h> for the error handling
+#define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
+#define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "engines/grim/lua/lprofiler.h"
+#include "engines/grim/lua/lobject.h"
+#include "engines/grim/lua/lstate.h"
+#include "engines/grim/lua/lstring.h"
+
+namespace Grim {
+
+bool lua_profiling = false;
+
+typedef size_t ProfileKey;
+
+struct ProfileKeyHash {
+	uint operator()(ProfileKey key) const {
+		return (uint)(key >> 4) ^ (uint)((uint64)key >> 36);
+	}
+};
+
+struct ProfileFunction {
+	Common::String name;
+	uint32 calls;
+	uint64 selfTicks;
+	uint64 totalTicks;
+	uint32 stamp;
+};
+
+// One node per distinct call path, used for the folded stack output
+struct ProfileNode {
+	ProfileFunction *func;
+	uint64 selfTicks;
+	Common::HashMap<ProfileKey, ProfileNode *, ProfileKeyHash> children;
+};
+
+typedef Common::HashMap<ProfileKey, ProfileFunction *, ProfileKeyHash> ProfileFunctionMap;
+
+static ProfileFunctionMap *profileFunctions = nullptr;
+static ProfileNode *profileRoot = nullptr;
+static int32 profileDepth = 0;
+static uint32 profileStamp = 0;
+static uint64 lastTicks = 0;
+static bool useCycleCounter = false;
+static uint64 startTicks = 0;
+static uint32 startMillis = 0;
+
+static uint64 readTimer() {
+	if (useCycleCounter)
+		return luaP_readcyclecounter();
+	return g_system->getMillis();
+}
+
+static bool isFunction(TObject *o) {
+	switch (ttype(o)) {
+	case LUA_T_PROTO:
+	case LUA_T_PMARK:
+	case LUA_T_CPROTO:
+	case LUA_T_CMARK:
+	case LUA_T_CLOSURE:
+	case LUA_T_CLMARK:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static TObject *functionProto(TObject *o) {
+	if (ttype(o) == LUA_T_CLOSURE || ttype(o) == LUA_T_CLMARK)
+		return protovalue(o);
+	return o;
+}
+
+static ProfileKey functionKey(TObject *o) {
+	TObject *proto = functionProto(o);
+	if (ttype(proto) == LUA_T_CPROTO || ttype(proto) == LUA_T_CMARK)
+		return (ProfileKey)fvalue(proto);
+	return (ProfileKey)tfvalue(proto);
+}
+
+static ProfileKey searchKey;
+
+static int32 matchesSearchKey(TObject *o) {
+	return isFunction(o) && functionKey(o) == searchKey;
+}
+
+static ProfileFunction *lookupFunction(TObject *o) {
+	ProfileKey key = functionKey(o);
+	ProfileFunctionMap::iterator i = profileFunctions->find(key);
+	if (i != profileFunctions->end())
+		return i->_value;
+
+	ProfileFunction *func = new ProfileFunction();
+	func->calls = 0;
+	func->selfTicks = 0;
+	func->totalTicks = 0;
+	func->stamp = 0;
+
+	// Most functions of interest are reachable through a global
+	searchKey = key;
+	const char *global = luaS_travsymbol(matchesSearchKey);
+	TObject *proto = functionProto(o);
+	if (ttype(proto) == LUA_T_CPROTO || ttype(proto) == LUA_T_CMARK) {
+		func->name = Common::String::format("%s (C)", global ? global : "?");
+	} else {
+		TProtoFunc *tf = tfvalue(proto);
+		func->name = Common::String::format("%s %s:%d", global ? global : "?", tf->fileName->str, (int)tf->lineDefined);
+	}
+	(*profileFunctions)[key] = func;
+	return func;
+}
+
+static ProfileNode *newNode(ProfileFunction *func) {
+	ProfileNode *node = new ProfileNode();
+	node->func = func;
+	node->selfTicks = 0;
+	return node;
+}
+
+static void freeNode(ProfileNode *node) {
+	for (Common::HashMap<ProfileKey, ProfileNode *, ProfileKeyHash>::iterator i = node->children.begin(); i != node->children.end(); ++i)
+		freeNode(i->_value);
+	delete node;
+}
+
+void luaP_reset() {
+	if (profileFunctions) {
+		for (ProfileFunctionMap::iterator i = profileFunctions->begin(); i != profileFunctions->end(); ++i)
+			delete i->_value;
+		delete profileFunctions;
+	}
+	if (profileRoot)
+		freeNode(profileRoot);
+
+	profileFunctions = new ProfileFunctionMap();
+	profileRoot = newNode(nullptr);
+	useCycleCounter = luaP_readcyclecounter() != 0;
+	startTicks = lastTicks = readTimer();
+	startMillis = g_system->getMillis();
+}
+
+void luaP_start() {
+	if (!profileFunctions)
+		luaP_reset();
+	profileDepth = 0;
+	lua_profiling = true;
+}
+
+void luaP_stop() {
+	lua_profiling = false;
+}
+
+/*
+** Charge the time since the previous hook to the call stack of lua_state.
+*/
+void luaP_sample() {
+	uint64 now = readTimer();
+	uint64 elapsed = now - lastTicks;
+	lastTicks = now;
+	if (profileDepth <= 0 || elapsed == 0)
+		return;
+
+	ProfileNode *node = profileRoot;
+	++profileStamp;
+	for (TObject *o = lua_state->stack.stack; o < lua_state->stack.top; ++o) {
+		lua_Type t = ttype(o);
+		if (t != LUA_T_PMARK && t != LUA_T_CLMARK && t != LUA_T_CMARK)
+			continue;
+
+		ProfileFunction *func = lookupFunction(o);
+		// Recursive functions must be charged only once
+		if (func->stamp != profileStamp) {
+			func->stamp = profileStamp;
+			func->totalTicks += elapsed;
+		}
+
+		ProfileKey key = functionKey(o);
+		ProfileNode *&child = node->children[key];
+		if (!child)
+			child = newNode(func);
+		node = child;
+	}
+
+	node->selfTicks += elapsed;
+	if (node->func)
+		node->func->selfTicks += elapsed;
+}
+
+void luaP_enter() {
+	if (profileDepth <= 0) {
+		lastTicks = readTimer();
+		profileDepth = 0;
+	} else {
+		luaP_sample();
+	}
+	profileDepth++;
+}
+
+void luaP_leave() {
+	luaP_sample();
+	if (profileDepth > 0)
+		profileDepth--;
+}
+
+int32 luaP_depth() {
+	return profileDepth;
+}
+
+void luaP_unwind(int32 depth) {
+	luaP_sample();
+	profileDepth = depth;
+}
+
+void luaP_callLua(TProtoFunc *tf) {
+	TObject o;
+	ttype(&o) = LUA_T_PROTO;
+	tfvalue(&o) = tf;
+	lookupFunction(&o)->calls++;
+}
+
+void luaP_callC(lua_CFunction f) {
+	TObject o;
+	ttype(&o) = LUA_T_CPROTO;
+	fvalue(&o) = f;
+	lookupFunction(&o)->calls++;
+}
+
+static bool compareSelfTicks(const ProfileFunction *a, const ProfileFunction *b) {
+	return a->selfTicks > b->selfTicks;
+}
+
+Common::String luaP_flatprofile(uint32 maxEntries) {
+	if (!profileFunctions)
+		return "No profile recorded.\n";
+
+	Common::Array<ProfileFunction *> funcs;
+	uint64 total = profileRoot->selfTicks;
+	for (ProfileFunctionMap::iterator i = profileFunctions->begin(); i != profileFunctions->end(); ++i) {
+		funcs.push_back(i->_value);
+		total += i->_value->selfTicks;
+	}
+	Common::sort(funcs.begin(), funcs.end(), compareSelfTicks);
+
+	// Convert cycle counts to milliseconds using the wall clock since the reset
+	double ticksPerMs = 1.0;
+	uint32 elapsedMillis = g_system->getMillis() - startMillis;
+	if (useCycleCounter && elapsedMillis > 0)
+		ticksPerMs = (double)(readTimer() - startTicks) / elapsedMillis;
+
+	Common::String out = Common::String::format("%7s %10s %10s %8s  %s\n", "self%", "self ms", "total ms", "calls", "function");
+	for (uint32 i = 0; i < funcs.size() && i < maxEntries; ++i) {
+		const ProfileFunction *func = funcs[i];
+		out += Common::String::format("%7.2f %10.2f %10.2f %8u  %s\n",
+		                              total ? 100.0 * func->selfTicks / total : 0.0,
+		                              func->selfTicks / ticksPerMs, func->totalTicks / ticksPerMs,
+		                              func->calls, func->name.c_str());
+	}
+	out += Common::String::format("%.2f ms profiled\n", total / ticksPerMs);
+	return out;
+}
+
+static void writeNode(Common::WriteStream *out, const ProfileNode *node, const Common::String &path) {
+	if (node->selfTicks > 0) {
+		out->writeString(path.empty() ? Common::String("(unknown)") : path);
+		out->writeString(Common::String::format(" %llu\n", (unsigned long long)node->selfTicks));
+	}
+	for (Common::HashMap<ProfileKey, ProfileNode *, ProfileKeyHash>::const_iterator i = node->children.begin(); i != node->children.end(); ++i) {
+		Common::String frame = i->_value->func->name;
+		// ';' separates frames in the folded format
+		for (uint j = 0; j < frame.size(); ++j) {
+			if (frame[j] == ';')
+				frame.setChar(':', j);
+		}
+		writeNode(out, i->_value, path.empty() ? frame : path + ";" + frame);
+	}
+}
+
+void luaP_writefolded(Common::WriteStream *out) {
+	if (profileRoot)
+		writeNode(out, profileRoot, Common::String());
+}
+
+} // end of namespace Grim
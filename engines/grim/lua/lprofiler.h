@@ -0,0 +1,51 @@
+/*
+** Script profiler
+** See Copyright Notice in lua.h
+*/
+
+#ifndef GRIM_LPROFILER_H
+#define GRIM_LPROFILER_H
+
+#include "engines/grim/lua/lua.h"
+
+namespace Common {
+	class WriteStream;
+}
+
+namespace Grim {
+
+/*
+** The profiler charges the time elapsed between two hooks to the Lua call
+** stack of the running script, as found by the stack marks of its functions.
+** Lua functions are identified by their prototype, C builtins by their
+** function pointer. Time spent outside of luaD_call is not counted.
+*/
+extern bool lua_profiling;
+
+void luaP_start();
+void luaP_stop();
+void luaP_reset();
+
+// Hooks. Only to be called while lua_profiling is set.
+void luaP_enter();
+void luaP_leave();
+void luaP_unwind(int32 depth);
+int32 luaP_depth();
+void luaP_sample();
+void luaP_callLua(struct TProtoFunc *tf);
+void luaP_callC(lua_CFunction f);
+
+Common::String luaP_flatprofile(uint32 maxEntries);
+void luaP_writefolded(Common::WriteStream *out);
+
+static inline uint64 luaP_readcyclecounter() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
+} // end of namespace Grim
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "engines/grim/lua/ltask.h"
 #include "engines/grim/lua/lauxlib.h"
+#include "engines/grim/lua/lcache.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/ltm.h"
@@ -16,6 +17,7 @@
 #include "engines/grim/lua/lopcodes.h"
 #include "engines/grim/lua/lstring.h"
 #include "engines/grim/lua/lua.h"
+#include "engines/grim/lua/lundump.h"
 
 namespace Grim {
 
@@ -122,25 +124,10 @@ static void saveObjectValue(TObject *object, SaveGame *savedState) {
 	}
 }
 
-static int32 opcodeSizeTable[] = {
-	1, 2, 1, 2, 1, 1, 1, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1,
-	1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3,
-	1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1,
-	3, 2, 1, 1, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1,
-	1, 1, 1, 3, 1, 2, 3, 2, 4, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-	1, 1, 1, 1, 1, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 1, 1,
-	3, 2, 2, 2, 2, 3, 2, 1, 1, 1, 2, 1, 2, 1, 1, 1, 3, 2, 1, 1,
-	1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 2,
-	1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3,
-	2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 2, 1, 1, 3, 2, 1, 1, 1, 1, 1,
-	1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 3, 1, 2, 3, 2, 4, 2, 1,
-	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 2, 3, 2, 3,
-	2, 3, 2, 3, 2, 3, 2, 1, 1, 3, 2, 2, 2, 2, 3, 2, 1, 1
-};
-
 void lua_Save(SaveGame *savedState) {
 	savedState->beginSection('LUAS');
 
+	luaK_flush();
 	lua_collectgarbage(0);
 	int32 i, l;
 	int32 countElements = 0;
@@ -288,14 +275,7 @@ void lua_Save(SaveGame *savedState) {
 			savedState->writeLESint32(tempProtoFunc->locvars[i].line);
 		}
 
-		byte *codePtr = tempProtoFunc->code + 2;
-		byte *tmpPtr = codePtr;
-		int32 opcodeId;
-		do {
-			opcodeId = *tmpPtr;
-			tmpPtr += opcodeSizeTable[opcodeId];
-		} while (opcodeId != ENDCODE);
-		int32 codeSize = (tmpPtr - codePtr) + 2;
+		int32 codeSize = luaU_codesize(tempProtoFunc);
 		savedState->writeLESint32(codeSize);
 		savedState->write(tempProtoFunc->code, codeSize);
 		tempProtoFunc = (TProtoFunc *)tempProtoFunc->head.next;
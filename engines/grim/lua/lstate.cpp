@@ -20,6 +20,7 @@
 #include "engines/grim/lua/lbuiltin.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lauxlib.h"
+#include "engines/grim/lua/lcache.h"
 #include "engines/grim/lua/lfunc.h"
 #include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/llex.h"
@@ -211,6 +212,7 @@ void lua_open() {
 }
 
 void lua_close() {
+	luaK_flush();
 	TaggedString *alludata = luaS_collectudata();
 	GCthreshold = MAX_INT;  // to avoid GC during GC
 	luaC_hashcallIM((Hash *)roottable.next);  // GC t.methods for tables
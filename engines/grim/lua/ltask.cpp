@@ -10,6 +10,7 @@
 #include "engines/grim/lua/lauxlib.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/ldo.h"
+#include "engines/grim/lua/lprofiler.h"
 #include "engines/grim/lua/lvm.h"
 #include "engines/grim/grim.h"
 
@@ -346,7 +347,10 @@ void runtasks(LState *const rootState) {
 		if (!lua_state->all_paused && !lua_state->updated && !lua_state->paused) {
 			jmp_buf	errorJmp;
 			lua_state->errorJmp = &errorJmp;
+			int32 profileDepth = luaP_depth();
 			if (setjmp(errorJmp)) {
+				if (lua_profiling)
+					luaP_unwind(profileDepth);
 				lua_Task *t, *m;
 				for (t = lua_state->task; t != nullptr;) {
 					m = t->next;
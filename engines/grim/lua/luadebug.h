@@ -9,6 +9,7 @@
 
 
 #include "engines/grim/lua/lua.h"
+#include "engines/grim/lua/lopcodes.h"
 
 namespace Grim {
 
@@ -29,6 +30,22 @@ extern lua_LHFunction lua_linehook;
 extern lua_CHFunction lua_callhook;
 extern int32 lua_debug;
 
+/*
+** Per-opcode execution counts and cycle totals, collected by luaV_execute
+** while "enabled" is set. Cycles are read from the CPU time stamp counter
+** where available and stay zero elsewhere.
+*/
+struct OpcodeStats {
+	bool enabled;
+	uint32 count[NUM_OPCODES];
+	uint64 cycles[NUM_OPCODES];
+};
+
+extern OpcodeStats luaV_opcodeStats;
+
+void luaV_resetOpcodeStats();
+const char *luaV_opcodeName(int32 op);
+
 } // end of namespace Grim
 
 
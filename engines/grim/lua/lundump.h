@@ -9,6 +9,10 @@
 #include "engines/grim/lua/lobject.h"
 #include "engines/grim/lua/lzio.h"
 
+namespace Common {
+	class WriteStream;
+}
+
 namespace Grim {
 
 #define ID_CHUNK		27              // ESC
@@ -24,6 +28,8 @@ namespace Grim {
 #define IsMain(f)			(f->lineDefined == 0)
 
 TProtoFunc* luaU_undump1(ZIO* Z);      // load one chunk
+void luaU_dump(TProtoFunc *tf, Common::WriteStream *D);  // save one chunk
+int32 luaU_codesize(TProtoFunc *tf);
 
 } // end of namespace Grim
 
@@ -6,12 +6,15 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
 #define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
 
+#include "common/util.h"
+
 #include "engines/grim/lua/lauxlib.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lfunc.h"
 #include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/lopcodes.h"
+#include "engines/grim/lua/lprofiler.h"
 #include "engines/grim/lua/lstate.h"
 #include "engines/grim/lua/lstring.h"
 #include "engines/grim/lua/ltable.h"
@@ -241,7 +244,127 @@ static void adjust_varargs(StkId first_extra_arg) {
 	*lua_state->stack.top++ = arg;
 }
 
+/*
+** Interpreter dispatch.
+** Compilers with "labels as values" (GCC, Clang) get a threaded dispatch where
+** every handler jumps directly to the next one; everything else uses the
+** plain switch. Define LUA_SWITCH_DISPATCH to force the switch build.
+*/
+#if defined(__GNUC__) && !defined(LUA_SWITCH_DISPATCH)
+#define LUA_THREADED_DISPATCH
+#endif
+
+// Computed gotos are a GNU extension, keep -pedantic quiet around them only
+#if defined(LUA_THREADED_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+#define LUA_GNU_EXTENSION_BEGIN \
+	_Pragma("GCC diagnostic push") \
+	_Pragma("GCC diagnostic ignored \"-Wpedantic\"")
+#define LUA_GNU_EXTENSION_END \
+	_Pragma("GCC diagnostic pop")
+#else
+#define LUA_GNU_EXTENSION_BEGIN
+#define LUA_GNU_EXTENSION_END
+#endif
+
+// Order must match the OpCode enum in lopcodes.h
+#define LUA_OPCODE_LIST(X) \
+	X(ENDCODE) \
+	X(PUSHNIL) X(PUSHNIL0) \
+	X(PUSHNUMBER) X(PUSHNUMBER0) X(PUSHNUMBER1) X(PUSHNUMBER2) X(PUSHNUMBERW) \
+	X(PUSHCONSTANT) X(PUSHCONSTANT0) X(PUSHCONSTANT1) X(PUSHCONSTANT2) X(PUSHCONSTANT3) \
+	X(PUSHCONSTANT4) X(PUSHCONSTANT5) X(PUSHCONSTANT6) X(PUSHCONSTANT7) X(PUSHCONSTANTW) \
+	X(PUSHUPVALUE) X(PUSHUPVALUE0) X(PUSHUPVALUE1) \
+	X(PUSHLOCAL) X(PUSHLOCAL0) X(PUSHLOCAL1) X(PUSHLOCAL2) X(PUSHLOCAL3) \
+	X(PUSHLOCAL4) X(PUSHLOCAL5) X(PUSHLOCAL6) X(PUSHLOCAL7) \
+	X(GETGLOBAL) X(GETGLOBAL0) X(GETGLOBAL1) X(GETGLOBAL2) X(GETGLOBAL3) \
+	X(GETGLOBAL4) X(GETGLOBAL5) X(GETGLOBAL6) X(GETGLOBAL7) X(GETGLOBALW) \
+	X(GETTABLE) \
+	X(GETDOTTED) X(GETDOTTED0) X(GETDOTTED1) X(GETDOTTED2) X(GETDOTTED3) \
+	X(GETDOTTED4) X(GETDOTTED5) X(GETDOTTED6) X(GETDOTTED7) X(GETDOTTEDW) \
+	X(PUSHSELF) X(PUSHSELF0) X(PUSHSELF1) X(PUSHSELF2) X(PUSHSELF3) \
+	X(PUSHSELF4) X(PUSHSELF5) X(PUSHSELF6) X(PUSHSELF7) X(PUSHSELFW) \
+	X(CREATEARRAY) X(CREATEARRAY0) X(CREATEARRAY1) X(CREATEARRAYW) \
+	X(SETLOCAL) X(SETLOCAL0) X(SETLOCAL1) X(SETLOCAL2) X(SETLOCAL3) \
+	X(SETLOCAL4) X(SETLOCAL5) X(SETLOCAL6) X(SETLOCAL7) \
+	X(SETGLOBAL) X(SETGLOBAL0) X(SETGLOBAL1) X(SETGLOBAL2) X(SETGLOBAL3) \
+	X(SETGLOBAL4) X(SETGLOBAL5) X(SETGLOBAL6) X(SETGLOBAL7) X(SETGLOBALW) \
+	X(SETTABLE0) X(SETTABLE) \
+	X(SETLIST) X(SETLIST0) X(SETLISTW) \
+	X(SETMAP) X(SETMAP0) \
+	X(EQOP) X(NEQOP) X(LTOP) X(LEOP) X(GTOP) X(GEOP) \
+	X(ADDOP) X(SUBOP) X(MULTOP) X(DIVOP) X(POWOP) X(CONCOP) X(MINUSOP) X(NOTOP) \
+	X(ONTJMP) X(ONTJMPW) X(ONFJMP) X(ONFJMPW) X(JMP) X(JMPW) \
+	X(IFFJMP) X(IFFJMPW) X(IFTUPJMP) X(IFTUPJMPW) X(IFFUPJMP) X(IFFUPJMPW) \
+	X(CLOSURE) X(CLOSURE0) X(CLOSURE1) \
+	X(CALLFUNC) X(CALLFUNC0) X(CALLFUNC1) \
+	X(RETCODE) \
+	X(SETLINE) X(SETLINEW) \
+	X(POP) X(POP0) X(POP1)
+
+#define LUA_OPCODE_NAME(op) #op,
+static const char *const opcodeNames[] = { LUA_OPCODE_LIST(LUA_OPCODE_NAME) };
+#undef LUA_OPCODE_NAME
+
+// Fails to compile if LUA_OPCODE_LIST and the OpCode enum went out of sync
+typedef char opcodeListCheck[(ARRAYSIZE(opcodeNames) == NUM_OPCODES) ? 1 : -1];
+
+OpcodeStats luaV_opcodeStats;
+
+const char *luaV_opcodeName(int32 op) {
+	if (op < 0 || op >= NUM_OPCODES)
+		return "???";
+	return opcodeNames[op];
+}
+
+void luaV_resetOpcodeStats() {
+	memset(luaV_opcodeStats.count, 0, sizeof(luaV_opcodeStats.count));
+	memset(luaV_opcodeStats.cycles, 0, sizeof(luaV_opcodeStats.cycles));
+}
+
+/*
+** The hot interpreter registers (pc, stack top, base) live in locals while
+** luaV_execute runs. They must be written back to the task before anything
+** which can look at the Lua stack (helpers, tag methods, the GC, hooks) and
+** whenever control leaves the loop, and top reloaded afterwards since the
+** stack may have been reallocated or changed by the callee.
+*/
+#define savestate()	(task->pc = pc, task->aux = aux, task->base = base, S->top = top)
+#define loadtop()	(top = S->top)
+#define stackbase()	(S->stack + base)
+
+#define vmstats() \
+	if (stats) { \
+		uint64 now = luaP_readcyclecounter(); \
+		if (lastOp >= 0) \
+			luaV_opcodeStats.cycles[lastOp] += now - lastCycles; \
+		if (aux < NUM_OPCODES) \
+			luaV_opcodeStats.count[aux]++; \
+		lastOp = aux; \
+		lastCycles = now; \
+	}
+
+#define vmstatsflush() \
+	if (stats && lastOp >= 0) \
+		luaV_opcodeStats.cycles[lastOp] += luaP_readcyclecounter() - lastCycles;
+
+#define vmfetch()	{ aux = *pc++; vmstats(); }
+
+#ifdef LUA_THREADED_DISPATCH
+#define vmdispatch()	{ vmfetch(); LUA_GNU_EXTENSION_BEGIN goto *dispatchTable[aux]; LUA_GNU_EXTENSION_END }
+#define vmcase(op)	L_##op:
+#define vmbreak		vmdispatch()
+#else
+#define vmcase(op)	case op:
+#define vmbreak		break
+#endif
+
 StkId luaV_execute(lua_Task *task) {
+	if (lua_profiling) {
+		if (!task->some_flag)
+			luaP_callLua(task->tf);
+		luaP_sample();
+	}
+
 	if (!task->some_flag) {
 		luaD_checkstack((*task->pc++) + EXTRA_STACK);
 		if (*task->pc < ZEROVARARG) {
@@ -254,436 +377,519 @@ StkId luaV_execute(lua_Task *task) {
 	}
 	lua_state->state_counter2++;
 
+	Stack *const S = task->S;
+	TObject *const consts = task->consts;
+	byte *pc = task->pc;
+	TObject *top = S->top;
+	StkId base = task->base;
+	int32 aux = task->aux;
+
+	const bool stats = luaV_opcodeStats.enabled;
+	int32 lastOp = -1;
+	uint64 lastCycles = 0;
+
+#ifdef LUA_THREADED_DISPATCH
+#define LUA_OPCODE_LABEL(op) &&L_##op,
+	LUA_GNU_EXTENSION_BEGIN
+	static const void *const dispatchTable[NUM_OPCODES] = { LUA_OPCODE_LIST(LUA_OPCODE_LABEL) };
+	LUA_GNU_EXTENSION_END
+#undef LUA_OPCODE_LABEL
+
+	vmdispatch();
+#else
 	while (1) {
-		switch ((OpCode)(task->aux = *task->pc++)) {
-		case PUSHNIL0:
-			ttype(task->S->top++) = LUA_T_NIL;
-			break;
-		case PUSHNIL:
-			task->aux = *task->pc++;
+		vmfetch();
+		switch ((OpCode)aux) {
+#endif
+		vmcase(PUSHNIL0)
+			ttype(top++) = LUA_T_NIL;
+			vmbreak;
+		vmcase(PUSHNIL)
+			aux = *pc++;
 			do {
-				ttype(task->S->top++) = LUA_T_NIL;
-			} while (task->aux--);
-			break;
-		case PUSHNUMBER:
-			task->aux = *task->pc++;
+				ttype(top++) = LUA_T_NIL;
+			} while (aux--);
+			vmbreak;
+		vmcase(PUSHNUMBER)
+			aux = *pc++;
 			goto pushnumber;
-		case PUSHNUMBERW:
-			task->aux = next_word(task->pc);
+		vmcase(PUSHNUMBERW)
+			aux = next_word(pc);
 			goto pushnumber;
-		case PUSHNUMBER0:
-		case PUSHNUMBER1:
-		case PUSHNUMBER2:
-			task->aux -= PUSHNUMBER0;
+		vmcase(PUSHNUMBER0)
+		vmcase(PUSHNUMBER1)
+		vmcase(PUSHNUMBER2)
+			aux -= PUSHNUMBER0;
 pushnumber:
-			ttype(task->S->top) = LUA_T_NUMBER;
-			nvalue(task->S->top) = (float)task->aux;
-			task->S->top++;
-			break;
-		case PUSHLOCAL:
-			task->aux = *task->pc++;
+			ttype(top) = LUA_T_NUMBER;
+			nvalue(top) = (float)aux;
+			top++;
+			vmbreak;
+		vmcase(PUSHLOCAL)
+			aux = *pc++;
 			goto pushlocal;
-		case PUSHLOCAL0:
-		case PUSHLOCAL1:
-		case PUSHLOCAL2:
-		case PUSHLOCAL3:
-		case PUSHLOCAL4:
-		case PUSHLOCAL5:
-		case PUSHLOCAL6:
-		case PUSHLOCAL7:
-			task->aux -= PUSHLOCAL0;
+		vmcase(PUSHLOCAL0)
+		vmcase(PUSHLOCAL1)
+		vmcase(PUSHLOCAL2)
+		vmcase(PUSHLOCAL3)
+		vmcase(PUSHLOCAL4)
+		vmcase(PUSHLOCAL5)
+		vmcase(PUSHLOCAL6)
+		vmcase(PUSHLOCAL7)
+			aux -= PUSHLOCAL0;
 pushlocal:
-			*task->S->top++ = *((task->S->stack + task->base) + task->aux);
-			break;
-		case GETGLOBALW:
-			task->aux = next_word(task->pc);
+			*top++ = *(stackbase() + aux);
+			vmbreak;
+		vmcase(GETGLOBALW)
+			aux = next_word(pc);
 			goto getglobal;
-		case GETGLOBAL:
-			task->aux = *task->pc++;
+		vmcase(GETGLOBAL)
+			aux = *pc++;
 			goto getglobal;
-		case GETGLOBAL0:
-		case GETGLOBAL1:
-		case GETGLOBAL2:
-		case GETGLOBAL3:
-		case GETGLOBAL4:
-		case GETGLOBAL5:
-		case GETGLOBAL6:
-		case GETGLOBAL7:
-			task->aux -= GETGLOBAL0;
+		vmcase(GETGLOBAL0)
+		vmcase(GETGLOBAL1)
+		vmcase(GETGLOBAL2)
+		vmcase(GETGLOBAL3)
+		vmcase(GETGLOBAL4)
+		vmcase(GETGLOBAL5)
+		vmcase(GETGLOBAL6)
+		vmcase(GETGLOBAL7)
+			aux -= GETGLOBAL0;
 getglobal:
-			luaV_getglobal(tsvalue(&task->consts[task->aux]));
-			break;
-		case GETTABLE:
+			savestate();
+			luaV_getglobal(tsvalue(&consts[aux]));
+			loadtop();
+			vmbreak;
+		vmcase(GETTABLE)
+			savestate();
 			luaV_gettable();
-			break;
-		case GETDOTTEDW:
-			task->aux = next_word(task->pc); goto getdotted;
-		case GETDOTTED:
-			task->aux = *task->pc++;
+			loadtop();
+			vmbreak;
+		vmcase(GETDOTTEDW)
+			aux = next_word(pc);
+			goto getdotted;
+		vmcase(GETDOTTED)
+			aux = *pc++;
 			goto getdotted;
-		case GETDOTTED0:
-		case GETDOTTED1:
-		case GETDOTTED2:
-		case GETDOTTED3:
-		case GETDOTTED4:
-		case GETDOTTED5:
-		case GETDOTTED6:
-		case GETDOTTED7:
-			task->aux -= GETDOTTED0;
+		vmcase(GETDOTTED0)
+		vmcase(GETDOTTED1)
+		vmcase(GETDOTTED2)
+		vmcase(GETDOTTED3)
+		vmcase(GETDOTTED4)
+		vmcase(GETDOTTED5)
+		vmcase(GETDOTTED6)
+		vmcase(GETDOTTED7)
+			aux -= GETDOTTED0;
 getdotted:
-			*task->S->top++ = task->consts[task->aux];
+			*top++ = consts[aux];
+			savestate();
 			luaV_gettable();
-			break;
-		case PUSHSELFW:
-			task->aux = next_word(task->pc);
+			loadtop();
+			vmbreak;
+		vmcase(PUSHSELFW)
+			aux = next_word(pc);
 			goto pushself;
-		case PUSHSELF:
-			task->aux = *task->pc++;
+		vmcase(PUSHSELF)
+			aux = *pc++;
 			goto pushself;
-		case PUSHSELF0:
-		case PUSHSELF1:
-		case PUSHSELF2:
-		case PUSHSELF3:
-		case PUSHSELF4:
-		case PUSHSELF5:
-		case PUSHSELF6:
-		case PUSHSELF7:
-			task->aux -= PUSHSELF0;
+		vmcase(PUSHSELF0)
+		vmcase(PUSHSELF1)
+		vmcase(PUSHSELF2)
+		vmcase(PUSHSELF3)
+		vmcase(PUSHSELF4)
+		vmcase(PUSHSELF5)
+		vmcase(PUSHSELF6)
+		vmcase(PUSHSELF7)
+			aux -= PUSHSELF0;
 pushself:
 			{
-				TObject receiver = *(task->S->top - 1);
-				*task->S->top++ = task->consts[task->aux];
+				TObject receiver = *(top - 1);
+				*top++ = consts[aux];
+				savestate();
 				luaV_gettable();
-				*task->S->top++ = receiver;
-				break;
+				loadtop();
+				*top++ = receiver;
+				vmbreak;
 			}
-		case PUSHCONSTANTW:
-			task->aux = next_word(task->pc);
+		vmcase(PUSHCONSTANTW)
+			aux = next_word(pc);
 			goto pushconstant;
-		case PUSHCONSTANT:
-			task->aux = *task->pc++; goto pushconstant;
-		case PUSHCONSTANT0:
-		case PUSHCONSTANT1:
-		case PUSHCONSTANT2:
-		case PUSHCONSTANT3:
-		case PUSHCONSTANT4:
-		case PUSHCONSTANT5:
-		case PUSHCONSTANT6:
-		case PUSHCONSTANT7:
-			task->aux -= PUSHCONSTANT0;
+		vmcase(PUSHCONSTANT)
+			aux = *pc++;
+			goto pushconstant;
+		vmcase(PUSHCONSTANT0)
+		vmcase(PUSHCONSTANT1)
+		vmcase(PUSHCONSTANT2)
+		vmcase(PUSHCONSTANT3)
+		vmcase(PUSHCONSTANT4)
+		vmcase(PUSHCONSTANT5)
+		vmcase(PUSHCONSTANT6)
+		vmcase(PUSHCONSTANT7)
+			aux -= PUSHCONSTANT0;
 pushconstant:
-			*task->S->top++ = task->consts[task->aux];
-			break;
-		case PUSHUPVALUE:
-			task->aux = *task->pc++;
+			*top++ = consts[aux];
+			vmbreak;
+		vmcase(PUSHUPVALUE)
+			aux = *pc++;
 			goto pushupvalue;
-		case PUSHUPVALUE0:
-		case PUSHUPVALUE1:
-			task->aux -= PUSHUPVALUE0;
+		vmcase(PUSHUPVALUE0)
+		vmcase(PUSHUPVALUE1)
+			aux -= PUSHUPVALUE0;
 pushupvalue:
-			*task->S->top++ = task->cl->consts[task->aux + 1];
-			break;
-		case SETLOCAL:
-			task->aux = *task->pc++;
+			*top++ = task->cl->consts[aux + 1];
+			vmbreak;
+		vmcase(SETLOCAL)
+			aux = *pc++;
 			goto setlocal;
-		case SETLOCAL0:
-		case SETLOCAL1:
-		case SETLOCAL2:
-		case SETLOCAL3:
-		case SETLOCAL4:
-		case SETLOCAL5:
-		case SETLOCAL6:
-		case SETLOCAL7:
-			task->aux -= SETLOCAL0;
+		vmcase(SETLOCAL0)
+		vmcase(SETLOCAL1)
+		vmcase(SETLOCAL2)
+		vmcase(SETLOCAL3)
+		vmcase(SETLOCAL4)
+		vmcase(SETLOCAL5)
+		vmcase(SETLOCAL6)
+		vmcase(SETLOCAL7)
+			aux -= SETLOCAL0;
 setlocal:
-			*((task->S->stack + task->base) + task->aux) = *(--task->S->top);
-			break;
-		case SETGLOBALW:
-			task->aux = next_word(task->pc);
+			*(stackbase() + aux) = *(--top);
+			vmbreak;
+		vmcase(SETGLOBALW)
+			aux = next_word(pc);
 			goto setglobal;
-		case SETGLOBAL:
-			task->aux = *task->pc++;
+		vmcase(SETGLOBAL)
+			aux = *pc++;
 			goto setglobal;
-		case SETGLOBAL0:
-		case SETGLOBAL1:
-		case SETGLOBAL2:
-		case SETGLOBAL3:
-		case SETGLOBAL4:
-		case SETGLOBAL5:
-		case SETGLOBAL6:
-		case SETGLOBAL7:
-			task->aux -= SETGLOBAL0;
+		vmcase(SETGLOBAL0)
+		vmcase(SETGLOBAL1)
+		vmcase(SETGLOBAL2)
+		vmcase(SETGLOBAL3)
+		vmcase(SETGLOBAL4)
+		vmcase(SETGLOBAL5)
+		vmcase(SETGLOBAL6)
+		vmcase(SETGLOBAL7)
+			aux -= SETGLOBAL0;
 setglobal:
-			luaV_setglobal(tsvalue(&task->consts[task->aux]));
-			break;
-		case SETTABLE0:
-			luaV_settable(task->S->top - 3, 1);
-			break;
-		case SETTABLE:
-			luaV_settable(task->S->top - 3 - (*task->pc++), 2);
-			break;
-		case SETLISTW:
-			task->aux = next_word(task->pc);
-			task->aux *= LFIELDS_PER_FLUSH;
+			savestate();
+			luaV_setglobal(tsvalue(&consts[aux]));
+			loadtop();
+			vmbreak;
+		vmcase(SETTABLE0)
+			savestate();
+			luaV_settable(top - 3, 1);
+			loadtop();
+			vmbreak;
+		vmcase(SETTABLE)
+			{
+				TObject *t = top - 3 - (*pc++);
+				savestate();
+				luaV_settable(t, 2);
+				loadtop();
+				vmbreak;
+			}
+		vmcase(SETLISTW)
+			aux = next_word(pc);
+			aux *= LFIELDS_PER_FLUSH;
 			goto setlist;
-		case SETLIST:
-			task->aux = *(task->pc++) * LFIELDS_PER_FLUSH;
+		vmcase(SETLIST)
+			aux = *(pc++) * LFIELDS_PER_FLUSH;
 			goto setlist;
-		case SETLIST0:
-			task->aux = 0;
+		vmcase(SETLIST0)
+			aux = 0;
 setlist:
 			{
-				int32 n = *(task->pc++);
-				TObject *arr = task->S->top - n - 1;
+				int32 n = *(pc++);
+				TObject *arr = top - n - 1;
 				for (; n; n--) {
-					ttype(task->S->top) = LUA_T_NUMBER;
-					nvalue(task->S->top) = (float)(n + task->aux);
-					*(luaH_set(avalue(arr), task->S->top)) = *(task->S->top - 1);
-					task->S->top--;
+					ttype(top) = LUA_T_NUMBER;
+					nvalue(top) = (float)(n + aux);
+					savestate();
+					*(luaH_set(avalue(arr), top)) = *(top - 1);
+					top--;
+				}
+				vmbreak;
 			}
-			break;
-		}
-		case SETMAP0:
-			task->aux = 0;
+		vmcase(SETMAP0)
+			aux = 0;
 			goto setmap;
-		case SETMAP:
-			task->aux = *task->pc++;
+		vmcase(SETMAP)
+			aux = *pc++;
 setmap:
 			{
-				TObject *arr = task->S->top - (2 * task->aux) - 3;
+				TObject *arr = top - (2 * aux) - 3;
 				do {
-					*(luaH_set(avalue(arr), task->S->top - 2)) = *(task->S->top - 1);
-					task->S->top -= 2;
-				} while (task->aux--);
-				break;
+					savestate();
+					*(luaH_set(avalue(arr), top - 2)) = *(top - 1);
+					top -= 2;
+				} while (aux--);
+				vmbreak;
 			}
-		case POP:
-			task->aux = *task->pc++;
+		vmcase(POP)
+			aux = *pc++;
 			goto pop;
-		case POP0:
-		case POP1:
-			task->aux -= POP0;
+		vmcase(POP0)
+		vmcase(POP1)
+			aux -= POP0;
 pop:
-			task->S->top -= (task->aux + 1);
-			break;
-		case CREATEARRAYW:
-			task->aux = next_word(task->pc);
+			top -= (aux + 1);
+			vmbreak;
+		vmcase(CREATEARRAYW)
+			aux = next_word(pc);
 			goto createarray;
-		case CREATEARRAY0:
-		case CREATEARRAY1:
-			task->aux -= CREATEARRAY0;
+		vmcase(CREATEARRAY0)
+		vmcase(CREATEARRAY1)
+			aux -= CREATEARRAY0;
 			goto createarray;
-		case CREATEARRAY:
-			task->aux = *task->pc++;
+		vmcase(CREATEARRAY)
+			aux = *pc++;
 createarray:
+			savestate();
 			luaC_checkGC();
-			avalue(task->S->top) = luaH_new(task->aux);
-			ttype(task->S->top) = LUA_T_ARRAY;
-			task->S->top++;
-			break;
-		case EQOP:
-		case NEQOP:
+			avalue(top) = luaH_new(aux);
+			ttype(top) = LUA_T_ARRAY;
+			top++;
+			vmbreak;
+		vmcase(EQOP)
+		vmcase(NEQOP)
 			{
-				int32 res = luaO_equalObj(task->S->top - 2, task->S->top - 1);
-				task->S->top--;
-				if (task->aux == NEQOP)
+				int32 res = luaO_equalObj(top - 2, top - 1);
+				top--;
+				if (aux == NEQOP)
 					res = !res;
-				ttype(task->S->top - 1) = res ? LUA_T_NUMBER : LUA_T_NIL;
-				nvalue(task->S->top - 1) = 1;
-				break;
+				ttype(top - 1) = res ? LUA_T_NUMBER : LUA_T_NIL;
+				nvalue(top - 1) = 1;
+				vmbreak;
 			}
-		case LTOP:
+		vmcase(LTOP)
+			savestate();
 			comparison(LUA_T_NUMBER, LUA_T_NIL, LUA_T_NIL, IM_LT);
-			break;
-		case LEOP:
+			loadtop();
+			vmbreak;
+		vmcase(LEOP)
+			savestate();
 			comparison(LUA_T_NUMBER, LUA_T_NUMBER, LUA_T_NIL, IM_LE);
-			break;
-		case GTOP:
+			loadtop();
+			vmbreak;
+		vmcase(GTOP)
+			savestate();
 			comparison(LUA_T_NIL, LUA_T_NIL, LUA_T_NUMBER, IM_GT);
-			break;
-		case GEOP:
+			loadtop();
+			vmbreak;
+		vmcase(GEOP)
+			savestate();
 			comparison(LUA_T_NIL, LUA_T_NUMBER, LUA_T_NUMBER, IM_GE);
-			break;
-		case ADDOP:
+			loadtop();
+			vmbreak;
+		vmcase(ADDOP)
 			{
-				TObject *l = task->S->top - 2;
-				TObject *r = task->S->top - 1;
-				if (tonumber(r) || tonumber(l))
+				TObject *l = top - 2;
+				TObject *r = top - 1;
+				if (tonumber(r) || tonumber(l)) {
+					savestate();
 					call_arith(IM_ADD);
-				else {
+					loadtop();
+				} else {
 					nvalue(l) += nvalue(r);
-					--task->S->top;
+					--top;
 				}
-			break;
+				vmbreak;
 			}
-		case SUBOP:
+		vmcase(SUBOP)
 			{
-				TObject *l = task->S->top - 2;
-				TObject *r = task->S->top - 1;
-				if (tonumber(r) || tonumber(l))
+				TObject *l = top - 2;
+				TObject *r = top - 1;
+				if (tonumber(r) || tonumber(l)) {
+					savestate();
 					call_arith(IM_SUB);
-				else {
+					loadtop();
+				} else {
 					nvalue(l) -= nvalue(r);
-					--task->S->top;
+					--top;
 				}
-				break;
+				vmbreak;
 			}
-		case MULTOP:
+		vmcase(MULTOP)
 			{
-				TObject *l = task->S->top - 2;
-				TObject *r = task->S->top - 1;
-				if (tonumber(r) || tonumber(l))
+				TObject *l = top - 2;
+				TObject *r = top - 1;
+				if (tonumber(r) || tonumber(l)) {
+					savestate();
 					call_arith(IM_MUL);
-				else {
+					loadtop();
+				} else {
 					nvalue(l) *= nvalue(r);
-					--task->S->top;
+					--top;
 				}
-				break;
+				vmbreak;
 			}
-		case DIVOP:
+		vmcase(DIVOP)
 			{
-				TObject *l = task->S->top - 2;
-				TObject *r = task->S->top - 1;
-				if (tonumber(r) || tonumber(l))
+				TObject *l = top - 2;
+				TObject *r = top - 1;
+				if (tonumber(r) || tonumber(l)) {
+					savestate();
 					call_arith(IM_DIV);
-				else {
+					loadtop();
+				} else {
 					nvalue(l) /= nvalue(r);
-					--task->S->top;
+					--top;
 				}
-				break;
+				vmbreak;
 			}
-		case POWOP:
+		vmcase(POWOP)
+			savestate();
 			call_arith(IM_POW);
-			break;
-		case CONCOP:
+			loadtop();
+			vmbreak;
+		vmcase(CONCOP)
 			{
-				TObject *l = task->S->top - 2;
-				TObject *r = task->S->top - 1;
+				TObject *l = top - 2;
+				TObject *r = top - 1;
+				savestate();
 				if (tostring(l) || tostring(r))
 					call_binTM(IM_CONCAT, "unexpected type for concatenation");
 				else {
 					tsvalue(l) = strconc(svalue(l), svalue(r));
-					--task->S->top;
+					--S->top;
 				}
 				luaC_checkGC();
-				break;
+				loadtop();
+				vmbreak;
 			}
-		case MINUSOP:
-			if (tonumber(task->S->top - 1)) {
-				ttype(task->S->top) = LUA_T_NIL;
-				task->S->top++;
+		vmcase(MINUSOP)
+			if (tonumber(top - 1)) {
+				ttype(top) = LUA_T_NIL;
+				top++;
+				savestate();
 				call_arith(IM_UNM);
+				loadtop();
 			} else
-				nvalue(task->S->top - 1) = -nvalue(task->S->top - 1);
-			break;
-		case NOTOP:
-			ttype(task->S->top - 1) = (ttype(task->S->top - 1) == LUA_T_NIL) ? LUA_T_NUMBER : LUA_T_NIL;
-			nvalue(task->S->top - 1) = 1;
-			break;
-		case ONTJMPW:
-			task->aux = next_word(task->pc);
+				nvalue(top - 1) = -nvalue(top - 1);
+			vmbreak;
+		vmcase(NOTOP)
+			ttype(top - 1) = (ttype(top - 1) == LUA_T_NIL) ? LUA_T_NUMBER : LUA_T_NIL;
+			nvalue(top - 1) = 1;
+			vmbreak;
+		vmcase(ONTJMPW)
+			aux = next_word(pc);
 			goto ontjmp;
-		case ONTJMP:
-			task->aux = *task->pc++;
+		vmcase(ONTJMP)
+			aux = *pc++;
 ontjmp:
-			if (ttype(task->S->top - 1) != LUA_T_NIL)
-				task->pc += task->aux;
+			if (ttype(top - 1) != LUA_T_NIL)
+				pc += aux;
 			else
-				task->S->top--;
-			break;
-		case ONFJMPW:
-			task->aux = next_word(task->pc);
+				top--;
+			vmbreak;
+		vmcase(ONFJMPW)
+			aux = next_word(pc);
 			goto onfjmp;
-		case ONFJMP:
-			task->aux = *task->pc++;
+		vmcase(ONFJMP)
+			aux = *pc++;
 onfjmp:
-			if (ttype(task->S->top - 1) == LUA_T_NIL)
-				task->pc += task->aux;
+			if (ttype(top - 1) == LUA_T_NIL)
+				pc += aux;
 			else
-				task->S->top--;
-			break;
-		case JMPW:
-			task->aux = next_word(task->pc);
+				top--;
+			vmbreak;
+		vmcase(JMPW)
+			aux = next_word(pc);
 			goto jmp;
-		case JMP:
-			task->aux = *task->pc++;
+		vmcase(JMP)
+			aux = *pc++;
 jmp:
-			task->pc += task->aux;
-			break;
-		case IFFJMPW:
-			task->aux = next_word(task->pc);
+			pc += aux;
+			vmbreak;
+		vmcase(IFFJMPW)
+			aux = next_word(pc);
 			goto iffjmp;
-		case IFFJMP:
-			task->aux = *task->pc++;
+		vmcase(IFFJMP)
+			aux = *pc++;
 iffjmp:
-			if (ttype(--task->S->top) == LUA_T_NIL)
-				task->pc += task->aux;
-			break;
-		case IFTUPJMPW:
-			task->aux = next_word(task->pc);
+			if (ttype(--top) == LUA_T_NIL)
+				pc += aux;
+			vmbreak;
+		vmcase(IFTUPJMPW)
+			aux = next_word(pc);
 			goto iftupjmp;
-		case IFTUPJMP:
-			task->aux = *task->pc++;
+		vmcase(IFTUPJMP)
+			aux = *pc++;
 iftupjmp:
-			if (ttype(--task->S->top) != LUA_T_NIL)
-				task->pc -= task->aux;
-			break;
-		case IFFUPJMPW:
-			task->aux = next_word(task->pc);
+			if (ttype(--top) != LUA_T_NIL)
+				pc -= aux;
+			vmbreak;
+		vmcase(IFFUPJMPW)
+			aux = next_word(pc);
 			goto iffupjmp;
-		case IFFUPJMP:
-			task->aux = *task->pc++;
+		vmcase(IFFUPJMP)
+			aux = *pc++;
 iffupjmp:
-			if (ttype(--task->S->top) == LUA_T_NIL)
-				task->pc -= task->aux;
-			break;
-		case CLOSURE:
-			task->aux = *task->pc++;
+			if (ttype(--top) == LUA_T_NIL)
+				pc -= aux;
+			vmbreak;
+		vmcase(CLOSURE)
+			aux = *pc++;
 			goto closure;
-		case CLOSURE0:
-		case CLOSURE1:
-			task->aux -= CLOSURE0;
+		vmcase(CLOSURE0)
+		vmcase(CLOSURE1)
+			aux -= CLOSURE0;
 closure:
-			luaV_closure(task->aux);
+			savestate();
+			luaV_closure(aux);
 			luaC_checkGC();
-			break;
-	  case CALLFUNC:
-			task->aux = *task->pc++;
+			loadtop();
+			vmbreak;
+		vmcase(CALLFUNC)
+			aux = *pc++;
 			goto callfunc;
-	  case CALLFUNC0:
-	  case CALLFUNC1:
-			task->aux -= CALLFUNC0;
+		vmcase(CALLFUNC0)
+		vmcase(CALLFUNC1)
+			aux -= CALLFUNC0;
 callfunc:
-			lua_state->state_counter2--;
-			return -((task->S->top - task->S->stack) - (*task->pc++));
-		case ENDCODE:
-			task->S->top = task->S->stack + task->base;
+			{
+				vmstatsflush();
+				StkId funcBase = (top - S->stack) - (*pc++);
+				savestate();
+				if (lua_profiling)
+					luaP_sample();
+				lua_state->state_counter2--;
+				return -funcBase;
+			}
+		vmcase(ENDCODE)
+			top = stackbase();
 			// goes through
-		case RETCODE:
+		vmcase(RETCODE)
+			vmstatsflush();
+			savestate();
+			if (lua_profiling)
+				luaP_sample();
 			lua_state->state_counter2--;
-			return (task->base + ((task->aux == 123) ? *task->pc : 0));
-		case SETLINEW:
-			task->aux = next_word(task->pc);
+			return (base + ((aux == RETCODE) ? *pc : 0));
+		vmcase(SETLINEW)
+			aux = next_word(pc);
 			goto setline;
-		case SETLINE:
-			task->aux = *task->pc++;
+		vmcase(SETLINE)
+			aux = *pc++;
 setline:
-			if ((task->S->stack + task->base - 1)->ttype != LUA_T_LINE) {
+			savestate();
+			if ((stackbase() - 1)->ttype != LUA_T_LINE) {
 				// open space for LINE value */
-				luaD_openstack((task->S->top - task->S->stack) - task->base);
-				task->base++;
-				(task->S->stack + task->base - 1)->ttype = LUA_T_LINE;
+				luaD_openstack((S->top - S->stack) - base);
+				task->base = ++base;
+				(stackbase() - 1)->ttype = LUA_T_LINE;
 			}
-			(task->S->stack + task->base - 1)->value.i = task->aux;
+			(stackbase() - 1)->value.i = aux;
 			if (lua_linehook)
-				luaD_lineHook(task->aux);
-			break;
+				luaD_lineHook(aux);
+			loadtop();
+			vmbreak;
+#ifndef LUA_THREADED_DISPATCH
 #ifdef LUA_DEBUG
 		default:
 			LUA_INTERNALERROR("internal error - opcode doesn't match");
 #endif
 		}
 	}
+#endif
 }
 
 } // end of namespace Grim
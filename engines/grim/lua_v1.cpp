@@ -513,6 +513,7 @@ void Lua_V1::GetSaveGameImage() {
 		return;
 	}
 	const char *filename = lua_getstring(param);
+	g_grim->finishPendingSave();
 	SaveGame *savedState = SaveGame::openForLoading(filename);
 	if (!savedState || !savedState->isCompatible()) {
 		delete savedState;
@@ -570,6 +571,7 @@ void Lua_V1::GetSaveGameData() {
 	if (!lua_isstring(param))
 		return;
 	const char *filename = lua_getstring(param);
+	g_grim->finishPendingSave();
 	SaveGame *savedState = SaveGame::openForLoading(filename);
 	lua_Object result = lua_createtable();
 
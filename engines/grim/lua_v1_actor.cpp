@@ -659,18 +659,10 @@ void Lua_V1::GetActorNodeLocation() {
 	ModelNode *allNodes = actor->getCurrentCostume()->getModelNodes();
 	ModelNode *node = allNodes + nodeId;
 
-	node->_needsUpdate = true;
-	ModelNode *root = node;
-	while (root->_parent) {
-		root = root->_parent;
-		root->_needsUpdate = true;
-	}
-
 	Math::Matrix4 matrix;
 	matrix.setPosition(actor->getPos());
 	matrix.buildFromXYZ(actor->getYaw(), actor->getPitch(), actor->getRoll(), Math::EO_ZXY);
-	root->setMatrix(matrix);
-	root->update();
+	node->updateFromRoot(matrix);
 
 	Math::Vector3d pos(node->_pivotMatrix.getPosition());
 	lua_pushnumber(pos.x());
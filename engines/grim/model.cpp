@@ -40,12 +40,16 @@
 
 namespace Grim {
 
+// Changes whenever a hierarchy is attached to or detached from another one, so
+// that the node lists built from the old shape get built again
+static uint s_hierarchyVersion = 0;
 
 /**
  * @class Model
  */
 Model::Model(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap, Model *parent) :
-		Object(), _parent(parent), _numMaterials(0), _numGeosets(0), _cmap(cmap), _fname(filename) {
+		Object(), _parent(parent), _numMaterials(0), _numGeosets(0), _cmap(cmap), _fname(filename),
+		_hierOrder(nullptr), _hierParents(nullptr) {
 
 	if (data->readUint32BE() == MKTAG('L','D','O','M'))
 		loadBinary(data);
@@ -55,9 +59,11 @@ Model::Model(const Common::String &filename, Common::SeekableReadStream *data, C
 		loadText(&ts);
 	}
 
+	setupHierarchy();
+
 	Math::Vector3d max;
 
-	_rootHierNode->update();
+	updateHierarchy();
 	bool first = true;
 	for (int i = 0; i < _numHierNodes; ++i) {
 		ModelNode &node = _rootHierNode[i];
@@ -164,9 +170,51 @@ Model::~Model() {
 	delete[] _materialsShared;
 	delete[] _geosets;
 	delete[] _rootHierNode;
+	delete[] _hierOrder;
+	delete[] _hierParents;
 	g_resourceloader->uncacheModel(this);
 }
 
+void Model::setupHierarchy() {
+	_hierOrder = new int[_numHierNodes];
+	_hierParents = new int[_numHierNodes];
+
+	int *depths = new int[_numHierNodes];
+	int maxDepth = 0;
+	for (int i = 0; i < _numHierNodes; i++) {
+		const ModelNode *parent = _rootHierNode[i]._parent;
+		_hierParents[i] = parent ? parent - _rootHierNode : -1;
+		depths[i] = 0;
+		for (; parent; parent = parent->_parent) {
+			depths[i]++;
+		}
+		maxDepth = MAX(maxDepth, depths[i]);
+	}
+
+	// Going through the nodes by depth puts every parent before its children
+	int numOrdered = 0;
+	for (int depth = 0; depth <= maxDepth; depth++) {
+		for (int i = 0; i < _numHierNodes; i++) {
+			if (depths[i] == depth)
+				_hierOrder[numOrdered++] = i;
+		}
+	}
+	delete[] depths;
+}
+
+void Model::updateHierarchy() {
+	const Math::Matrix4 identity;
+	for (int i = 0; i < _numHierNodes; i++) {
+		const int index = _hierOrder[i];
+		ModelNode &node = _rootHierNode[index];
+		if (!node._initialized)
+			continue;
+
+		const int parent = _hierParents[index];
+		node.updateMatrices(parent >= 0 ? _rootHierNode[parent]._matrix : identity);
+	}
+}
+
 void Model::loadBinary(Common::SeekableReadStream *data) {
 	char v3[4 * 3], f[4];
 	_numMaterials = data->readUint32LE();
@@ -278,10 +326,6 @@ void Model::loadText(TextSplitter *ts) {
 		Debug::warning(Debug::Models, "Unexpected junk at end of model text");
 }
 
-void Model::draw() const {
-	_rootHierNode->draw();
-}
-
 ModelNode *Model::getHierarchy() const {
 	return _rootHierNode;
 }
@@ -473,6 +517,8 @@ Mesh::Mesh() :
 
 
 Mesh::~Mesh() {
+	if (_userData)
+		g_driver->destroyModel(this);
 	delete[] _vertices;
 	delete[] _verticesI;
 	delete[] _vertNormals;
@@ -655,7 +701,7 @@ void Mesh::getBoundingBox(int *x1, int *y1, int *x2, int *y2) const {
  * @class ModelNode
  */
 ModelNode::ModelNode() :
-		_initialized(false), _needsUpdate(true), _mesh(nullptr), _flags(0), _type(0),
+		_initialized(false), _mesh(nullptr), _flags(0), _type(0),
 		_depth(0), _numChildren(0), _parent(nullptr), _child(nullptr), _sprite(nullptr),
 		_sibling(nullptr), _meshVisible(false), _hierVisible(false) {
 	_name[0] = '\0';
@@ -723,66 +769,13 @@ void ModelNode::loadBinary(Common::SeekableReadStream *data, ModelNode *hierNode
 	_initialized = true;
 }
 
-void ModelNode::draw() const {
-	translateViewpoint();
-	if (_hierVisible) {
-		g_driver->translateViewpointStart();
-		g_driver->translateViewpoint(_pivot);
-
-		if (!g_driver->isShadowModeActive()) {
-			Sprite *sprite = _sprite;
-			while (sprite) {
-				sprite->draw();
-				sprite = sprite->_next;
-			}
-		}
-
-		if (_mesh && _meshVisible) {
-			_mesh->draw();
-		}
-
-		g_driver->translateViewpointFinish();
-
-		if (_child) {
-			_child->draw();
-		}
-	}
-	translateViewpointBack();
-
-	if (_sibling) {
-		_sibling->draw();
-	}
-}
-
-void ModelNode::getBoundingBox(int *x1, int *y1, int *x2, int *y2) const {
-	translateViewpoint();
-	if (_hierVisible) {
-		g_driver->translateViewpointStart();
-		g_driver->translateViewpoint(_pivot);
-
-		if (_mesh && _meshVisible) {
-			_mesh->getBoundingBox(x1, y1, x2, y2);
-		}
-
-		g_driver->translateViewpointFinish();
-
-		if (_child) {
-			_child->getBoundingBox(x1, y1, x2, y2);
-		}
-	}
-	translateViewpointBack();
-
-	if (_sibling) {
-		_sibling->getBoundingBox(x1, y1, x2, y2);
-	}
-}
-
 void ModelNode::addChild(ModelNode *child) {
 	ModelNode **childPos = &_child;
 	while (*childPos)
 		childPos = &(*childPos)->_sibling;
 	*childPos = child;
 	child->_parent = this;
+	s_hierarchyVersion++;
 }
 
 void ModelNode::removeChild(ModelNode *child) {
@@ -792,47 +785,53 @@ void ModelNode::removeChild(ModelNode *child) {
 	if (*childPos) {
 		*childPos = child->_sibling;
 		child->_parent = nullptr;
+		s_hierarchyVersion++;
 	}
 }
 
-void ModelNode::setMatrix(const Math::Matrix4 &matrix) {
-	_matrix = matrix;
-	if (_sibling)
-		_sibling->setMatrix(matrix);
-}
-
-void ModelNode::update() {
-	if (!_initialized)
-		return;
+void ModelNode::updateMatrices(const Math::Matrix4 &parentMatrix) {
+	_localMatrix = computeLocalMatrix();
+	_matrix = parentMatrix * _localMatrix;
 
-	if (_hierVisible && _needsUpdate) {
-		Math::Vector3d animPos = _pos + _animPos;
-		Math::Angle animPitch = _pitch + _animPitch;
-		Math::Angle animYaw = _yaw + _animYaw;
-		Math::Angle animRoll = _roll + _animRoll;
+	_pivotMatrix = _matrix;
+	_pivotMatrix.translate(_pivot);
 
-		_localMatrix.setPosition(animPos);
-		_localMatrix.buildFromXYZ(animYaw, animPitch, animRoll, Math::EO_ZXY);
-
-		_matrix = _matrix * _localMatrix;
-
-		_pivotMatrix = _matrix;
-		_pivotMatrix.translate(_pivot);
+	if (_mesh) {
+		_mesh->_matrix = _pivotMatrix;
+	}
+}
 
-		if (_mesh) {
-			_mesh->_matrix = _pivotMatrix;
-		}
+Math::Matrix4 ModelNode::computeLocalMatrix() const {
+	Math::Vector3d animPos = _pos + _animPos;
+	Math::Angle animPitch = _pitch + _animPitch;
+	Math::Angle animYaw = _yaw + _animYaw;
+	Math::Angle animRoll = _roll + _animRoll;
 
-		if (_child) {
-			_child->setMatrix(_matrix);
-			_child->update();
-		}
+	Math::Matrix4 matrix;
+	matrix.setPosition(animPos);
+	matrix.buildFromXYZ(animYaw, animPitch, animRoll, Math::EO_ZXY);
+	return matrix;
+}
 
-		_needsUpdate = false;
+void ModelNode::updateFromRoot(const Math::Matrix4 &rootMatrix) {
+	// The hierarchy of a costume spans the models of all its components,
+	// which is not deep enough to run out of this
+	const int kMaxDepth = 64;
+	ModelNode *path[kMaxDepth];
+	int depth = 0;
+	for (ModelNode *node = this; node; node = node->_parent) {
+		assert(depth < kMaxDepth);
+		path[depth++] = node;
 	}
 
-	if (_sibling) {
-		_sibling->update();
+	const Math::Matrix4 *parentMatrix = &rootMatrix;
+	while (depth-- > 0) {
+		ModelNode *node = path[depth];
+		if (!node->_initialized || !node->_hierVisible)
+			return;
+
+		node->updateMatrices(*parentMatrix);
+		parentMatrix = &node->_matrix;
 	}
 }
 
@@ -856,21 +855,91 @@ void ModelNode::removeSprite(const Sprite *sprite) {
 	}
 }
 
-void ModelNode::translateViewpoint() const {
-	Math::Vector3d animPos = _pos + _animPos;
-	Math::Angle animPitch = _pitch + _animPitch;
-	Math::Angle animYaw = _yaw + _animYaw;
-	Math::Angle animRoll = _roll + _animRoll;
-	g_driver->translateViewpointStart();
+/**
+ * @class ModelNodeList
+ */
+ModelNodeList::ModelNodeList() :
+		_root(nullptr), _hierarchyVersion(0) {
+}
 
-	g_driver->translateViewpoint(animPos);
-	g_driver->rotateViewpoint(animYaw, Math::Vector3d(0, 0, 1));
-	g_driver->rotateViewpoint(animPitch, Math::Vector3d(1, 0, 0));
-	g_driver->rotateViewpoint(animRoll, Math::Vector3d(0, 1, 0));
+void ModelNodeList::addNodes(ModelNode *node, int parent) {
+	for (; node; node = node->_sibling) {
+		const int index = _nodes.size();
+		_nodes.push_back(node);
+		_parents.push_back(parent);
+		addNodes(node->_child, index);
+	}
 }
 
-void ModelNode::translateViewpointBack() const {
-	g_driver->translateViewpointFinish();
+void ModelNodeList::update(ModelNode *root) {
+	if (root != _root || _hierarchyVersion != s_hierarchyVersion) {
+		_root = root;
+		_hierarchyVersion = s_hierarchyVersion;
+		_nodes.clear();
+		_parents.clear();
+		addNodes(root, -1);
+		_matrices.resize(_nodes.size());
+		_visible.resize(_nodes.size());
+	}
+
+	// Every parent comes before its children, so their matrices are ready.
+	// A hidden node hides everything below it.
+	const Math::Matrix4 identity;
+	for (uint i = 0; i < _nodes.size(); i++) {
+		const ModelNode *node = _nodes[i];
+		const int parent = _parents[i];
+		_visible[i] = node->_hierVisible && (parent < 0 || _visible[parent]);
+		if (_visible[i])
+			_matrices[i] = (parent >= 0 ? _matrices[parent] : identity) * node->computeLocalMatrix();
+	}
+}
+
+void ModelNodeList::draw(ModelNode *root) {
+	update(root);
+
+	for (uint i = 0; i < _nodes.size(); i++) {
+		if (!_visible[i])
+			continue;
+
+		const ModelNode *node = _nodes[i];
+		Math::Matrix4 pivotMatrix = _matrices[i];
+		pivotMatrix.translate(node->_pivot);
+
+		g_driver->translateViewpointStart();
+		g_driver->transformViewpoint(pivotMatrix);
+
+		if (!g_driver->isShadowModeActive()) {
+			Sprite *sprite = node->_sprite;
+			while (sprite) {
+				sprite->draw();
+				sprite = sprite->_next;
+			}
+		}
+
+		if (node->_mesh && node->_meshVisible) {
+			node->_mesh->draw();
+		}
+
+		g_driver->translateViewpointFinish();
+	}
+}
+
+void ModelNodeList::getBoundingBox(ModelNode *root, int *x1, int *y1, int *x2, int *y2) {
+	update(root);
+
+	for (uint i = 0; i < _nodes.size(); i++) {
+		const ModelNode *node = _nodes[i];
+		if (!_visible[i] || !node->_mesh || !node->_meshVisible)
+			continue;
+
+		Math::Matrix4 pivotMatrix = _matrices[i];
+		pivotMatrix.translate(node->_pivot);
+
+		g_driver->translateViewpointStart();
+		g_driver->transformViewpoint(pivotMatrix);
+		node->_mesh->getBoundingBox(x1, y1, x2, y2);
+		g_driver->translateViewpointFinish();
+	}
 }
 
 } // end of namespace Grim
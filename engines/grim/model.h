@@ -23,6 +23,8 @@
 #ifndef GRIM_MODEL_H
 #define GRIM_MODEL_H
 
+#include "common/array.h"
+
 #include "engines/grim/object.h"
 #include "math/matrix4.h"
 
@@ -45,7 +47,6 @@ public:
 	Model(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap, Model *parent = NULL);
 
 	void reload(CMap *cmap);
-	void draw() const;
 	Material *findMaterial(const char *name, CMap *cmap) const;
 
 	~Model();
@@ -70,6 +71,11 @@ public:
 	void loadMaterial(int index, CMap *cmap);
 	void loadBinary(Common::SeekableReadStream *data);
 	void loadText(TextSplitter *ts);
+	void setupHierarchy();
+	/**
+	 * Compute the matrices of every node of the model in the bind pose.
+	 */
+	void updateHierarchy();
 
 	Common::String _fname;
 	ObjectPtr<CMap> _cmap;
@@ -84,6 +90,11 @@ public:
 	float _radius;
 	int _numHierNodes;
 	ModelNode *_rootHierNode;
+	// The nodes ordered with every parent before its children, and the index
+	// of the parent of every node or -1, so that the matrices of the whole
+	// hierarchy are computed in one pass
+	int *_hierOrder;
+	int *_hierParents;
 	Math::Vector3d _bboxPos;
 	Math::Vector3d _bboxSize;
 };
@@ -106,6 +117,8 @@ public:
 	int getNumVertices() const { return _numVertices; }
 	int getVertex(int i) const { return _vertices[i]; }
 	int getTextureVertex(int i) const { return _texVertices[i]; }
+	const int *getVertices() const { return _vertices; }
+	const int *getTextureVertices() const { return _texVertices; }
 	int getLight() const { return _light; }
 
 private:
@@ -159,16 +172,26 @@ public:
 	ModelNode();
 	~ModelNode();
 	void loadBinary(Common::SeekableReadStream *data, ModelNode *hierNodes, const Model::Geoset *g);
-	void draw() const;
-	void getBoundingBox(int *x1, int *y1, int *x2, int *y2) const;
 	void addChild(ModelNode *child);
 	void removeChild(ModelNode *child);
-	void setMatrix(const Math::Matrix4 &matrix);
-	void update();
+	/**
+	 * Compute the local matrix from the bind pose and the animation, and the
+	 * world matrices from the world matrix of the parent.
+	 */
+	void updateMatrices(const Math::Matrix4 &parentMatrix);
+	/**
+	 * The transformation of this node relative to its parent, from the bind
+	 * pose and the animation.
+	 */
+	Math::Matrix4 computeLocalMatrix() const;
+	/**
+	 * Compute the matrices of this node and of all its ancestors, going down
+	 * from the root of the hierarchy. Hidden nodes and the nodes below them
+	 * keep their old matrices.
+	 */
+	void updateFromRoot(const Math::Matrix4 &rootMatrix);
 	void addSprite(Sprite *sprite);
 	void removeSprite(const Sprite *sprite);
-	void translateViewpoint() const;
-	void translateViewpointBack() const;
 
 	char _name[64];
 	Mesh *_mesh;
@@ -194,13 +217,38 @@ public:
 	Math::Angle _animPitch, _animYaw, _animRoll;
 	bool _meshVisible, _hierVisible;
 	bool _initialized;
-	bool _needsUpdate;
 	Math::Matrix4 _matrix;
 	Math::Matrix4 _localMatrix;
 	Math::Matrix4 _pivotMatrix;
 	Sprite *_sprite;
 };
 
+/**
+ * The nodes below a node and its siblings in drawing order, with the index of
+ * the parent of every node or -1. Drawing computes the world matrices of all
+ * the nodes in one pass over the list instead of walking the tree with the
+ * matrix stack of the driver. The list is built again when a hierarchy is
+ * attached to or detached from another one.
+ */
+class ModelNodeList {
+public:
+	ModelNodeList();
+
+	void draw(ModelNode *root);
+	void getBoundingBox(ModelNode *root, int *x1, int *y1, int *x2, int *y2);
+
+private:
+	void update(ModelNode *root);
+	void addNodes(ModelNode *node, int parent);
+
+	ModelNode *_root;
+	uint _hierarchyVersion;
+	Common::Array<ModelNode *> _nodes;
+	Common::Array<int> _parents;
+	Common::Array<Math::Matrix4> _matrices;
+	Common::Array<bool> _visible;
+};
+
 } // end of namespace Grim
 
 #endif
@@ -52,7 +52,9 @@ MODULE_OBJS := \
 	lua/lauxlib.o \
 	lua/lbuffer.o \
 	lua/lbuiltin.o \
+	lua/lcache.o \
 	lua/ldo.o \
+	lua/ldump.o \
 	lua/lfunc.o \
 	lua/lgc.o \
 	lua/liolib.o \
@@ -60,6 +62,7 @@ MODULE_OBJS := \
 	lua/lmathlib.o \
 	lua/lmem.o \
 	lua/lobject.o \
+	lua/lprofiler.o \
 	lua/lrestore.o \
 	lua/lsave.o \
 	lua/lstate.o \
@@ -125,6 +128,8 @@ MODULE_OBJS := \
 	set.o \
 	sector.o \
 	sound.o \
+	soundcache.o \
+	soundindex.o \
 	hotspot.o \
 	sprite.o \
 	stuffit.o \
@@ -57,16 +57,17 @@ void BinkPlayer::deinit() {
 	MoviePlayer::deinit();
 }
 
-void BinkPlayer::handleFrame() {
-	MoviePlayer::handleFrame();
+void BinkPlayer::postHandleFrame() {
+	MoviePlayer::postHandleFrame();
 
 	if (!_showSubtitles || _subtitleIndex == _subtitles.end())
 		return;
 
+	// The decoder runs ahead of the frames shown, see MoviePlayer::decodeAhead()
 	unsigned int startFrame, endFrame, curFrame;
 	startFrame = _subtitleIndex->_startFrame;
 	endFrame = _subtitleIndex->_endFrame;
-	curFrame = _videoDecoder->getCurFrame();
+	curFrame = _frame;
 	if (startFrame <= curFrame && curFrame <= endFrame) {
 		if (!_subtitleIndex->active) {
 			TextObject *textObject = new TextObject();
@@ -50,7 +50,7 @@ private:
 	bool _demo;
 	bool bikCheck(Common::SeekableReadStream *stream, uint32 pos);
 	virtual void deinit() override;
-	virtual void handleFrame() override;
+	virtual void postHandleFrame() override;
 };
 
 } // end of namespace Grim
@@ -20,6 +20,8 @@
  *
  */
 
+#include "common/intrinsics.h"
+
 #include "common/endian.h"
 #include "common/util.h"
 #include "common/textconsole.h"
@@ -85,6 +87,79 @@ namespace Grim {
 
 #endif
 
+#if defined(SCUMM_64BITS) && !defined(SCUMM_NEED_ALIGNMENT)
+
+#define COPY_8X1_LINE(dst, src)			\
+	*(uint64 *)(dst) = *(const uint64 *)(src);
+
+#define WRITE_8X1_LINE(dst, v)		\
+	*(uint64 *)(dst) = v;
+
+#else
+
+#define COPY_8X1_LINE(dst, src)			\
+	do {					\
+		COPY_4X1_LINE((dst) + 0, (src) + 0);	\
+		COPY_4X1_LINE((dst) + 4, (src) + 4);	\
+	} while (0)
+
+#define WRITE_8X1_LINE(dst, v)		\
+	do {				\
+		WRITE_4X1_LINE((dst) + 0, (uint32)(v));	\
+		WRITE_4X1_LINE((dst) + 4, (uint32)(v));	\
+	} while (0)
+
+#endif
+
+bool Blocky16::_wideCopies = true;
+
+// Block rows of 4 pixels. The wide variants move a row at once where the
+// target allows it, the others are the original 32-bit loops.
+template<bool wide>
+static inline void copyLine8(byte *dst, const byte *src) {
+	if (wide) {
+		COPY_8X1_LINE(dst, src);
+	} else {
+		COPY_4X1_LINE(dst + 0, src + 0);
+		COPY_4X1_LINE(dst + 4, src + 4);
+	}
+}
+
+template<bool wide>
+static inline void fillLine8(byte *dst, uint32 t) {
+	if (wide) {
+		WRITE_8X1_LINE(dst, ((uint64)t << 32) | t);
+	} else {
+		WRITE_4X1_LINE(dst + 0, t);
+		WRITE_4X1_LINE(dst + 4, t);
+	}
+}
+
+// Block rows of 8 pixels
+template<bool wide>
+static inline void copyLine16(byte *dst, const byte *src) {
+#ifdef HAVE_SSE2_INTRINSICS
+	if (wide) {
+		_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+		return;
+	}
+#endif
+	copyLine8<wide>(dst + 0, src + 0);
+	copyLine8<wide>(dst + 8, src + 8);
+}
+
+template<bool wide>
+static inline void fillLine16(byte *dst, uint32 t) {
+#ifdef HAVE_SSE2_INTRINSICS
+	if (wide) {
+		_mm_storeu_si128((__m128i *)dst, _mm_set1_epi32((int32)t));
+		return;
+	}
+#endif
+	fillLine8<wide>(dst + 0, t);
+	fillLine8<wide>(dst + 8, t);
+}
+
 static int8 blocky16_table_small1[] = {
 	0, 1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 1, 2, 2, 1,
 };
@@ -427,6 +502,7 @@ void Blocky16::level3(byte *d_dst) {
 	}
 }
 
+template<bool wide>
 void Blocky16::level2(byte *d_dst) {
 	int32 tmp2;
 	uint32 t = 0, val;
@@ -443,8 +519,7 @@ void Blocky16::level2(byte *d_dst) {
 		}
 		tmp2 += _offset1;
 		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
+			copyLine8<wide>(d_dst, d_dst + tmp2);
 			d_dst += _d_pitch;
 		}
 	} else if (code == 0xFF) {
@@ -458,8 +533,7 @@ void Blocky16::level2(byte *d_dst) {
 	} else if (code == 0xF6) {
 		tmp2 = _offset2;
 		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
+			copyLine8<wide>(d_dst, d_dst + tmp2);
 			d_dst += _d_pitch;
 		}
 	} else if ((code == 0xF7) || (code == 0xF8)) {
@@ -501,13 +575,13 @@ void Blocky16::level2(byte *d_dst) {
 			t = (t << 16) | t;
 		}
 		for (i = 0; i < 4; i++) {
-			WRITE_4X1_LINE(d_dst + 0, t);
-			WRITE_4X1_LINE(d_dst + 4, t);
+			fillLine8<wide>(d_dst, t);
 			d_dst += _d_pitch;
 		}
 	}
 }
 
+template<bool wide>
 void Blocky16::level1(byte *d_dst) {
 	int32 tmp2;
 	uint32 t = 0, val;
@@ -524,27 +598,21 @@ void Blocky16::level1(byte *d_dst) {
 		}
 		tmp2 += _offset1;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
-			COPY_4X1_LINE(d_dst +  8, d_dst + tmp2 +  8);
-			COPY_4X1_LINE(d_dst + 12, d_dst + tmp2 + 12);
+			copyLine16<wide>(d_dst, d_dst + tmp2);
 			d_dst += _d_pitch;
 		}
 	} else if (code == 0xFF) {
-		level2(d_dst);
+		level2<wide>(d_dst);
 		d_dst += 8;
-		level2(d_dst);
+		level2<wide>(d_dst);
 		d_dst += _d_pitch * 4 - 8;
-		level2(d_dst);
+		level2<wide>(d_dst);
 		d_dst += 8;
-		level2(d_dst);
+		level2<wide>(d_dst);
 	} else if (code == 0xF6) {
 		tmp2 = _offset2;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
-			COPY_4X1_LINE(d_dst +  8, d_dst + tmp2 +  8);
-			COPY_4X1_LINE(d_dst + 12, d_dst + tmp2 + 12);
+			copyLine16<wide>(d_dst, d_dst + tmp2);
 			d_dst += _d_pitch;
 		}
 	} else if ((code == 0xF7) || (code == 0xF8)) {
@@ -586,10 +654,7 @@ void Blocky16::level1(byte *d_dst) {
 			t = (t << 16) | t;
 		}
 		for (i = 0; i < 8; i++) {
-			WRITE_4X1_LINE(d_dst +  0, t);
-			WRITE_4X1_LINE(d_dst +  4, t);
-			WRITE_4X1_LINE(d_dst +  8, t);
-			WRITE_4X1_LINE(d_dst + 12, t);
+			fillLine16<wide>(d_dst, t);
 			d_dst += _d_pitch;
 		}
 	}
@@ -605,10 +670,17 @@ void Blocky16::decode2(byte *dst, const byte *src, int width, int height, const
 
 	do {
 		int tmp_bw = _blocksWidth;
-		do {
-			level1(dst);
-			dst += 16;
-		} while (--tmp_bw);
+		if (_wideCopies) {
+			do {
+				level1<true>(dst);
+				dst += 16;
+			} while (--tmp_bw);
+		} else {
+			do {
+				level1<false>(dst);
+				dst += 16;
+			} while (--tmp_bw);
+		}
 		dst += next_line;
 	} while (--bh);
 }
@@ -657,6 +729,7 @@ Blocky16::Blocky16() {
 	_offset = _offset1 = _offset2 = 0;
 	_frameSize = 0;
 	_d_pitch = 0;
+	_dirtyTop = _dirtyBottom = 0;
 }
 
 void Blocky16::deinit() {
@@ -771,6 +844,12 @@ void Blocky16::decode(byte *dst, const byte *src) {
 		_prevSeqNb = -1;
 	}
 
+	// Without a destination only the frames kept as reference are decoded
+	if (!dst && (seq_nb != _prevSeqNb + 1 || (src[19] != 1 && src[19] != 2))) {
+		_prevSeqNb = seq_nb;
+		return;
+	}
+
 	switch (src[18]) {
 	case 0:
 #if defined(SCUMM_BIG_ENDIAN)
@@ -825,7 +904,21 @@ void Blocky16::decode(byte *dst, const byte *src) {
 		}
 	}
 
-	memcpy(dst, _curBuf, _frameSize);
+	if (dst) {
+		// Only the rows that changed are copied and reported, so that the
+		// renderers can limit their uploads to them
+		int pitch = _width * 2;
+		_dirtyTop = _height;
+		_dirtyBottom = 0;
+		for (int y = 0; y < _height; y++) {
+			if (memcmp(dst + y * pitch, _curBuf + y * pitch, pitch) != 0) {
+				memcpy(dst + y * pitch, _curBuf + y * pitch, pitch);
+				if (_dirtyTop > y)
+					_dirtyTop = y;
+				_dirtyBottom = y + 1;
+			}
+		}
+	}
 
 	if (seq_nb == _prevSeqNb + 1) {
 		byte *tmp_ptr = nullptr;
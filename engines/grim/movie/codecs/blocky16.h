@@ -45,11 +45,14 @@ private:
 	int _offset;
 	int _width, _height;
 	int _blocksWidth, _blocksHeight;
+	int _dirtyTop, _dirtyBottom;
+
+	static bool _wideCopies;
 
 	void makeTablesInterpolation(int param);
 	void makeTables47(int width);
-	void level1(byte *d_dst);
-	void level2(byte *d_dst);
+	template<bool wide> void level1(byte *d_dst);
+	template<bool wide> void level2(byte *d_dst);
 	void level3(byte *d_dst);
 	void decode2(byte *dst, const byte *src, int width, int height, const byte *param_ptr, const byte *param6_7_ptr);
 
@@ -58,7 +61,14 @@ public:
 	~Blocky16();
 	void init(int width, int height);
 	void deinit();
+	// dst may be null when the frame is skipped, only the delta buffers are updated then
 	void decode(byte *dst, const byte *src);
+	// The rows of dst changed by the last decode, bottom is exclusive
+	void getDirtyRows(int &top, int &bottom) const { top = _dirtyTop; bottom = _dirtyBottom; }
+
+	// Copy and fill whole block rows with 64-bit or SSE2 moves, on by default.
+	// Turning it off gives the original 32-bit loops to compare against.
+	static void setWideCopies(bool wide) { _wideCopies = wide; }
 };
 
 } // end of namespace Grim
@@ -23,7 +23,9 @@
 #include "common/endian.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/md5.h"
 #include "common/rational.h"
+#include "common/savefile.h"
 #include "common/system.h"
 #include "common/timer.h"
 #include "common/memstream.h"
@@ -33,6 +35,7 @@
 #include "audio/decoders/raw.h"
 
 #include "engines/grim/debug.h"
+#include "engines/grim/resource.h"
 
 #include "engines/grim/movie/codecs/blocky8.h"
 #include "engines/grim/movie/codecs/blocky16.h"
@@ -44,8 +47,21 @@ namespace Grim {
 #define ANNO_HEADER "MakeAnim animation type 'Bl16' parameters: "
 #define BUFFER_SIZE 16385
 #define SMUSH_SPEED 66667
+#define INDEX_VERSION 1
+// More indexes than a game has movies
+#define MAX_INDEXFILES 256
+// The first VIMA chunk holds the audio of 50 frames, every later chunk
+// the audio of the frame 50 frames ahead
+#define VIMA_LEAD_FRAMES 50
+#define VIMA_FRAME_SAMPLES 1470
+// Samples the audio queue needs free to take the audio of one more frame
+#define AUDIO_FRAME_ROOM (4 * VIMA_FRAME_SAMPLES * 2)
+// Decoders may read a little past the end of a chunk
+#define AUDIO_PADDING 16
 
 bool SmushDecoder::_demo = false;
+bool SmushDecoder::_indexCache = false;
+int SmushDecoder::_audioLead = 500;
 
 static uint16 smushDestTable[5786];
 
@@ -55,6 +71,12 @@ SmushDecoder::SmushDecoder() {
 	_videoLooping = false;
 	_startPos = 0;
 	_frames = nullptr;
+	_frameBuffer = nullptr;
+	_frameBufferSize = 0;
+	_audioPos = 0;
+	_audioFrame = 0;
+	_audioBuffer = nullptr;
+	_audioBufferSize = 0;
 
 	_videoTrack = nullptr;
 	_audioTrack = nullptr;
@@ -65,17 +87,46 @@ SmushDecoder::~SmushDecoder() {
 	delete _videoTrack;
 	delete _audioTrack;
 	delete[] _frames;
+	delete[] _frameBuffer;
+	delete[] _audioBuffer;
 }
 
 void SmushDecoder::init() {
 	_videoTrack->init();
 	_audioTrack->init();
+	_audioPos = _startPos;
+	_audioFrame = 0;
 }
 
 void SmushDecoder::initFrames() {
 	delete[] _frames;
 	_frames = new Frame[_videoTrack->getFrameCount()];
 
+	// Finding the keyframes means reading through the whole movie, so the
+	// result is kept in the savefile directory for the next time. Indexes of
+	// movies which are gone are dropped once there are too many of them.
+	Common::String indexName;
+	bool loaded = false;
+	if (_indexCache) {
+		indexName = indexFileName();
+		loaded = loadFrameIndex(indexName);
+	}
+	if (!loaded) {
+		scanFrames();
+		if (!indexName.empty()) {
+			saveFrameIndex(indexName);
+		}
+	}
+
+	_keyframes.clear();
+	for (int i = 0; i < _videoTrack->getFrameCount(); ++i) {
+		if (_frames[i].keyframe) {
+			_keyframes.push_back(i);
+		}
+	}
+}
+
+void SmushDecoder::scanFrames() {
 	int seekPos = _file->pos();
 	int curFrame = -1;
 	_file->seek(_startPos, SEEK_SET);
@@ -116,6 +167,74 @@ void SmushDecoder::initFrames() {
 	_file->seek(seekPos, SEEK_SET);
 }
 
+Common::String SmushDecoder::indexFileName() {
+	// The start of the file holds the header and the palette, together with
+	// the size that is enough to tell the movies apart.
+	int seekPos = _file->pos();
+	_file->seek(0, SEEK_SET);
+	Common::String md5 = Common::computeStreamMD5AsString(*_file, 4096);
+	_file->seek(seekPos, SEEK_SET);
+	return Common::String::format("smushidx-%s-%d.idx", md5.c_str(), _file->size());
+}
+
+bool SmushDecoder::loadFrameIndex(const Common::String &fileName) {
+	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(fileName);
+	if (!in) {
+		return false;
+	}
+
+	int32 frameCount = _videoTrack->getFrameCount();
+	bool valid = in->readUint32BE() == MKTAG('S', 'I', 'D', 'X') &&
+	             in->readUint32BE() == INDEX_VERSION &&
+	             in->readSint32BE() == frameCount;
+	for (int32 i = 0; valid && i < frameCount; ++i) {
+		Frame &frame = _frames[i];
+		frame.frame = i;
+		frame.pos = in->readSint32BE();
+		frame.keyframe = in->readByte() != 0;
+		valid = !in->err() && !in->eos() && frame.pos >= (int)_startPos && frame.pos < _file->size();
+	}
+	delete in;
+
+	if (!valid) {
+		Debug::warning(Debug::Movie, "SmushDecoder::loadFrameIndex() Ignoring invalid index %s", fileName.c_str());
+	}
+	return valid;
+}
+
+void SmushDecoder::saveFrameIndex(const Common::String &fileName) {
+	ResourceLoader::pruneCacheFiles("smushidx-*.idx", MAX_INDEXFILES);
+	Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(fileName, false);
+	if (!out) {
+		return;
+	}
+
+	int32 frameCount = _videoTrack->getFrameCount();
+	out->writeUint32BE(MKTAG('S', 'I', 'D', 'X'));
+	out->writeUint32BE(INDEX_VERSION);
+	out->writeSint32BE(frameCount);
+	for (int32 i = 0; i < frameCount; ++i) {
+		out->writeSint32BE(_frames[i].pos);
+		out->writeByte(_frames[i].keyframe);
+	}
+	out->finalize();
+	delete out;
+}
+
+int SmushDecoder::findKeyframe(int frame) const {
+	// Last keyframe not after frame
+	uint lo = 0, hi = _keyframes.size();
+	while (lo < hi) {
+		uint mid = (lo + hi) / 2;
+		if (_keyframes[mid] <= frame) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo > 0 ? _keyframes[lo - 1] : 0;
+}
+
 void SmushDecoder::close() {
 	VideoDecoder::close();
 	_audioTrack = nullptr;
@@ -124,6 +243,7 @@ void SmushDecoder::close() {
 	_startPos = 0;
 	delete[] _frames;
 	_frames = nullptr;
+	_keyframes.clear();
 	if (_file) {
 		delete _file;
 		_file = nullptr;
@@ -296,15 +416,17 @@ void SmushDecoder::handleFrame() {
 		return;
 	}
 
+	// The audio of the next frame is always there, plus the configured lead
+	int32 nextFrame = _videoTrack->getCurFrame() + 1;
+	demuxAudio(nextFrame + (_videoTrack->getFrameRate() * _audioLead / 1000).toInt());
+
 	tag = _file->readUint32BE();
 	size = _file->readUint32BE();
 	if (tag == MKTAG('A', 'N', 'N', 'O')) {
-		char *anno;
-		byte *data;
-
-		data = new byte[size];
-		_file->read(data, size);
-		anno = (char *)data;
+		// One byte more, so that the text is always terminated
+		byte *data = getFrameBuffer(size + 1);
+		data[_file->read(data, size)] = 0;
+		const char *anno = (const char *)data;
 		if (strncmp(anno, ANNO_HEADER, sizeof(ANNO_HEADER) - 1) == 0) {
 			//char *annoData = anno + sizeof(ANNO_HEADER);
 
@@ -323,55 +445,117 @@ void SmushDecoder::handleFrame() {
 		} else {
 			Debug::debug(Debug::Movie, "Announcement header not understood: %s\n", anno);
 		}
-		delete[] anno;
 		tag = _file->readUint32BE();
 		size = _file->readUint32BE();
 	}
 
 	assert(tag == MKTAG('F', 'R', 'M', 'E'));
+	_videoTrack->clearDirtyRect();
 	handleFRME(_file, size);
 
 	_videoTrack->finishFrame();
 }
 
-void SmushDecoder::handleFRME(Common::SeekableReadStream *stream, uint32 size) {
-	int blockSize = size;
+byte *SmushDecoder::getFrameBuffer(uint32 size) {
+	// The buffer only grows, so a playing movie does not allocate after its largest frame
+	if (size > _frameBufferSize) {
+		delete[] _frameBuffer;
+		_frameBuffer = new byte[size];
+		_frameBufferSize = size;
+	}
+	return _frameBuffer;
+}
 
-	byte *block = new byte[size];
+void SmushDecoder::handleFRME(Common::SeekableReadStream *stream, uint32 size) {
+	byte *block = getFrameBuffer(size);
 	stream->read(block, size);
 
-	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(block, size, DisposeAfterUse::NO);
+	// The sub-chunk handlers decode straight out of the frame buffer
+	Common::MemoryReadStream memStream(block, size);
 	while (size > 0) {
-		uint32 subType = memStream->readUint32BE();
-		uint32 subSize = memStream->readUint32BE();
-		uint32 subPos = memStream->pos();
+		uint32 subType = memStream.readUint32BE();
+		uint32 subSize = memStream.readUint32BE();
+		uint32 subPos = memStream.pos();
+		const byte *data = block + subPos;
 
 		switch (subType) {
 			// Retail only:
 		case MKTAG('B', 'l', '1', '6'):
-			_videoTrack->handleBlocky16(memStream, subSize);
+			_videoTrack->handleBlocky16(data, subSize);
 			break;
 		case MKTAG('W', 'a', 'v', 'e'):
-			_audioTrack->handleVIMA(memStream, blockSize);
+			// Audio is handled by demuxAudio()
 			break;
 			// Demo only:
 		case MKTAG('F', 'O', 'B', 'J'):
-			_videoTrack->handleFrameObject(memStream, subSize);
+			_videoTrack->handleFrameObject(data, subSize);
 			break;
 		case MKTAG('I', 'A', 'C', 'T'):
-			_audioTrack->handleIACT(memStream, subSize);
+			// Audio is handled by demuxAudio()
 			break;
 		case MKTAG('X', 'P', 'A', 'L'):
-			_videoTrack->handleDeltaPalette(memStream, subSize);
+			_videoTrack->handleDeltaPalette(&memStream, subSize);
 			break;
 		default:
 			Debug::error(Debug::Movie, "SmushDecoder::handleFrame() unknown tag");
 		}
 		size -= subSize + 8 + (subSize & 1);
-		memStream->seek(subPos + subSize + (subSize & 1), SEEK_SET);
+		memStream.seek(subPos + subSize + (subSize & 1), SEEK_SET);
+	}
+}
+
+void SmushDecoder::demuxAudio(int32 lastFrame) {
+	if (_audioFrame > lastFrame || _audioFrame >= _videoTrack->getFrameCount()) {
+		return;
+	}
+
+	uint32 videoPos = _file->pos();
+	_file->seek(_audioPos, SEEK_SET);
+	while (_audioFrame <= lastFrame && _audioFrame < _videoTrack->getFrameCount()) {
+		// The mixer has not caught up yet, the rest comes on a later frame
+		if (_audioTrack->getFreeSamples() < AUDIO_FRAME_ROOM)
+			break;
+
+		uint32 tag = _file->readUint32BE();
+		uint32 size = _file->readUint32BE();
+		if (tag == MKTAG('A', 'N', 'N', 'O')) {
+			_file->seek(size, SEEK_CUR);
+			tag = _file->readUint32BE();
+			size = _file->readUint32BE();
+		}
+		if (_file->eos() || tag != MKTAG('F', 'R', 'M', 'E')) {
+			Debug::warning(Debug::Movie, "SmushDecoder::demuxAudio() Lost track of the frames at %d", _audioFrame);
+			_audioFrame = _videoTrack->getFrameCount();
+			break;
+		}
+
+		uint32 end = _file->pos() + size;
+		while ((uint32)_file->pos() + 8 <= end) {
+			uint32 subType = _file->readUint32BE();
+			uint32 subSize = _file->readUint32BE();
+			uint32 subPos = _file->pos();
+
+			if (subType == MKTAG('W', 'a', 'v', 'e') || subType == MKTAG('I', 'A', 'C', 'T')) {
+				if (subSize + AUDIO_PADDING > _audioBufferSize) {
+					delete[] _audioBuffer;
+					_audioBufferSize = subSize + AUDIO_PADDING;
+					_audioBuffer = new byte[_audioBufferSize];
+				}
+				uint32 read = _file->read(_audioBuffer, subSize);
+				memset(_audioBuffer + read, 0, AUDIO_PADDING);
+				if (subType == MKTAG('W', 'a', 'v', 'e')) {
+					_audioTrack->handleVIMA(_audioBuffer, read);
+				} else {
+					_audioTrack->handleIACT(_audioBuffer, read);
+				}
+			}
+			_file->seek(subPos + subSize + (subSize & 1), SEEK_SET);
+		}
+		_file->seek(end, SEEK_SET);
+		_audioFrame++;
 	}
-	delete memStream;
-	delete[] block;
+	_audioPos = _file->pos();
+	_file->seek(videoPos, SEEK_SET);
 }
 
 bool SmushDecoder::rewind() {
@@ -394,19 +578,13 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 	}
 
 	// Track down the keyframe
-	int keyframe = 0;
-	for (int i = wantedFrame; i >= 0; --i) {
-		if (_frames[i].keyframe) {
-			keyframe = i;
-			break;
-		}
-	}
+	int keyframe = findKeyframe(wantedFrame);
 	_videoTrack->setFrameStart(keyframe);
 
 	// VIMA frames are 50 frames ahead of time, so we have to make sure we have 50 frames
 	// of audio before the wantedFrame. Here we use 51 to have a bit of safe margin
-	if (wantedFrame - keyframe < 51) {
-		keyframe = wantedFrame - 51;
+	if (wantedFrame - keyframe < VIMA_LEAD_FRAMES + 1) {
+		keyframe = wantedFrame - (VIMA_LEAD_FRAMES + 1);
 	}
 	if (keyframe < 0) {
 		keyframe = 0;
@@ -415,9 +593,11 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 	_file->seek(_frames[keyframe].pos, SEEK_SET);
 	_videoTrack->setCurFrame(keyframe - 1);
 
-	while (_videoTrack->getCurFrame() < wantedFrame - 1) {
-		decodeNextFrame();
-	}
+	// The audio demuxed ahead of the old position is dropped, the queue has
+	// to start at the keyframe for the skipping below to be right
+	_audioTrack->reset();
+	_audioPos = _frames[keyframe].pos;
+	_audioFrame = keyframe;
 
 	// As said, VIMA is 50 frames ahead of time. Every frame it pushes 1470 samples, and 50 * 1470 = 73500.
 	// The first frame, instead of 1470, it pushes 73500 samples to have this 50-frames-time.
@@ -425,12 +605,15 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 	// still have the 50 frames margin. If we have used a later frame as keyframe we don't have the 73500
 	// samples pushed the first frame, so we have to be careful not to remove too much data,
 	// otherwise the audio will start at a later point. (72030 == 73500 - 1470)
-	int offset = (keyframe == 0 ? 0 : 72030);
+	int offset = (keyframe == 0 ? 0 : (VIMA_LEAD_FRAMES - 1) * VIMA_FRAME_SAMPLES);
 
-	// Skip decoded audio between the keyframe and the target frame
+	// Skip decoded audio between the keyframe and the target frame. The frames
+	// up to the one before the target are decoded below, and their audio is
+	// dropped while it gets demuxed.
+	int32 lastFrame = MAX(keyframe, wantedFrame) - 1;
 	Audio::Timestamp delay = 0;
-	if (_videoTrack->getCurFrame() > 0) {
-		delay = _videoTrack->getFrameTime(_videoTrack->getCurFrame());
+	if (lastFrame > 0) {
+		delay = _videoTrack->getFrameTime(lastFrame);
 	}
 	if (keyframe > 0) {
 		delay = delay - _videoTrack->getFrameTime(keyframe);
@@ -439,6 +622,13 @@ bool SmushDecoder::seekIntern(const Audio::Timestamp &time) {
 	int32 sampleCount = (delay.msecs() / 1000.f) * _audioTrack->getRate() - offset;
 	_audioTrack->skipSamples(sampleCount);
 
+	// None of these frames is shown, only the reference buffers have to be right
+	_videoTrack->setSkipDecode(true);
+	while (_videoTrack->getCurFrame() < wantedFrame - 1) {
+		decodeNextFrame();
+	}
+	_videoTrack->setSkipDecode(false);
+
 	VideoDecoder::seekIntern(time);
 	return true;
 }
@@ -469,6 +659,7 @@ SmushDecoder::SmushVideoTrack::SmushVideoTrack(int width, int height, int fps, i
 		_deltaPal[i] = 0;
 	}
 	_frameStart = 0;
+	_skipDecode = false;
 }
 
 SmushDecoder::SmushVideoTrack::~SmushVideoTrack() {
@@ -488,6 +679,7 @@ void SmushDecoder::SmushVideoTrack::init() {
 void SmushDecoder::SmushVideoTrack::finishFrame() {
 	if (!_is16Bit) {
 		convertDemoFrame();
+		_dirtyRect = Common::Rect(_width, _height);
 	}
 	_curFrame++;
 }
@@ -497,59 +689,57 @@ void SmushDecoder::SmushVideoTrack::setFrameStart(int frame) {
 }
 
 void SmushDecoder::SmushVideoTrack::convertDemoFrame() {
-	Graphics::Surface conversion;
-	conversion.create(0, 0, _format); // Avoid issues with copyFrom, by creating an empty surface.
-	conversion.copyFrom(_surface);
-
+	// Blocky8 leaves one index per pixel at the start of the surface. Going
+	// backwards, every 16 bit pixel only overwrites indices already converted.
+	const byte *s = (const byte *)_surface.getPixels();
 	uint16 *d = (uint16 *)_surface.getPixels();
-	for (int l = 0; l < _width * _height; l++) {
-		int index = ((byte *)conversion.getPixels())[l];
+	for (int l = _width * _height - 1; l >= 0; l--) {
+		int index = s[l];
 		d[l] = ((_pal[(index * 3) + 0] & 0xF8) << 8) | ((_pal[(index * 3) + 1] & 0xFC) << 3) | (_pal[(index * 3) + 2] >> 3);
 	}
-	conversion.free();
 }
 
-void SmushDecoder::SmushVideoTrack::handleBlocky16(Common::SeekableReadStream *stream, uint32 size) {
+void SmushDecoder::SmushVideoTrack::handleBlocky16(const byte *data, uint32 size) {
 	if (_curFrame < _frameStart) {
 		return;
 	}
 
 	assert(_is16Bit);
-	byte *ptr = new byte[size];
-	stream->read(ptr, size);
+	if (_skipDecode) {
+		_blocky16->decode(nullptr, data);
+		return;
+	}
+	_blocky16->decode((byte *)_surface.getPixels(), data);
 
-	_blocky16->decode((byte *)_surface.getPixels(), ptr);
-	delete[] ptr;
+	int top, bottom;
+	_blocky16->getDirtyRows(top, bottom);
+	if (top < bottom) {
+		_dirtyRect = Common::Rect(0, top, _width, bottom);
+	}
 }
 
-void SmushDecoder::SmushVideoTrack::handleFrameObject(Common::SeekableReadStream *stream, uint32 size) {
+void SmushDecoder::SmushVideoTrack::handleFrameObject(const byte *data, uint32 size) {
 	if (_curFrame < _frameStart) {
 		return;
 	}
 
 	assert(!_is16Bit);
 	assert(size >= 14);
-	byte codec = stream->readByte();
+	byte codec = data[0];
 	assert(codec == 47);
-	/* byte codecParam = */ stream->readByte();
-	_x = stream->readSint16LE();
-	_y = stream->readSint16LE();
-	uint16 width = stream->readUint16LE();
-	uint16 height = stream->readUint16LE();
+	/* byte codecParam = data[1]; */
+	_x = (int16)READ_LE_UINT16(data + 2);
+	_y = (int16)READ_LE_UINT16(data + 4);
+	uint16 width = READ_LE_UINT16(data + 6);
+	uint16 height = READ_LE_UINT16(data + 8);
 	if (width != _width || height != _height) {
 		_width = width;
 		_height = height;
 		_surface.create(_width, _height, _format);
 		_blocky8->init(_width, _height);
 	}
-	stream->readUint16LE();
-	stream->readUint16LE();
 
-	size -= 14;
-	byte *ptr = new byte[size];
-	stream->read(ptr, size);
-	_blocky8->decode((byte *)_surface.getPixels(), ptr);
-	delete[] ptr;
+	_blocky8->decode((byte *)_surface.getPixels(), data + 14);
 }
 
 static byte delta_color(byte org_color, int16 delta_color) {
@@ -584,12 +774,56 @@ SmushDecoder::SmushAudioTrack::SmushAudioTrack(bool isVima, int freq, int channe
 	_isVima = isVima;
 	_channels = channels;
 	_freq = freq;
-	_queueStream = Audio::makeQueuingAudioStream(_freq, (_channels == 2));
+	_queueStream = makeQueueStream();
 	_IACTpos = 0;
+	_skip = 0;
+	_scratch = nullptr;
+	_scratchSize = 0;
 }
 
 SmushDecoder::SmushAudioTrack::~SmushAudioTrack() {
 	delete _queueStream;
+	delete[] _scratch;
+}
+
+Audio::RingQueuingAudioStream *SmushDecoder::SmushAudioTrack::makeQueueStream() const {
+	// Room for the lead of the VIMA audio and the demuxing lead, with a second to spare
+	int channels = (_channels == 2) ? 2 : 1;
+	uint32 capacity = (VIMA_LEAD_FRAMES * VIMA_FRAME_SAMPLES + _freq * (_audioLead + 1000) / 1000) * channels;
+	return Audio::makeRingQueuingAudioStream(_freq, channels == 2, capacity + AUDIO_FRAME_ROOM);
+}
+
+int16 *SmushDecoder::SmushAudioTrack::getSampleBuffer(uint32 numSamples) {
+	// Straight into the queue, unless the samples wrap around or get skipped
+	uint32 count = numSamples;
+	int16 *dst = _queueStream->reserve(count);
+	if (count == numSamples && _skip == 0)
+		return dst;
+
+	if (numSamples > _scratchSize) {
+		delete[] _scratch;
+		_scratchSize = numSamples;
+		_scratch = new int16[_scratchSize];
+	}
+	return _scratch;
+}
+
+void SmushDecoder::SmushAudioTrack::queueDecoded(int16 *samples, uint32 numSamples) {
+	const bool inQueue = (samples != _scratch);
+	uint32 skip = MIN(_skip, numSamples);
+	_skip -= skip;
+	samples += skip;
+	numSamples -= skip;
+
+	// The codecs write big endian samples
+	for (uint32 i = 0; i < numSamples; i++)
+		samples[i] = (int16)READ_BE_UINT16(samples + i);
+
+	if (inQueue) {
+		_queueStream->commit(numSamples);
+	} else if (_queueStream->queueSamples(samples, numSamples) < numSamples) {
+		Debug::warning(Debug::Movie, "SmushDecoder::SmushAudioTrack: The audio queue is full, dropping samples");
+	}
 }
 
 void SmushDecoder::SmushAudioTrack::init() {
@@ -600,38 +834,31 @@ void SmushDecoder::SmushAudioTrack::init() {
 	}
 }
 
-void SmushDecoder::SmushAudioTrack::handleVIMA(Common::SeekableReadStream *stream, uint32 size) {
-	int decompressedSize = stream->readUint32BE();
-	if (decompressedSize < 0) {
-		stream->readUint32BE();
-		decompressedSize = stream->readUint32BE();
-	}
-
-	byte *src = new byte[size];
-	stream->read(src, size);
-
-	// this will be deleted using free() by the stream, so allocate it using malloc().
-	int16 *dst = (int16 *)malloc(decompressedSize * _channels * 2);
-	decompressVima(src, dst, decompressedSize * _channels * 2, smushDestTable);
+void SmushDecoder::SmushAudioTrack::reset() {
+	// Only called while the mixer is not playing the stream
+	delete _queueStream;
+	_queueStream = makeQueueStream();
+	_IACTpos = 0;
+	_skip = 0;
+}
 
-	int flags = Audio::FLAG_16BITS;
-	if (_channels == 2) {
-		flags |= Audio::FLAG_STEREO;
+void SmushDecoder::SmushAudioTrack::handleVIMA(const byte *data, uint32 size) {
+	int decompressedSize = (int32)READ_BE_UINT32(data);
+	const byte *src = data + 4;
+	if (decompressedSize < 0) {
+		decompressedSize = (int32)READ_BE_UINT32(data + 8);
+		src = data + 12;
 	}
 
-	if (!_queueStream) {
-		_queueStream = Audio::makeQueuingAudioStream(_freq, (_channels == 2));
-	}
-	_queueStream->queueBuffer((byte *)dst, decompressedSize * _channels * 2, DisposeAfterUse::YES, flags);
-	delete[] src;
+	uint32 numSamples = decompressedSize * _channels;
+	int16 *dst = getSampleBuffer(numSamples);
+	decompressVima(src, dst, numSamples * 2, smushDestTable);
+	queueDecoded(dst, numSamples);
 }
 
-void SmushDecoder::SmushAudioTrack::handleIACT(Common::SeekableReadStream *stream, int32 size) {
-	byte *src = new byte[size];
-	stream->read(src, size);
-
+void SmushDecoder::SmushAudioTrack::handleIACT(const byte *data, int32 size) {
 	int32 bsize = size - 18;
-	const byte *d_src = src + 18;
+	const byte *d_src = data + 18;
 
 	while (bsize > 0) {
 		if (_IACTpos >= 2) {
@@ -642,10 +869,9 @@ void SmushDecoder::SmushAudioTrack::handleIACT(Common::SeekableReadStream *strea
 				_IACTpos += bsize;
 				bsize = 0;
 			} else {
-				// this will be deleted using free() by the stream, so allocate it using malloc().
-				byte *output_data = (byte *)malloc(4096);
+				int16 *output_data = getSampleBuffer(2048);
 				memcpy(_IACToutput + _IACTpos, d_src, len);
-				byte *dst = output_data;
+				byte *dst = (byte *)output_data;
 				byte *d_src2 = _IACToutput;
 				d_src2 += 2;
 				int32 count = 1024;
@@ -674,10 +900,7 @@ void SmushDecoder::SmushAudioTrack::handleIACT(Common::SeekableReadStream *strea
 					}
 				} while (--count);
 
-				if (!_queueStream) {
-					_queueStream = Audio::makeQueuingAudioStream(22050, true);
-				}
-				_queueStream->queueBuffer(output_data, 0x1000, DisposeAfterUse::YES, Audio::FLAG_STEREO | Audio::FLAG_16BITS);
+				queueDecoded(output_data, 2048);
 
 				bsize -= len;
 				d_src += len;
@@ -694,7 +917,6 @@ void SmushDecoder::SmushAudioTrack::handleIACT(Common::SeekableReadStream *strea
 			bsize--;
 		}
 	}
-	delete[] src;
 }
 
 bool SmushDecoder::SmushAudioTrack::seek(const Audio::Timestamp &time) {
@@ -708,9 +930,8 @@ void SmushDecoder::SmushAudioTrack::skipSamples(int sampleCount) {
 	if (_queueStream->isStereo())
 		sampleCount *= 2;
 
-	int16 *tempBuffer = new int16[sampleCount];
-	_queueStream->readBuffer(tempBuffer, sampleCount);
-	delete[] tempBuffer;
+	// Dropped as they are demuxed, the queue has no room for all of them
+	_skip = sampleCount;
 }
 
 
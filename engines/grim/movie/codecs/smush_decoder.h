@@ -25,12 +25,16 @@
 
 #include "audio/audiostream.h"
 
+#include "common/array.h"
+#include "common/rect.h"
+#include "common/str.h"
+
 #include "video/video_decoder.h"
 
 #include "graphics/surface.h"
 
 namespace Audio {
-class QueuingAudioStream;
+class RingQueuingAudioStream;
 }
 
 namespace Grim {
@@ -52,12 +56,21 @@ public:
 	bool seekIntern(const Audio::Timestamp &time) override;
 	bool loadStream(Common::SeekableReadStream *stream) override;
 
+	// The part of the frame changed by the last decodeNextFrame()
+	const Common::Rect &getDirtyRect() const { return _videoTrack->getDirtyRect(); }
+
+	static void setIndexCache(bool enable) { _indexCache = enable; }
+	// How far ahead of the video the audio chunks are demuxed and decoded
+	static void setAudioLead(int msecs) { _audioLead = msecs; }
+
 protected:
 	bool readHeader();
 	void handleFrameDemo();
 	void handleFrame();
 	bool handleFramesHeader();
 	void handleFRME(Common::SeekableReadStream *stream, uint32 size);
+	void demuxAudio(int32 lastFrame);
+	byte *getFrameBuffer(uint32 size);
 	void init();
 	void close() override;
 	const Graphics::Surface *decodeNextFrame() override;
@@ -79,9 +92,12 @@ protected:
 		bool isSeekable() const override { return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		void setFrameStart(int frame);
+		void setSkipDecode(bool skip) { _skipDecode = skip; }
+		const Common::Rect &getDirtyRect() const { return _dirtyRect; }
+		void clearDirtyRect() { _dirtyRect = Common::Rect(); }
 
-		void handleBlocky16(Common::SeekableReadStream *stream, uint32 size);
-		void handleFrameObject(Common::SeekableReadStream *stream, uint32 size);
+		void handleBlocky16(const byte *data, uint32 size);
+		void handleFrameObject(const byte *data, uint32 size);
 		void handleDeltaPalette(Common::SeekableReadStream *stream, int32 size);
 		void init();
 		Graphics::Surface *decodeNextFrame() override;
@@ -102,6 +118,8 @@ protected:
 		Blocky16 *_blocky16;
 		int32 _nbframes;
 		int _frameStart;
+		bool _skipDecode;
+		Common::Rect _dirtyRect;
 	};
 
 	class SmushAudioTrack : public AudioTrack {
@@ -114,26 +132,51 @@ protected:
 		bool seek(const Audio::Timestamp &time) override;
 		void skipSamples(int samples);
 		inline int getRate() const { return _queueStream->getRate(); }
+		uint32 getFreeSamples() const { return _queueStream->getFreeSamples(); }
 
-		void handleVIMA(Common::SeekableReadStream *stream, uint32 size);
-		void handleIACT(Common::SeekableReadStream *stream, int32 size);
+		void handleVIMA(const byte *data, uint32 size);
+		void handleIACT(const byte *data, int32 size);
 		void init();
+		void reset();
 	private:
 		bool _isVima;
 		byte _IACToutput[4096];
 		int32 _IACTpos;
 		int _channels;
 		int _freq;
-		Audio::QueuingAudioStream *_queueStream;
+		Audio::RingQueuingAudioStream *_queueStream;
+		uint32 _skip;
+		int16 *_scratch;
+		uint32 _scratchSize;
+
+		Audio::RingQueuingAudioStream *makeQueueStream() const;
+		int16 *getSampleBuffer(uint32 numSamples);
+		void queueDecoded(int16 *samples, uint32 numSamples);
 	};
 private:
 	void initFrames();
+	void scanFrames();
+	Common::String indexFileName();
+	bool loadFrameIndex(const Common::String &fileName);
+	void saveFrameIndex(const Common::String &fileName);
+	int findKeyframe(int frame) const;
 
 	SmushAudioTrack *_audioTrack;
 	SmushVideoTrack *_videoTrack;
 
 	Common::SeekableReadStream *_file;
 
+	// Persistent storage for the FRME and ANNO chunks
+	byte *_frameBuffer;
+	uint32 _frameBufferSize;
+
+	// The audio chunks are read by a second pass over the file, which runs
+	// ahead of the video, so a slow video frame does not starve the mixer
+	uint32 _audioPos;
+	int32 _audioFrame;
+	byte *_audioBuffer;
+	uint32 _audioBufferSize;
+
 	uint32 _startPos;
 
 	bool _videoPause;
@@ -144,7 +187,10 @@ private:
 		bool keyframe;
 	};
 	Frame *_frames;
+	Common::Array<int> _keyframes;
 	static bool _demo;
+	static bool _indexCache;
+	static int _audioLead;
 };
 
 } // end of namespace Grim
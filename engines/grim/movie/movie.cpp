@@ -22,6 +22,8 @@
 
 #include "graphics/surface.h"
 
+#include "common/md5.h"
+#include "common/memstream.h"
 #include "common/system.h"
 #include "common/timer.h"
 
@@ -47,8 +49,14 @@ MoviePlayer::MoviePlayer() {
 	_x = 0;
 	_y = 0;
 	_videoDecoder = nullptr;
-	_internalSurface = nullptr;
 	_externalSurface = new Graphics::Surface();
+	_readySurface = nullptr;
+	_fullyDirty = true;
+	_queueHead = 0;
+	_queueCount = 0;
+	// One for each queued frame, plus the one waiting for getDstSurface
+	for (int i = 0; i < kFrameQueueSize + 1; i++)
+		_freeSurfaces.push_back(new Graphics::Surface());
 	_timerStarted = false;
 }
 
@@ -60,6 +68,8 @@ MoviePlayer::~MoviePlayer() {
 
 	deinit();
 	delete _videoDecoder;
+	for (uint i = 0; i < _freeSurfaces.size(); i++)
+		delete _freeSurfaces[i];
 	delete _externalSurface;
 }
 
@@ -83,7 +93,8 @@ void MoviePlayer::timerCallback(void *instance) {
 }
 
 bool MoviePlayer::prepareFrame() {
-	if (!_videoLooping && _videoDecoder->endOfVideo()) {
+	// The queued frames are still to be shown when the decoder is done
+	if (!_videoLooping && _videoDecoder->endOfVideo() && _queueCount == 0) {
 		_videoFinished = true;
 	}
 
@@ -99,25 +110,127 @@ bool MoviePlayer::prepareFrame() {
 		return false;
 	}
 
-	if (_videoDecoder->getTimeToNextFrame() > 0)
-		return false;
+	// Frames may have become due while the queue was full
+	bool presented = presentFrame();
+	decodeAhead();
+	return presentFrame() || presented;
+}
+
+static void addDirtyRect(Common::Rect &dirty, const Common::Rect &rect) {
+	if (rect.isEmpty())
+		return;
+	if (dirty.isEmpty())
+		dirty = rect;
+	else
+		dirty.extend(rect);
+}
+
+// Like Surface::copyFrom(), without reallocating a surface of the right size
+static void copyFrame(Graphics::Surface *dst, const Graphics::Surface *src) {
+	if (dst->w != src->w || dst->h != src->h || dst->format != src->format || !dst->getPixels())
+		dst->create(src->w, src->h, src->format);
 
-	handleFrame();
-	_internalSurface = _videoDecoder->decodeNextFrame();
-	if (_frame != _videoDecoder->getCurFrame()) {
-		_updateNeeded = true;
+	const byte *srcRow = (const byte *)src->getPixels();
+	byte *dstRow = (byte *)dst->getPixels();
+	if (src->pitch == dst->pitch) {
+		memcpy(dstRow, srcRow, dst->h * dst->pitch);
+		return;
 	}
+	for (int y = 0; y < dst->h; y++) {
+		memcpy(dstRow, srcRow, dst->w * dst->format.bytesPerPixel);
+		srcRow += src->pitch;
+		dstRow += dst->pitch;
+	}
+}
 
-	_movieTime = _videoDecoder->getTime();
-	_frame = _videoDecoder->getCurFrame();
+Common::Rect MoviePlayer::getDecodedDirtyRect(const Graphics::Surface *frame) {
+	return Common::Rect(frame->w, frame->h);
+}
 
-	return true;
+void MoviePlayer::decodeAhead() {
+	while (_queueCount < kFrameQueueSize) {
+		handleFrame();
+		if (_videoFinished || _videoDecoder->endOfVideo())
+			return;
+
+		uint32 time = _videoDecoder->getTime() + _videoDecoder->getTimeToNextFrame();
+		const Graphics::Surface *decoded = _videoDecoder->decodeNextFrame();
+		if (!decoded)
+			return;
+
+		Graphics::Surface *surface;
+		{
+			Common::StackLock lock(_surfaceMutex);
+			surface = _freeSurfaces.back();
+			_freeSurfaces.pop_back();
+		}
+		// The decoder owns its surface, which is only valid until the next frame
+		copyFrame(surface, decoded);
+
+		QueuedFrame &queued = _frameQueue[(_queueHead + _queueCount) % kFrameQueueSize];
+		queued.surface = surface;
+		queued.frame = _videoDecoder->getCurFrame();
+		queued.time = time;
+		// After a flush the frame before is not the one the renderer has
+		queued.dirty = _fullyDirty ? Common::Rect(decoded->w, decoded->h) : getDecodedDirtyRect(decoded);
+		_fullyDirty = false;
+		_queueCount++;
+	}
+}
+
+bool MoviePlayer::presentFrame() {
+	bool presented = false;
+	uint32 time = _videoDecoder->getTime();
+	// When running late, only the newest due frame is shown
+	while (_queueCount > 0 && _frameQueue[_queueHead].time <= time) {
+		QueuedFrame &queued = _frameQueue[_queueHead];
+		{
+			Common::StackLock lock(_surfaceMutex);
+			if (_readySurface) {
+				_freeSurfaces.push_back(_readySurface);
+				addDirtyRect(_readyDirty, queued.dirty);
+			} else {
+				_readyDirty = queued.dirty;
+			}
+			_readySurface = queued.surface;
+		}
+		if (_frame != queued.frame) {
+			_updateNeeded = true;
+		}
+
+		_movieTime = time;
+		_frame = queued.frame;
+
+		_queueHead = (_queueHead + 1) % kFrameQueueSize;
+		_queueCount--;
+		presented = true;
+	}
+	return presented;
+}
+
+void MoviePlayer::flushFrames() {
+	Common::StackLock lock(_surfaceMutex);
+	for (; _queueCount > 0; _queueCount--) {
+		_freeSurfaces.push_back(_frameQueue[_queueHead].surface);
+		_queueHead = (_queueHead + 1) % kFrameQueueSize;
+	}
+	_queueHead = 0;
+	if (_readySurface)
+		_freeSurfaces.push_back(_readySurface);
+	_readySurface = nullptr;
+	_fullyDirty = true;
 }
 
 Graphics::Surface *MoviePlayer::getDstSurface() {
-	Common::StackLock lock(_frameMutex);
-	if (_updateNeeded && _internalSurface) {
-		_externalSurface->copyFrom(*_internalSurface);
+	// Only the surfaces change hands here, the timer callback is not waited for
+	Common::StackLock lock(_surfaceMutex);
+	if (_readySurface) {
+		_freeSurfaces.push_back(_externalSurface);
+		_externalSurface = _readySurface;
+		_externalDirty = _readyDirty;
+		_readySurface = nullptr;
+	} else {
+		_externalDirty = Common::Rect();
 	}
 
 	return _externalSurface;
@@ -141,7 +254,7 @@ void MoviePlayer::deinit() {
 	if (_videoDecoder)
 		_videoDecoder->close();
 
-	_internalSurface = nullptr;
+	flushFrames();
 
 	if (_externalSurface)
 		_externalSurface->free();
@@ -165,7 +278,6 @@ bool MoviePlayer::play(const Common::String &filename, bool looping, int x, int
 	Debug::debug(Debug::Movie, "Playing video '%s'.\n", filename.c_str());
 
 	init();
-	_internalSurface = nullptr;
 
 	if (start) {
 		_videoDecoder->start();
@@ -181,6 +293,44 @@ bool MoviePlayer::loadFile(const Common::String &filename) {
 	return _videoDecoder->loadFile(filename);
 }
 
+bool MoviePlayer::benchmark(const Common::String &filename, uint32 &frames, uint32 &msecs, Common::Array<Common::String> *checksums) {
+	Common::StackLock lock(_frameMutex);
+	// The movie being played, and the engine mode which goes with it, are left alone
+	if (!_videoDecoder || isPlaying())
+		return false;
+
+	deinit();
+	// The players rename _fname while loading, it keeps the name of the last movie
+	Common::String fname = _fname;
+	if (!loadFile(filename)) {
+		_fname = fname;
+		return false;
+	}
+
+	frames = 0;
+	if (checksums)
+		checksums->clear();
+	uint32 hashTime = 0;
+	uint32 startTime = g_system->getMillis();
+	while (!_videoDecoder->endOfVideo()) {
+		const Graphics::Surface *frame = _videoDecoder->decodeNextFrame();
+		if (!frame)
+			break;
+		frames++;
+		if (checksums) {
+			uint32 hashStart = g_system->getMillis();
+			Common::MemoryReadStream pixels((const byte *)frame->getPixels(), frame->pitch * frame->h);
+			checksums->push_back(Common::computeStreamMD5AsString(pixels));
+			hashTime += g_system->getMillis() - hashStart;
+		}
+	}
+	msecs = g_system->getMillis() - startTime - hashTime;
+
+	deinit();
+	_fname = fname;
+	return true;
+}
+
 void MoviePlayer::saveState(SaveGame *state) {
 	Common::StackLock lock(_frameMutex);
 	state->beginSection('SMUS');
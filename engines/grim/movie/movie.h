@@ -23,7 +23,10 @@
 #ifndef GRIM_MOVIE_PLAYER_H
 #define GRIM_MOVIE_PLAYER_H
 
+#include "common/array.h"
 #include "common/mutex.h"
+#include "common/rect.h"
+#include "common/str.h"
 #include "common/system.h"
 
 #include "video/video_decoder.h"
@@ -34,11 +37,32 @@ class SaveGame;
 
 class MoviePlayer {
 protected:
+	/**
+	 * Number of frames decoded ahead of time by the timer callback, so
+	 * that a slow frame does not delay the ones shown before it.
+	 */
+	enum { kFrameQueueSize = 2 };
+
+	struct QueuedFrame {
+		Graphics::Surface *surface;
+		int32 frame;
+		uint32 time;                    //< movie time at which the frame is due
+		Common::Rect dirty;             //< area changed since the frame before
+	};
+
 	Common::String _fname;
-	Common::Mutex _frameMutex;
+	Common::Mutex _frameMutex;              //< Guards the decoder and the player state
+	Common::Mutex _surfaceMutex;            //< Guards the handover of decoded surfaces
 	Video::VideoDecoder *_videoDecoder;     //< Initialize this to your needed subclass of VideoDecoder in the constructor
-	const Graphics::Surface *_internalSurface;
-	Graphics::Surface *_externalSurface;
+	QueuedFrame _frameQueue[kFrameQueueSize];
+	uint _queueHead;
+	uint _queueCount;
+	Common::Array<Graphics::Surface *> _freeSurfaces;
+	Graphics::Surface *_readySurface;       //< The newest due frame, not yet taken by getDstSurface
+	Graphics::Surface *_externalSurface;    //< The frame handed out by getDstSurface
+	Common::Rect _readyDirty;               //< Changes of _readySurface since _externalSurface
+	Common::Rect _externalDirty;            //< Changes of _externalSurface since the one before
+	bool _fullyDirty;                       //< The next decoded frame is entirely new
 	int32 _frame;
 	bool _updateNeeded;
 	bool _showSubtitles;
@@ -73,6 +97,11 @@ public:
 	virtual bool isPlaying() { return !_videoFinished; }
 	virtual bool isUpdateNeeded() { return _updateNeeded; }
 	virtual Graphics::Surface *getDstSurface();
+	/**
+	 * The part of the surface returned by the last getDstSurface call that
+	 * differs from the surface returned by the call before.
+	 */
+	const Common::Rect &getDirtyRect() const { return _externalDirty; }
 	virtual int getX() { return _x; }
 	virtual int getY() { return _y; }
 	virtual int getFrame() { return _frame; }
@@ -86,6 +115,18 @@ public:
 	void saveState(SaveGame *state);
 	void restoreState(SaveGame *state);
 
+	/**
+	 * Decodes a whole movie as fast as possible, without showing it.
+	 * Nothing is done while a movie is playing.
+	 *
+	 * @param filename      the file to decode
+	 * @param frames        set to the number of frames decoded
+	 * @param msecs         set to the time spent decoding
+	 * @param checksums     if not null, filled with the MD5 of every frame
+	 * @return false if a movie is playing or the file could not be loaded
+	 */
+	bool benchmark(const Common::String &filename, uint32 &frames, uint32 &msecs, Common::Array<Common::String> *checksums = nullptr);
+
 protected:
 	static void timerCallback(void *ptr);
 	/**
@@ -121,6 +162,29 @@ protected:
 	 */
 	virtual void postHandleFrame() {};
 
+	/**
+	 * The part of a just decoded frame that changed since the frame before.
+	 * By default the whole frame.
+	 */
+	virtual Common::Rect getDecodedDirtyRect(const Graphics::Surface *frame);
+
+	/**
+	 * Decode frames until the queue is full or the video ends.
+	 */
+	void decodeAhead();
+
+	/**
+	 * Hand the queued frames which are due over to getDstSurface.
+	 *
+	 * @return true if a frame was handed over.
+	 */
+	bool presentFrame();
+
+	/**
+	 * Drop all the queued frames.
+	 */
+	void flushFrames();
+
 	/**
 	 * Initialization of buffers
 	 * This function is called by the default-implementation of play,
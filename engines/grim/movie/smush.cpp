@@ -78,6 +78,10 @@ void SmushPlayer::postHandleFrame() {
 	}
 }
 
+Common::Rect SmushPlayer::getDecodedDirtyRect(const Graphics::Surface *frame) {
+	return _smushDecoder->getDirtyRect();
+}
+
 void SmushPlayer::restore(SaveGame *state) {
 	if (isPlaying()) {
 		_smushDecoder->seek((uint32)_movieTime);
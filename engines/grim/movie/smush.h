@@ -39,6 +39,7 @@ private:
 	bool loadFile(const Common::String &filename) override;
 	void handleFrame() override;
 	void postHandleFrame() override;
+	Common::Rect getDecodedDirtyRect(const Graphics::Surface *frame) override;
 	void init() override;
 	bool _demo;
 	SmushDecoder *_smushDecoder;
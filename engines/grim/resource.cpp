@@ -50,6 +50,8 @@
 #include "common/memstream.h"
 #include "common/file.h"
 #include "common/config-manager.h"
+#include "common/savefile.h"
+#include "common/system.h"
 
 namespace Grim {
 
@@ -335,6 +337,19 @@ Common::String ResourceLoader::fixFilename(const Common::String &filename, bool
 	return fname;
 }
 
+void ResourceLoader::pruneCacheFiles(const Common::String &pattern, uint maxFiles) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	Common::StringArray files = saveFileMan->listSavefiles(pattern);
+	if (files.size() < maxFiles)
+		return;
+
+	// The names are hashes, so this drops an arbitrary set of them
+	uint numRemoved = files.size() - maxFiles * 3 / 4;
+	for (uint i = 0; i < numRemoved; i++) {
+		saveFileMan->removeSavefile(files[i]);
+	}
+}
+
 Costume *ResourceLoader::loadCostume(const Common::String &filename, Actor *owner, Costume *prevCost) {
 	Common::String fname = fixFilename(filename);
 	fname.toLowercase();
@@ -91,6 +91,12 @@ public:
 	};
 
 	static Common::String fixFilename(const Common::String &filename, bool append = true);
+	/**
+	 * Make room for one more of the files matching pattern in the savefile
+	 * directory, where the engine keeps the files it can generate again.
+	 * When there are maxFiles of them already a quarter of them is removed.
+	 */
+	static void pruneCacheFiles(const Common::String &pattern, uint maxFiles);
 
 private:
 	Common::SeekableReadStream *loadFile(const Common::String &filename) const;
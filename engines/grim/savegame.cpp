@@ -22,7 +22,9 @@
 
 #include "common/endian.h"
 #include "common/savefile.h"
+#include "common/substream.h"
 #include "common/system.h"
+#include "common/zlib.h"
 
 #include "math/vector3d.h"
 
@@ -32,11 +34,35 @@
 namespace Grim {
 
 #define SAVEGAME_HEADERTAG  'RSAV'
+#define SAVEGAME_HEADERTAG_DIRECTORY  'RSV2'
 #define SAVEGAME_FOOTERTAG  'ESAV'
 
 uint SaveGame::SAVEGAME_MAJOR_VERSION = 22;
 uint SaveGame::SAVEGAME_MINOR_VERSION = 14;
 
+/**
+ * Passes the (compressed) data of a section on to the savefile and counts
+ * it. Unlike the savefile, it is owned by the compressing stream.
+ */
+class SectionWriteStream : public Common::WriteStream {
+public:
+	SectionWriteStream(Common::WriteStream *parent) : _parent(parent), _size(0) {}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) {
+		uint32 written = _parent->write(dataPtr, dataSize);
+		_size += written;
+		return written;
+	}
+	bool err() const { return _parent->err(); }
+	void clearErr() { _parent->clearErr(); }
+
+	uint32 size() const { return _size; }
+
+private:
+	Common::WriteStream *_parent;
+	uint32 _size;
+};
+
 SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 	Common::InSaveFile *inSaveFile = g_system->getSavefileManager()->openForLoading(filename);
 	if (!inSaveFile) {
@@ -50,20 +76,31 @@ SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 	save->_inSaveFile = inSaveFile;
 
 	uint32 tag = inSaveFile->readUint32BE();
-	if (tag != SAVEGAME_HEADERTAG) {
+	if (tag != SAVEGAME_HEADERTAG && tag != SAVEGAME_HEADERTAG_DIRECTORY) {
 		delete save;
 		return nullptr;
 	}
 	save->_majorVersion = inSaveFile->readUint32BE();
 	save->_minorVersion = inSaveFile->readUint32BE();
 
+	save->_hasDirectory = (tag == SAVEGAME_HEADERTAG_DIRECTORY);
+	if (save->_hasDirectory && !save->readDirectory()) {
+		warning("SaveGame::openForLoading() Savegame file %s is damaged", filename.c_str());
+		delete save;
+		return nullptr;
+	}
+
 	return save;
 }
 
-SaveGame *SaveGame::openForSaving(const Common::String &filename) {
-	Common::OutSaveFile *outSaveFile =  g_system->getSavefileManager()->openForSaving(filename);
+SaveGame *SaveGame::openForSaving(const Common::String &filename, bool snapshot) {
+	// A snapshot is written while the game goes on, so it goes to a temporary
+	// file first and only replaces the savegame once it is complete
+	Common::String outFilename = snapshot ? filename + ".tmp" : filename;
+	// The sections get compressed one by one, not the whole file
+	Common::OutSaveFile *outSaveFile =  g_system->getSavefileManager()->openForSaving(outFilename, false);
 	if (!outSaveFile) {
-		warning("SaveGame::openForSaving() Error creating savegame file %s", filename.c_str());
+		warning("SaveGame::openForSaving() Error creating savegame file %s", outFilename.c_str());
 		return nullptr;
 	}
 
@@ -71,10 +108,15 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 
 	save->_saving = true;
 	save->_outSaveFile = outSaveFile;
+	save->_hasDirectory = true;
+	save->_snapshot = snapshot;
+	save->_filename = filename;
+	save->_outFilename = outFilename;
 
-	outSaveFile->writeUint32BE(SAVEGAME_HEADERTAG);
+	outSaveFile->writeUint32BE(SAVEGAME_HEADERTAG_DIRECTORY);
 	outSaveFile->writeUint32BE(SAVEGAME_MAJOR_VERSION);
 	outSaveFile->writeUint32BE(SAVEGAME_MINOR_VERSION);
+	save->_filePos = 12;
 
 	save->_majorVersion = SAVEGAME_MAJOR_VERSION;
 	save->_minorVersion = SAVEGAME_MINOR_VERSION;
@@ -85,23 +127,107 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 SaveGame::SaveGame() :
 		_currentSection(0), _sectionBuffer(nullptr), _majorVersion(0),
 		_minorVersion(0), _saving(false), _inSaveFile(nullptr), _outSaveFile(nullptr),
-		_sectionSize(0), _sectionAlloc(0), _sectionPtr(0) {
+		_sectionSize(0), _sectionAlloc(0), _sectionPtr(0), _hasDirectory(false),
+		_sectionStream(nullptr), _sectionSink(nullptr), _filePos(0), _snapshot(false),
+		_snapshotSection(0), _snapshotPos(0) {
 
 }
 
 SaveGame::~SaveGame() {
 	if (_saving) {
-		_outSaveFile->writeUint32BE(SAVEGAME_FOOTERTAG);
-		_outSaveFile->finalize();
-		if (_outSaveFile->err())
-			warning("SaveGame::~SaveGame() Can't write file. (Disk full?)");
-		delete _outSaveFile;
+		finishSaving();
 	} else {
 		delete _inSaveFile;
 	}
 	free(_sectionBuffer);
 }
 
+bool SaveGame::finishSaving() {
+	if (!_outSaveFile)
+		return true;
+
+	while (!writeSnapshot(_allocAmmount))
+		;
+
+	// The directory sits at the end, followed by its offset
+	_outSaveFile->writeUint32BE(_sections.size());
+	for (uint i = 0; i < _sections.size(); ++i) {
+		const SectionEntry &entry = _sections[i];
+		_outSaveFile->writeUint32BE(entry.tag);
+		_outSaveFile->writeUint32BE(entry.offset);
+		_outSaveFile->writeUint32BE(entry.storedSize);
+		_outSaveFile->writeUint32BE(entry.size);
+		_outSaveFile->writeByte(entry.compressed);
+	}
+	_outSaveFile->writeUint32BE(_filePos);
+	_outSaveFile->writeUint32BE(SAVEGAME_FOOTERTAG);
+	_outSaveFile->finalize();
+	bool failed = _outSaveFile->err();
+	delete _outSaveFile;
+	_outSaveFile = nullptr;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (failed) {
+		warning("SaveGame::finishSaving() Can't write file. (Disk full?)");
+		// Keep the previous savegame rather than a damaged one
+		if (_outFilename != _filename)
+			saveFileMan->removeSavefile(_outFilename);
+	} else if (_outFilename != _filename) {
+		failed = !saveFileMan->renameSavefile(_outFilename, _filename);
+		if (failed)
+			warning("SaveGame::finishSaving() Can't replace savegame file %s", _filename.c_str());
+	}
+	return !failed;
+}
+
+bool SaveGame::writeSnapshot(uint32 maxBytes) {
+	while (_snapshotSection < _snapshotSections.size()) {
+		SnapshotSection &section = _snapshotSections[_snapshotSection];
+		if (!_sectionStream)
+			startSectionStream();
+
+		uint32 size = MIN(maxBytes, section.size - _snapshotPos);
+		_sectionStream->write(section.data + _snapshotPos, size);
+		_snapshotPos += size;
+		maxBytes -= size;
+		if (_snapshotPos < section.size)
+			return false;
+
+		endSectionStream(section.tag, section.size);
+		free(section.data);
+		section.data = nullptr;
+		_snapshotSection++;
+		_snapshotPos = 0;
+		if (maxBytes == 0)
+			break;
+	}
+	return _snapshotSection == _snapshotSections.size();
+}
+
+bool SaveGame::err() const {
+	return _saving && _outSaveFile && _outSaveFile->err();
+}
+
+bool SaveGame::readDirectory() {
+	if (!_inSaveFile->seek(-8, SEEK_END))
+		return false;
+	uint32 offset = _inSaveFile->readUint32BE();
+	if (_inSaveFile->readUint32BE() != SAVEGAME_FOOTERTAG || !_inSaveFile->seek(offset, SEEK_SET))
+		return false;
+
+	uint32 count = _inSaveFile->readUint32BE();
+	for (uint32 i = 0; i < count && !_inSaveFile->eos(); ++i) {
+		SectionEntry entry;
+		entry.tag = _inSaveFile->readUint32BE();
+		entry.offset = _inSaveFile->readUint32BE();
+		entry.storedSize = _inSaveFile->readUint32BE();
+		entry.size = _inSaveFile->readUint32BE();
+		entry.compressed = _inSaveFile->readByte() != 0;
+		_sections.push_back(entry);
+	}
+	return !_inSaveFile->err() && !_inSaveFile->eos();
+}
+
 bool SaveGame::isCompatible() const {
 	return _majorVersion == SAVEGAME_MAJOR_VERSION && _minorVersion <= SAVEGAME_MINOR_VERSION;
 }
@@ -121,7 +247,39 @@ uint32 SaveGame::beginSection(uint32 sectionTag) {
 		error("Tried to begin a new save game section with ending old section");
 	_currentSection = sectionTag;
 	_sectionSize = 0;
-	if (!_saving) {
+	if (!_saving && _hasDirectory) {
+		const SectionEntry *entry = nullptr;
+		for (uint i = 0; i < _sections.size() && !entry; ++i) {
+			if (_sections[i].tag == sectionTag)
+				entry = &_sections[i];
+		}
+		if (!entry)
+			error("Unable to find requested section of savegame");
+
+		_sectionSize = entry->size;
+		if (!_sectionBuffer || _sectionAlloc < _sectionSize) {
+			_sectionAlloc = _sectionSize;
+			byte *buff = (byte *)realloc(_sectionBuffer, _sectionAlloc);
+			if (buff == nullptr) {
+				free(_sectionBuffer);
+				error("Could not allocate memory for save game");
+			}
+			_sectionBuffer = buff;
+		}
+
+		uint32 read;
+		if (entry->compressed) {
+			Common::SeekableReadStream *stream = new Common::SeekableSubReadStream(_inSaveFile, entry->offset, entry->offset + entry->storedSize);
+			stream = Common::wrapCompressedReadStream(stream, _sectionSize);
+			read = stream ? stream->read(_sectionBuffer, _sectionSize) : 0;
+			delete stream;
+		} else {
+			_inSaveFile->seek(entry->offset, SEEK_SET);
+			read = _inSaveFile->read(_sectionBuffer, _sectionSize);
+		}
+		if (read != _sectionSize)
+			error("Unable to read section of savegame");
+	} else if (!_saving) {
 		uint32 tag = 0;
 
 		while (tag != sectionTag) {
@@ -149,18 +307,60 @@ uint32 SaveGame::beginSection(uint32 sectionTag) {
 			_sectionAlloc = _allocAmmount;
 			_sectionBuffer = (byte *)malloc(_sectionAlloc);
 		}
+		if (!_snapshot)
+			startSectionStream();
 	}
 	_sectionPtr = 0;
 	return _sectionSize;
 }
 
+void SaveGame::startSectionStream() {
+	_sectionSink = new SectionWriteStream(_outSaveFile);
+	_sectionStream = Common::wrapCompressedWriteStream(_sectionSink);
+}
+
+void SaveGame::endSectionStream(uint32 tag, uint32 size) {
+	_sectionStream->finalize();
+
+	SectionEntry entry;
+	entry.tag = tag;
+	entry.offset = _filePos;
+	entry.storedSize = _sectionSink->size();
+	entry.size = size;
+	entry.compressed = (_sectionStream != _sectionSink);
+	_sections.push_back(entry);
+	_filePos += entry.storedSize;
+
+	// Deletes the sink too, when wrapped
+	delete _sectionStream;
+	_sectionStream = nullptr;
+	_sectionSink = nullptr;
+}
+
+/**
+ * Pass the buffered data of the section being written on to the compressor.
+ */
+void SaveGame::flushSection() {
+	if (_sectionPtr > 0)
+		_sectionStream->write(_sectionBuffer, _sectionPtr);
+	_sectionPtr = 0;
+}
+
 void SaveGame::endSection() {
 	if (_currentSection == 0)
 		error("Tried to end a save game section without starting a section");
-	if (_saving) {
-		_outSaveFile->writeUint32BE(_currentSection);
-		_outSaveFile->writeUint32BE(_sectionSize);
-		_outSaveFile->write(_sectionBuffer, _sectionSize);
+	if (_saving && _snapshot) {
+		// The buffer now belongs to the snapshot
+		SnapshotSection section;
+		section.tag = _currentSection;
+		section.size = _sectionSize;
+		section.data = _sectionBuffer;
+		_snapshotSections.push_back(section);
+		_sectionBuffer = nullptr;
+		_sectionAlloc = 0;
+	} else if (_saving) {
+		flushSection();
+		endSectionStream(_currentSection, _sectionSize);
 	}
 	_currentSection = 0;
 }
@@ -219,13 +419,18 @@ bool SaveGame::readBool() {
 }
 
 void SaveGame::checkAlloc(int size) {
-	if (_sectionSize + size > _sectionAlloc) {
-		while (_sectionSize + size > _sectionAlloc)
-			_sectionAlloc += _allocAmmount;
-		_sectionBuffer = (byte *)realloc(_sectionBuffer, _sectionAlloc);
-		if (!_sectionBuffer)
-			error("Failed to allocate space for buffer");
+	if (_sectionPtr + size <= _sectionAlloc)
+		return;
+	if (!_snapshot) {
+		flushSection();
+		return;
 	}
+	// A snapshot keeps the whole section
+	while (_sectionPtr + size > _sectionAlloc)
+		_sectionAlloc *= 2;
+	_sectionBuffer = (byte *)realloc(_sectionBuffer, _sectionAlloc);
+	if (!_sectionBuffer)
+		error("Failed to allocate space for buffer");
 }
 
 void SaveGame::write(const void *data, int size) {
@@ -236,7 +441,13 @@ void SaveGame::write(const void *data, int size) {
 
 	checkAlloc(size);
 
-	memcpy(&_sectionBuffer[_sectionSize], data, size);
+	// Blocks larger than the buffer go straight to the compressor
+	if ((uint32)size > _sectionAlloc) {
+		_sectionStream->write(data, size);
+	} else {
+		memcpy(&_sectionBuffer[_sectionPtr], data, size);
+		_sectionPtr += size;
+	}
 	_sectionSize += size;
 }
 
@@ -248,7 +459,8 @@ void SaveGame::writeLEUint32(uint32 data) {
 
 	checkAlloc(4);
 
-	WRITE_LE_UINT32(&_sectionBuffer[_sectionSize], data);
+	WRITE_LE_UINT32(&_sectionBuffer[_sectionPtr], data);
+	_sectionPtr += 4;
 	_sectionSize += 4;
 }
 
@@ -260,7 +472,8 @@ void SaveGame::writeLEUint16(uint16 data) {
 
 	checkAlloc(2);
 
-	WRITE_LE_UINT16(&_sectionBuffer[_sectionSize], data);
+	WRITE_LE_UINT16(&_sectionBuffer[_sectionPtr], data);
+	_sectionPtr += 2;
 	_sectionSize += 2;
 }
 
@@ -272,7 +485,8 @@ void SaveGame::writeLESint32(int32 data) {
 
 	checkAlloc(4);
 
-	WRITE_LE_UINT32(&_sectionBuffer[_sectionSize], (uint32)data);
+	WRITE_LE_UINT32(&_sectionBuffer[_sectionPtr], (uint32)data);
+	_sectionPtr += 4;
 	_sectionSize += 4;
 }
 
@@ -288,7 +502,8 @@ void SaveGame::writeByte(byte data) {
 
 	checkAlloc(1);
 
-	_sectionBuffer[_sectionSize] = data;
+	_sectionBuffer[_sectionPtr] = data;
+	_sectionPtr++;
 	_sectionSize++;
 }
 
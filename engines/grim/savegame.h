@@ -23,6 +23,9 @@
 #ifndef GRIM_SAVEGAME_H
 #define GRIM_SAVEGAME_H
 
+#include "common/array.h"
+#include "common/str.h"
+
 #include "math/mathfwd.h"
 
 namespace Common {
@@ -36,11 +39,16 @@ class String;
 namespace Grim {
 
 class Color;
+class SectionWriteStream;
 
 class SaveGame {
 public:
 	static SaveGame *openForLoading(const Common::String &filename);
-	static SaveGame *openForSaving(const Common::String &filename);
+	/**
+	 * With snapshot set, the sections are kept in memory when they end, and
+	 * only compressed and written by writeSnapshot() or on deletion.
+	 */
+	static SaveGame *openForSaving(const Common::String &filename, bool snapshot = false);
 	~SaveGame();
 
 	/**
@@ -87,21 +95,71 @@ public:
 
 	void checkAlloc(int size);
 
+	/**
+	 * Write about maxBytes of the snapshot to the savefile.
+	 * Returns true once all the sections ended so far are written.
+	 */
+	bool writeSnapshot(uint32 maxBytes);
+	/**
+	 * Write the rest of the savegame and close the file, which is also done
+	 * on deletion. Returns false if the savegame could not be written.
+	 */
+	bool finishSaving();
+	bool err() const;
+
 protected:
 	SaveGame();
 
+	bool readDirectory();
+	void flushSection();
+	void startSectionStream();
+	void endSectionStream(uint32 tag, uint32 size);
+
+	/**
+	 * A section of a savegame with a directory. The sections are compressed
+	 * separately, so that any of them can be read without touching the others.
+	 */
+	struct SectionEntry {
+		uint32 tag;
+		uint32 offset;
+		uint32 storedSize;
+		uint32 size;
+		bool compressed;
+	};
+
+	struct SnapshotSection {
+		uint32 tag;
+		uint32 size;
+		byte *data;
+	};
+
 	uint _majorVersion;
 	uint _minorVersion;
 	bool _saving;
 	Common::InSaveFile *_inSaveFile;
 	Common::OutSaveFile *_outSaveFile;
+	Common::String _filename;
+	// The file being written, which is renamed to _filename when finished
+	Common::String _outFilename;
 	uint32 _currentSection;
 	uint32 _sectionSize;
 	uint32 _sectionAlloc;
 	uint32 _sectionPtr;
 	byte *_sectionBuffer;
 
-	static const int _allocAmmount = 1048576;
+	bool _hasDirectory;
+	Common::Array<SectionEntry> _sections;
+	Common::WriteStream *_sectionStream;
+	SectionWriteStream *_sectionSink;
+	uint32 _filePos;
+
+	bool _snapshot;
+	Common::Array<SnapshotSection> _snapshotSections;
+	uint32 _snapshotSection;
+	uint32 _snapshotPos;
+
+	// Size of the buffer collecting the data of the section being written
+	static const int _allocAmmount = 65536;
 };
 
 } // end of namespace Grim
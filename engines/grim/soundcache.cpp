@@ -0,0 +1,178 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+
+#include "engines/grim/debug.h"
+#include "engines/grim/soundcache.h"
+
+namespace Grim {
+
+SoundCache *g_soundCache = nullptr;
+
+/**
+ * A raw stream over the data of a cache entry, which keeps the entry
+ * alive until the stream is deleted.
+ */
+class CachedSoundStream : public Audio::SeekableAudioStream {
+public:
+	CachedSoundStream(SoundCache::Entry *entry) : _entry(entry) {
+		_stream = Audio::makeRawStream(entry->getData(), entry->getSize(), entry->getRate(), entry->getFlags(), DisposeAfterUse::NO);
+	}
+	~CachedSoundStream() {
+		delete _stream;
+		_entry->release();
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) override { return _stream->readBuffer(buffer, numSamples); }
+	bool isStereo() const override { return _stream->isStereo(); }
+	int getRate() const override { return _stream->getRate(); }
+	bool endOfData() const override { return _stream->endOfData(); }
+	bool seek(const Audio::Timestamp &where) override { return _stream->seek(where); }
+	Audio::Timestamp getLength() const override { return _stream->getLength(); }
+
+private:
+	SoundCache::Entry *_entry;
+	Audio::SeekableAudioStream *_stream;
+};
+
+SoundCache::Entry::Entry(const Common::String &name, uint32 size, uint32 headerSize, int rate, byte flags) :
+		_name(name), _size(size), _headerSize(headerSize), _rate(rate), _flags(flags), _refCount(1) {
+	_data = new byte[size];
+	_header = headerSize ? new byte[headerSize] : nullptr;
+}
+
+SoundCache::Entry::~Entry() {
+	delete[] _data;
+	delete[] _header;
+}
+
+void SoundCache::Entry::acquire() {
+	uint32 count;
+	do {
+		count = _refCount.load();
+	} while (!_refCount.compareExchange(count, count + 1));
+}
+
+void SoundCache::Entry::release() {
+	uint32 count;
+	do {
+		count = _refCount.load();
+	} while (!_refCount.compareExchange(count, count - 1));
+	if (count == 1)
+		delete this;
+}
+
+SoundCache::SoundCache(uint32 budget, uint32 maxSoundSize) :
+		_budget(budget), _maxSoundSize(MIN(maxSoundSize, budget)), _memorySize(0), _hits(0), _misses(0) {
+}
+
+SoundCache::~SoundCache() {
+	flush();
+}
+
+SoundCache::Entry *SoundCache::find(const Common::String &name) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator i = _entries.find(name);
+	if (i == _entries.end()) {
+		_misses++;
+		return nullptr;
+	}
+
+	Entry *entry = i->_value;
+	_lru.erase(entry->_lru);
+	_lru.push_front(entry);
+	entry->_lru = _lru.begin();
+	entry->acquire();
+	_hits++;
+	return entry;
+}
+
+SoundCache::Entry *SoundCache::create(const Common::String &name, uint32 size, uint32 headerSize, int rate, byte flags) {
+	assert(isCacheable(size));
+	return new Entry(name, size, headerSize, rate, flags);
+}
+
+SoundCache::Entry *SoundCache::insert(Entry *entry) {
+	Common::StackLock lock(_mutex);
+
+	// Another user may have cached the same sound in the meantime
+	EntryMap::iterator i = _entries.find(entry->_name);
+	if (i != _entries.end()) {
+		Entry *cached = i->_value;
+		cached->acquire();
+		entry->release();
+		return cached;
+	}
+
+	while (!_lru.empty() && _memorySize + entry->_size > _budget)
+		evict(_lru.back());
+
+	entry->acquire();
+	_lru.push_front(entry);
+	entry->_lru = _lru.begin();
+	_entries[entry->_name] = entry;
+	_memorySize += entry->_size;
+	Debug::debug(Debug::Sound, "SoundCache: cached %s, %d bytes in %d sounds", entry->_name.c_str(), _memorySize, _entries.size());
+	return entry;
+}
+
+Audio::SeekableAudioStream *SoundCache::makeStream(Entry *entry) {
+	return new CachedSoundStream(entry);
+}
+
+void SoundCache::evict(Entry *entry) {
+	_entries.erase(entry->_name);
+	_lru.erase(entry->_lru);
+	_memorySize -= entry->_size;
+	// Sounds which are still playing keep the data until they are done
+	entry->release();
+}
+
+void SoundCache::flush() {
+	Common::StackLock lock(_mutex);
+
+	while (!_lru.empty())
+		evict(_lru.back());
+}
+
+SoundCache::Stats SoundCache::getStats() {
+	Common::StackLock lock(_mutex);
+
+	Stats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.memorySize = _memorySize;
+	stats.numEntries = _entries.size();
+	return stats;
+}
+
+void SoundCache::resetStats() {
+	Common::StackLock lock(_mutex);
+
+	_hits = 0;
+	_misses = 0;
+}
+
+} // end of namespace Grim
@@ -0,0 +1,165 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRIM_SOUNDCACHE_H
+#define GRIM_SOUNDCACHE_H
+
+#include "common/atomic.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+namespace Audio {
+class SeekableAudioStream;
+}
+
+namespace Grim {
+
+/**
+ * Fully decoded PCM of short sounds, so that sound effects which are
+ * played over and over are neither read nor decoded again.
+ *
+ * The cache is shared by iMuse and the EMI sound tracks and is keyed by
+ * the file name. Sounds larger than the size limit are never cached and
+ * the least recently used sounds are dropped when the cache grows over
+ * its budget.
+ */
+class SoundCache {
+public:
+	enum {
+		kDefaultBudget = 4 * 1024 * 1024,
+		kDefaultMaxSoundSize = 256 * 1024
+	};
+
+	/**
+	 * A decoded sound. Entries are reference counted: the cache holds one
+	 * reference for as long as the entry is cached, and every user of the
+	 * data holds another one. Releasing does not lock, so streams which
+	 * the mixer callback deletes can hold a reference too.
+	 */
+	class Entry {
+	public:
+		const Common::String &getName() const { return _name; }
+		const byte *getData() const { return _data; }
+		uint32 getSize() const { return _size; }
+		/** What the owner needs to interpret the data, for instance a file header. */
+		const byte *getHeader() const { return _header; }
+		uint32 getHeaderSize() const { return _headerSize; }
+		int getRate() const { return _rate; }
+		/** The Audio::RawFlags of the data, if it is played as a raw stream. */
+		byte getFlags() const { return _flags; }
+
+		void acquire();
+		void release();
+
+	private:
+		friend class SoundCache;
+
+		Entry(const Common::String &name, uint32 size, uint32 headerSize, int rate, byte flags);
+		~Entry();
+
+		Common::String _name;
+		byte *_data;
+		uint32 _size;
+		byte *_header;
+		uint32 _headerSize;
+		int _rate;
+		byte _flags;
+		Common::Atomic<uint32> _refCount;
+		Common::List<Entry *>::iterator _lru;
+	};
+
+	SoundCache(uint32 budget = kDefaultBudget, uint32 maxSoundSize = kDefaultMaxSoundSize);
+	~SoundCache();
+
+	/**
+	 * Whether a sound of the given decoded size may be cached.
+	 */
+	bool isCacheable(uint32 size) const { return size <= _maxSoundSize; }
+
+	/**
+	 * Look up a sound and mark it as the most recently used one.
+	 *
+	 * @return the entry with a reference held for the caller, or nullptr
+	 */
+	Entry *find(const Common::String &name);
+
+	/**
+	 * Create an entry for a sound which was not found. The caller fills
+	 * the data and the header and then hands the entry to insert().
+	 */
+	Entry *create(const Common::String &name, uint32 size, uint32 headerSize = 0, int rate = 0, byte flags = 0);
+	byte *getData(Entry *entry) { return entry->_data; }
+	byte *getHeader(Entry *entry) { return entry->_header; }
+
+	/**
+	 * Cache a filled entry, dropping older sounds if the budget is
+	 * exceeded. If the sound was cached in the meantime, the cached entry
+	 * is kept and the one passed in is released.
+	 *
+	 * @return the cached entry, with the reference of the caller
+	 */
+	Entry *insert(Entry *entry);
+
+	/**
+	 * Create a stream playing the data of an entry as raw PCM, without
+	 * copying it. The stream takes over the reference of the caller.
+	 */
+	static Audio::SeekableAudioStream *makeStream(Entry *entry);
+
+	void flush();
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 memorySize;
+		uint numEntries;
+	};
+
+	/** The counters and the size of the cache, taken together. */
+	Stats getStats();
+	uint32 getBudget() const { return _budget; }
+	void resetStats();
+
+private:
+	typedef Common::HashMap<Common::String, Entry *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> EntryMap;
+
+	void evict(Entry *entry);
+
+	EntryMap _entries;
+	// Most recently used first
+	Common::List<Entry *> _lru;
+	uint32 _budget;
+	uint32 _maxSoundSize;
+	uint32 _memorySize;
+	uint32 _hits;
+	uint32 _misses;
+	Common::Mutex _mutex;
+};
+
+extern SoundCache *g_soundCache;
+
+} // end of namespace Grim
+
+#endif
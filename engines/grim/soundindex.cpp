@@ -0,0 +1,78 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/hash-str.h"
+
+#include "engines/grim/soundindex.h"
+
+namespace Grim {
+
+SoundNameIndex::SoundNameIndex(int numSlots) : _numSlots(numSlots) {
+	_next = new int[numSlots];
+	_slotBucket = new int[numSlots];
+	clear();
+}
+
+SoundNameIndex::~SoundNameIndex() {
+	delete[] _next;
+	delete[] _slotBucket;
+}
+
+void SoundNameIndex::clear() {
+	for (int i = 0; i < kNumBuckets; i++) {
+		_bucket[i] = -1;
+	}
+	for (int i = 0; i < _numSlots; i++) {
+		_next[i] = -1;
+		_slotBucket[i] = -1;
+	}
+}
+
+int SoundNameIndex::getBucket(const char *name) const {
+	return Common::hashit_lower(name) % kNumBuckets;
+}
+
+void SoundNameIndex::insert(int slot, const char *name) {
+	assert(slot >= 0 && slot < _numSlots);
+	remove(slot);
+
+	int bucket = getBucket(name);
+	_next[slot] = _bucket[bucket];
+	_bucket[bucket] = slot;
+	_slotBucket[slot] = bucket;
+}
+
+void SoundNameIndex::remove(int slot) {
+	assert(slot >= 0 && slot < _numSlots);
+	int bucket = _slotBucket[slot];
+	if (bucket == -1)
+		return;
+
+	int *link = &_bucket[bucket];
+	while (*link != slot)
+		link = &_next[*link];
+	*link = _next[slot];
+	_next[slot] = -1;
+	_slotBucket[slot] = -1;
+}
+
+} // end of namespace Grim
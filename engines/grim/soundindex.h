@@ -0,0 +1,69 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRIM_SOUNDINDEX_H
+#define GRIM_SOUNDINDEX_H
+
+#include "common/scummsys.h"
+
+namespace Grim {
+
+/**
+ * Finds the slots of a fixed set of sound tracks by their case insensitive
+ * name, without allocating.
+ *
+ * The index only narrows the search: a slot stays in the bucket of the
+ * name it was inserted with until it is inserted again or removed, so the
+ * owner still checks the name and state of every slot it visits.
+ */
+class SoundNameIndex {
+public:
+	SoundNameIndex(int numSlots);
+	~SoundNameIndex();
+
+	void clear();
+	/** Index a slot under a new name. */
+	void insert(int slot, const char *name);
+	void remove(int slot);
+
+	/**
+	 * The slots which may have the given name:
+	 * for (int i = index.first(name); i != -1; i = index.next(i))
+	 */
+	int first(const char *name) const { return _bucket[getBucket(name)]; }
+	int next(int slot) const { return _next[slot]; }
+
+private:
+	enum { kNumBuckets = 32 };
+
+	int getBucket(const char *name) const;
+
+	int _bucket[kNumBuckets];
+	int *_next;
+	// The bucket a slot is linked into, or -1
+	int *_slotBucket;
+	int _numSlots;
+};
+
+} // end of namespace Grim
+
+#endif
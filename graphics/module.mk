@@ -19,6 +19,7 @@ MODULE_OBJS := \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
 	wincursor.o \
+	yuv_simd.o \
 	yuv_to_rgb.o \
 	yuva_to_rgba.o \
 	pixelbuffer.o \
@@ -44,6 +45,7 @@ MODULE_OBJS := \
 	tinygl/specbuf.o \
 	tinygl/texture.o \
 	tinygl/vertex.o \
+	tinygl/vertexcache.o \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
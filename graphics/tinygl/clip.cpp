@@ -14,13 +14,20 @@ namespace TinyGL {
 #define CLIP_ZMAX   (1 << 5)
 
 void gl_transform_to_viewport(GLContext *c, GLVertex *v) {
+	gl_transform_coords_to_viewport(c, v);
+	gl_transform_colors_to_viewport(c, v);
+}
+
+void gl_transform_coords_to_viewport(GLContext *c, GLVertex *v) {
 	float winv;
 
-	// coordinates
 	winv = (float)(1.0 / v->pc.W);
 	v->zp.x = (int)(v->pc.X * winv * c->viewport.scale.X + c->viewport.trans.X);
 	v->zp.y = (int)(v->pc.Y * winv * c->viewport.scale.Y + c->viewport.trans.Y);
 	v->zp.z = (int)(v->pc.Z * winv * c->viewport.scale.Z + c->viewport.trans.Z);
+}
+
+void gl_transform_colors_to_viewport(GLContext *c, GLVertex *v) {
 	// color
 	if (c->lighting_enabled) {
 		v->zp.r = (int)(v->color.X * (ZB_POINT_RED_MAX - ZB_POINT_RED_MIN)
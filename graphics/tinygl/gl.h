@@ -795,6 +795,18 @@ void tglColorMask(TGLboolean r, TGLboolean g, TGLboolean b, TGLboolean a);
 void tglSetShadowMaskBuf(unsigned char *buf);
 void tglSetShadowColor(unsigned char r, unsigned char g, unsigned char b);
 
+// vertex caches: the vertices and normals of a mesh, which must not change,
+// are transformed and lit once and reused by the polygons drawn from them
+// until the matrices, the viewport or the lights change
+namespace TinyGL {
+struct GLVertexCache;
+}
+
+TinyGL::GLVertexCache *tglGenVertexCache(int count, const float *vertices, const float *normals);
+void tglDeleteVertexCache(TinyGL::GLVertexCache *cache);
+// texCoords can be NULL to use the current texture coordinate
+void tglDrawCachedPolygon(TinyGL::GLVertexCache *cache, int count, const int *indices, const float *texCoords, const int *texIndices);
+
 // opengl 1.2 arrays
 void tglEnableClientState(TGLenum array);
 void tglDisableClientState(TGLenum array);
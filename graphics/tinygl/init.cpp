@@ -80,6 +80,7 @@ void glInit(void *zbuffer1) {
 	c->local_light_model = 0;
 	c->lighting_enabled = 0;
 	c->light_model_two_side = 0;
+	c->light_version = 0;
 
 	// default materials */
 	for (int i = 0; i < 2; i++) {
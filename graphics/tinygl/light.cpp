@@ -19,6 +19,9 @@ void glopMaterial(GLContext *c, GLParam *p) {
 	else
 		m = &c->materials[1];
 
+	GLMaterial old;
+	memcpy(&old, m, sizeof(GLMaterial));
+
 	switch (type) {
 	case TGL_EMISSION:
 		m->emission = v;
@@ -43,6 +46,9 @@ void glopMaterial(GLContext *c, GLParam *p) {
 	default:
 		assert(0);
 	}
+
+	if (memcmp(&old, m, sizeof(GLMaterial)) != 0)
+		c->light_version++;
 }
 
 void glopColorMaterial(GLContext *c, GLParam *p) {
@@ -63,6 +69,11 @@ void glopLight(GLContext *c, GLParam *p) {
 
 	l = &c->lights[light - TGL_LIGHT0];
 
+	// The lights are usually set up again with the same values for every
+	// frame, which must not make the vertex caches light their vertices again
+	GLLight old;
+	memcpy(&old, l, sizeof(GLLight));
+
 	switch (type) {
 	case TGL_AMBIENT:
 		l->ambient = v;
@@ -117,25 +128,37 @@ void glopLight(GLContext *c, GLParam *p) {
 	default:
 		assert(0);
 	}
+
+	if (memcmp(&old, l, sizeof(GLLight)) != 0)
+		c->light_version++;
 }
 
 void glopLightModel(GLContext *c, GLParam *p) {
 	int pname = p[1].i;
+	bool changed = false;
 
 	switch (pname) {
-	case TGL_LIGHT_MODEL_AMBIENT:
-		c->ambient_light_model = Vector4(p[2].f, p[3].f, p[4].f, p[5].f);
-		break;
+	case TGL_LIGHT_MODEL_AMBIENT: {
+		Vector4 ambient(p[2].f, p[3].f, p[4].f, p[5].f);
+		changed = c->ambient_light_model != ambient;
+		c->ambient_light_model = ambient;
+	}
+	break;
 	case TGL_LIGHT_MODEL_LOCAL_VIEWER:
+		changed = c->local_light_model != (int)p[2].f;
 		c->local_light_model = (int)p[2].f;
 		break;
 	case TGL_LIGHT_MODEL_TWO_SIDE:
+		changed = c->light_model_two_side != (int)p[2].f;
 		c->light_model_two_side = (int)p[2].f;
 		break;
 	default:
 		warning("glopLightModel: illegal pname: 0x%x", pname);
 		break;
 	}
+
+	if (changed)
+		c->light_version++;
 }
 
 
@@ -167,7 +190,10 @@ void gl_enable_disable_light(GLContext *c, int light, int v) {
 			l->prev->next = l->next;
 		if (l->next)
 			l->next->prev = l->prev;
+	} else {
+		return;
 	}
+	c->light_version++;
 }
 
 // non optimized lightening model
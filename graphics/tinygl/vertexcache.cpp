@@ -0,0 +1,185 @@
+
+#include "graphics/tinygl/zgl.h"
+
+namespace TinyGL {
+
+// A vertex cache keeps the vertices of a mesh transformed for as long as the
+// matrices and the viewport do not change, and lit for as long as the lights
+// do not change either. The polygons of the mesh index into the cache, so
+// every vertex is transformed and lit once, however many polygons share it.
+
+static bool gl_light_equal(const GLLight *a, const GLLight *b) {
+	return a->ambient == b->ambient && a->diffuse == b->diffuse && a->specular == b->specular &&
+		   a->position == b->position && a->spot_direction == b->spot_direction &&
+		   a->spot_exponent == b->spot_exponent && a->spot_cutoff == b->spot_cutoff &&
+		   a->attenuation[0] == b->attenuation[0] && a->attenuation[1] == b->attenuation[1] &&
+		   a->attenuation[2] == b->attenuation[2];
+}
+
+static bool gl_material_equal(const GLMaterial *a, const GLMaterial *b) {
+	return a->emission == b->emission && a->ambient == b->ambient && a->diffuse == b->diffuse &&
+		   a->specular == b->specular && a->shininess == b->shininess;
+}
+
+static bool gl_vertex_cache_is_transformed(GLContext *c, GLVertexCache *cache) {
+	return cache->transformed &&
+		   cache->normalize_enabled == c->normalize_enabled &&
+		   memcmp(&cache->model_view, c->matrix_stack_ptr[0], sizeof(Matrix4)) == 0 &&
+		   memcmp(&cache->projection, c->matrix_stack_ptr[1], sizeof(Matrix4)) == 0 &&
+		   memcmp(&cache->viewport_scale, &c->viewport.scale, sizeof(Vector3)) == 0 &&
+		   memcmp(&cache->viewport_trans, &c->viewport.trans, sizeof(Vector3)) == 0;
+}
+
+static void gl_vertex_cache_transform(GLContext *c, GLVertexCache *cache) {
+	const Matrix4 *modelView = c->matrix_stack_ptr[0];
+	const Matrix4 *projection = c->matrix_stack_ptr[1];
+
+	// The same transformation as gl_vertex_transform with lighting, eye
+	// coordinates and normals are kept for lighting the vertices later on
+	Matrix4 normalMatrix = *modelView;
+	normalMatrix.invert();
+	normalMatrix.transpose();
+
+	for (int i = 0; i < cache->num_vertices; i++) {
+		GLVertex *v = &cache->vertices[i];
+		const float *coord = cache->vertex_array + 3 * i;
+		const float *normal = cache->normal_array + 3 * i;
+
+		v->coord = Vector4(coord[0], coord[1], coord[2], 1.0f);
+		modelView->transform3x4(v->coord, v->ec);
+		projection->transform(v->ec, v->pc);
+
+		normalMatrix.transform3x3(Vector4(normal[0], normal[1], normal[2], 0.0f), v->normal);
+		if (c->normalize_enabled)
+			v->normal.normalize();
+
+		v->clip_code = gl_clipcode(v->pc.X, v->pc.Y, v->pc.Z, v->pc.W);
+		if (v->clip_code == 0)
+			gl_transform_coords_to_viewport(c, v);
+	}
+
+	memcpy(&cache->model_view, modelView, sizeof(Matrix4));
+	memcpy(&cache->projection, projection, sizeof(Matrix4));
+	memcpy(&cache->viewport_scale, &c->viewport.scale, sizeof(Vector3));
+	memcpy(&cache->viewport_trans, &c->viewport.trans, sizeof(Vector3));
+	cache->normalize_enabled = c->normalize_enabled;
+	cache->transformed = 1;
+	cache->lit = 0;
+}
+
+// The lights are set up again for every actor, in the order of their
+// distance to it, so the light version changes all the time. The light
+// state is compared by value, like the matrices, to tell whether it is the
+// one the vertices were lit in.
+static bool gl_vertex_cache_is_lit(GLContext *c, GLVertexCache *cache) {
+	if (!cache->lit)
+		return false;
+	if (cache->light_version == c->light_version)
+		return true;
+
+	int n = 0;
+	for (GLLight *l = c->first_light; l != NULL; l = l->next, n++) {
+		if (n >= cache->num_lights || !gl_light_equal(l, &cache->lights[n]))
+			return false;
+	}
+	return n == cache->num_lights &&
+		   gl_material_equal(&c->materials[0], &cache->material) &&
+		   c->ambient_light_model == cache->ambient_light_model &&
+		   c->local_light_model == cache->local_light_model &&
+		   c->light_model_two_side == cache->light_model_two_side;
+}
+
+static void gl_vertex_cache_shade(GLContext *c, GLVertexCache *cache) {
+	if (gl_vertex_cache_is_lit(c, cache)) {
+		cache->light_version = c->light_version;
+		return;
+	}
+
+	for (int i = 0; i < cache->num_vertices; i++)
+		gl_shade_vertex(c, &cache->vertices[i]);
+
+	cache->num_lights = 0;
+	for (GLLight *l = c->first_light; l != NULL; l = l->next)
+		cache->lights[cache->num_lights++] = *l;
+	cache->material = c->materials[0];
+	cache->ambient_light_model = c->ambient_light_model;
+	cache->local_light_model = c->local_light_model;
+	cache->light_model_two_side = c->light_model_two_side;
+	cache->light_version = c->light_version;
+	cache->lit = 1;
+}
+
+} // end of namespace TinyGL
+
+TinyGL::GLVertexCache *tglGenVertexCache(int count, const float *vertices, const float *normals) {
+	TinyGL::GLVertexCache *cache = new TinyGL::GLVertexCache();
+	cache->num_vertices = count;
+	cache->vertex_array = vertices;
+	cache->normal_array = normals;
+	cache->vertices = (TinyGL::GLVertex *)TinyGL::gl_malloc(sizeof(TinyGL::GLVertex) * count);
+	cache->transformed = 0;
+	cache->lit = 0;
+	return cache;
+}
+
+void tglDeleteVertexCache(TinyGL::GLVertexCache *cache) {
+	if (!cache)
+		return;
+	TinyGL::gl_free(cache->vertices);
+	delete cache;
+}
+
+void tglDrawCachedPolygon(TinyGL::GLVertexCache *cache, int count, const int *indices, const float *texCoords, const int *texIndices) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	TinyGL::GLParam p[2];
+
+	// The same setup as glBegin: the matrices, the viewport and the triangle functions
+	p[1].i = TGL_POLYGON;
+	TinyGL::glopBegin(c, p);
+
+	if (!TinyGL::gl_vertex_cache_is_transformed(c, cache))
+		TinyGL::gl_vertex_cache_transform(c, cache);
+	if (c->lighting_enabled)
+		TinyGL::gl_vertex_cache_shade(c, cache);
+
+	if (count > c->vertex_max) {
+		while (c->vertex_max < count)
+			c->vertex_max <<= 1;
+		TinyGL::gl_free(c->vertex);
+		c->vertex = (TinyGL::GLVertex *)TinyGL::gl_malloc(sizeof(TinyGL::GLVertex) * c->vertex_max);
+		if (!c->vertex) {
+			error("unable to allocate GLVertex array.");
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		TinyGL::GLVertex *v = &c->vertex[i];
+		assert(indices[i] >= 0 && indices[i] < cache->num_vertices);
+		*v = cache->vertices[indices[i]];
+
+		if (!c->lighting_enabled)
+			v->color = c->current_color;
+
+		if (c->texture_2d_enabled) {
+			TinyGL::Vector4 texCoord = c->current_tex_coord;
+			if (texCoords) {
+				const float *t = texCoords + 2 * texIndices[i];
+				texCoord = TinyGL::Vector4(t[0], t[1], 0.0f, 1.0f);
+			}
+			if (c->apply_texture_matrix) {
+				c->matrix_stack_ptr[2]->transform(texCoord, v->tex_coord);
+			} else {
+				v->tex_coord = texCoord;
+			}
+		}
+
+		if (v->clip_code == 0)
+			TinyGL::gl_transform_colors_to_viewport(c, v);
+
+		v->edge_flag = c->current_edge_flag;
+	}
+
+	c->vertex_n = count;
+	c->vertex_cnt = count;
+	TinyGL::glopEnd(c, p);
+}
@@ -123,6 +123,33 @@ struct GLVertex {
 	ZBufferPoint zp;      // integer coordinates for the rasterization
 };
 
+// the vertices of a mesh kept transformed and lit between draws, see vertexcache.cpp
+struct GLVertexCache {
+	int num_vertices;
+	const float *vertex_array;
+	const float *normal_array;
+	GLVertex *vertices;
+
+	// the state the vertices were transformed in
+	int transformed;
+	Matrix4 model_view;
+	Matrix4 projection;
+	Vector3 viewport_scale;
+	Vector3 viewport_trans;
+	int normalize_enabled;
+
+	// the state the vertices were lit in: the enabled lights in the order of
+	// the list of enabled lights, the front material and the light model
+	int lit;
+	unsigned int light_version;
+	int num_lights;
+	GLLight lights[T_MAX_LIGHTS];
+	GLMaterial material;
+	Vector4 ambient_light_model;
+	int local_light_model;
+	int light_model_two_side;
+};
+
 struct GLImage {
 	Graphics::PixelBuffer pixmap;
 	int xsize, ysize;
@@ -163,6 +190,9 @@ struct GLContext {
 	int local_light_model;
 	int lighting_enabled;
 	int light_model_two_side;
+	// changed with the lights, the light model or the materials, so that the
+	// vertex caches only compare them after a change
+	unsigned int light_version;
 
 	// materials
 	GLMaterial materials[2];
@@ -282,6 +312,8 @@ void gl_add_op(GLParam *p);
 
 // clip.c
 void gl_transform_to_viewport(GLContext *c, GLVertex *v);
+void gl_transform_coords_to_viewport(GLContext *c, GLVertex *v);
+void gl_transform_colors_to_viewport(GLContext *c, GLVertex *v);
 void gl_draw_triangle(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 void gl_draw_line(GLContext *c, GLVertex *p0, GLVertex *p1);
 void gl_draw_point(GLContext *c, GLVertex *p0);
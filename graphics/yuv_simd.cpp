@@ -0,0 +1,200 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/intrinsics.h"
+
+#include "common/util.h"
+
+#include "graphics/yuv_simd.h"
+
+namespace Graphics {
+
+#ifdef HAVE_SSE2_INTRINSICS
+
+bool hasYUVSIMD() {
+	// SSE2 is part of every CPU the compiler was allowed to target
+	return true;
+}
+
+// Chroma samples prepared at once, the deltas live on the stack
+enum { kChromaChunk = 256 };
+
+/**
+ * Clamp the components to the range of the tables and scale them to 0-255
+ * the same way the lookup tables do.
+ */
+template<bool scaleITU>
+static inline __m128i scaleComponent(__m128i v) {
+	if (scaleITU) {
+		const __m128i c16 = _mm_set1_epi16(16);
+		v = _mm_min_epi16(_mm_max_epi16(v, c16), _mm_set1_epi16(235));
+		v = _mm_sub_epi16(v, c16);
+		// (v * 255) / 219 == v + (v * 36) / 219 == v + ((v * 10774) >> 16) for v <= 219
+		return _mm_add_epi16(v, _mm_mulhi_epu16(v, _mm_set1_epi16(10774)));
+	} else {
+		return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(255));
+	}
+}
+
+struct SIMDFormat {
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+	__m128i alpha16, alpha32;
+
+	SIMDFormat(const PixelFormat &format) {
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		aLoss = _mm_cvtsi32_si128(format.aLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+		aShift = _mm_cvtsi32_si128(format.aShift);
+		// Opaque alpha, as RGBToColor sets it
+		uint32 opaque = (0xFF >> format.aLoss) << format.aShift;
+		alpha16 = _mm_set1_epi16((int16)opaque);
+		alpha32 = _mm_set1_epi32((int32)opaque);
+	}
+};
+
+/**
+ * Convert 8 pixels of a row.
+ */
+template<int bytesPerPixel, bool scaleITU>
+static inline void convert8(byte *dst, const byte *y, const byte *a, __m128i dR, __m128i dG, __m128i dB, const SIMDFormat &f) {
+	const __m128i zero = _mm_setzero_si128();
+	__m128i lum = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)y), zero);
+
+	__m128i r = _mm_srl_epi16(scaleComponent<scaleITU>(_mm_add_epi16(lum, dR)), f.rLoss);
+	__m128i g = _mm_srl_epi16(scaleComponent<scaleITU>(_mm_add_epi16(lum, dG)), f.gLoss);
+	__m128i b = _mm_srl_epi16(scaleComponent<scaleITU>(_mm_add_epi16(lum, dB)), f.bLoss);
+	__m128i alpha = zero;
+	if (a)
+		alpha = _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)a), zero), f.aLoss);
+
+	if (bytesPerPixel == 2) {
+		__m128i pix = _mm_or_si128(_mm_sll_epi16(r, f.rShift), _mm_sll_epi16(g, f.gShift));
+		pix = _mm_or_si128(pix, _mm_sll_epi16(b, f.bShift));
+		pix = _mm_or_si128(pix, a ? _mm_sll_epi16(alpha, f.aShift) : f.alpha16);
+		_mm_storeu_si128((__m128i *)dst, pix);
+	} else {
+		__m128i lo = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), f.rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), f.gShift));
+		__m128i hi = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), f.rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), f.gShift));
+		lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), f.bShift));
+		hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), f.bShift));
+		if (a) {
+			lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(alpha, zero), f.aShift));
+			hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(alpha, zero), f.aShift));
+		} else {
+			lo = _mm_or_si128(lo, f.alpha32);
+			hi = _mm_or_si128(hi, f.alpha32);
+		}
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 16), hi);
+	}
+}
+
+template<int bytesPerPixel, bool scaleITU>
+static void convertYUV420SSE2(byte *dstPtr, int dstPitch, const SIMDFormat &f, const int16 *colorTab,
+                              const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                              int width, int yHeight, int yPitch, int uvPitch) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	int16 deltaR[kChromaChunk], deltaG[kChromaChunk], deltaB[kChromaChunk];
+
+	for (int h = 0; h < yHeight; h += 2) {
+		const byte *y0 = ySrc + h * yPitch;
+		const byte *a0 = aSrc ? aSrc + h * yPitch : 0;
+		byte *d0 = dstPtr + h * dstPitch;
+		const byte *u = uSrc + (h >> 1) * uvPitch;
+		const byte *v = vSrc + (h >> 1) * uvPitch;
+
+		for (int x = 0; x < width; x += 2 * kChromaChunk) {
+			int count = MIN<int>(width - x, 2 * kChromaChunk);
+
+			// The same table entries as the lookup converters, without their offsets
+			for (int i = 0; i < count / 2; i++) {
+				int cu = u[(x >> 1) + i];
+				int cv = v[(x >> 1) + i];
+				deltaR[i] = Cr_r_tab[cv] - (0 * 768 + 256);
+				deltaG[i] = (int16)(Cr_g_tab[cv] + Cb_g_tab[cu]) - (1 * 768 + 256);
+				deltaB[i] = Cb_b_tab[cu] - (2 * 768 + 256);
+			}
+
+			for (int i = 0; i < count; i += 8) {
+				// Every chroma sample covers two pixels of both rows
+				__m128i dR = _mm_loadl_epi64((const __m128i *)(deltaR + (i >> 1)));
+				__m128i dG = _mm_loadl_epi64((const __m128i *)(deltaG + (i >> 1)));
+				__m128i dB = _mm_loadl_epi64((const __m128i *)(deltaB + (i >> 1)));
+				dR = _mm_unpacklo_epi16(dR, dR);
+				dG = _mm_unpacklo_epi16(dG, dG);
+				dB = _mm_unpacklo_epi16(dB, dB);
+
+				int col = x + i;
+				byte *dst = d0 + col * bytesPerPixel;
+				convert8<bytesPerPixel, scaleITU>(dst, y0 + col, a0 ? a0 + col : 0, dR, dG, dB, f);
+				convert8<bytesPerPixel, scaleITU>(dst + dstPitch, y0 + yPitch + col, a0 ? a0 + yPitch + col : 0, dR, dG, dB, f);
+			}
+		}
+	}
+}
+
+int convertYUV420SIMD(byte *dstPtr, int dstPitch, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+                      const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                      int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int width = yWidth & ~7;
+	if (width == 0 || (format.bytesPerPixel != 2 && format.bytesPerPixel != 4))
+		return 0;
+
+	SIMDFormat f(format);
+	if (format.bytesPerPixel == 2) {
+		if (scaleITU)
+			convertYUV420SSE2<2, true>(dstPtr, dstPitch, f, colorTab, ySrc, uSrc, vSrc, aSrc, width, yHeight, yPitch, uvPitch);
+		else
+			convertYUV420SSE2<2, false>(dstPtr, dstPitch, f, colorTab, ySrc, uSrc, vSrc, aSrc, width, yHeight, yPitch, uvPitch);
+	} else {
+		if (scaleITU)
+			convertYUV420SSE2<4, true>(dstPtr, dstPitch, f, colorTab, ySrc, uSrc, vSrc, aSrc, width, yHeight, yPitch, uvPitch);
+		else
+			convertYUV420SSE2<4, false>(dstPtr, dstPitch, f, colorTab, ySrc, uSrc, vSrc, aSrc, width, yHeight, yPitch, uvPitch);
+	}
+	return width;
+}
+
+#else
+
+bool hasYUVSIMD() {
+	return false;
+}
+
+int convertYUV420SIMD(byte *dstPtr, int dstPitch, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+                      const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                      int yWidth, int yHeight, int yPitch, int uvPitch) {
+	return 0;
+}
+
+#endif
+
+} // End of namespace Graphics
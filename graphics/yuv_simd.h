@@ -0,0 +1,59 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * Vectorised 4:2:0 kernels shared by YUVToRGBManager and YUVAToRGBAManager.
+ * They produce exactly the same pixels as the lookup table converters.
+ */
+
+#ifndef GRAPHICS_YUV_SIMD_H
+#define GRAPHICS_YUV_SIMD_H
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * Whether the vectorised kernels are available on this build and CPU.
+ */
+bool hasYUVSIMD();
+
+/**
+ * Convert the left part of a YUV420 image, in columns of 8 pixels.
+ *
+ * @param dstPtr    the first pixel of the destination
+ * @param dstPitch  the pitch of the destination
+ * @param format    the destination format, 2 or 4 bytes per pixel
+ * @param scaleITU  true if the luminance ranges from 16 to 235
+ * @param colorTab  the chroma tables of the lookup table converters
+ * @param aSrc      the alpha plane, which has the pitch of the y plane, or 0 for opaque
+ * @return the number of columns converted, the caller converts the rest
+ */
+int convertYUV420SIMD(byte *dstPtr, int dstPitch, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+                      const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+                      int yWidth, int yHeight, int yPitch, int uvPitch);
+
+} // End of namespace Graphics
+
+#endif
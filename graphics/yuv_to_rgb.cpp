@@ -84,6 +84,7 @@
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "graphics/surface.h"
+#include "graphics/yuv_simd.h"
 #include "graphics/yuv_to_rgb.h"
 
 namespace Common {
@@ -159,6 +160,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
+	_useSIMD = true;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -274,7 +276,7 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
@@ -290,12 +292,25 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	byte *dstPtr = (byte *)dst->getPixels();
+
+	// The vector kernels do most of the picture, the tables the columns left over
+	int done = 0;
+	if (_useSIMD && hasYUVSIMD())
+		done = convertYUV420SIMD(dstPtr, dst->pitch, dst->format, scale == kScaleITU, _colorTab, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch);
+	if (done == yWidth)
+		return;
+
+	dstPtr += done * dst->format.bytesPerPixel;
+	ySrc += done;
+	uSrc += done >> 1;
+	vSrc += done >> 1;
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - done, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - done, yHeight, yPitch, uvPitch);
 }
 
 #define READ_QUAD(ptr, prefix) \
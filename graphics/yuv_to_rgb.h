@@ -105,6 +105,12 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Allow convert420 to use the vectorised kernels when the CPU has them,
+	 * which is the default. The output is the same either way.
+	 */
+	void setUseSIMD(bool useSIMD) { _useSIMD = useSIMD; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -114,6 +120,7 @@ private:
 
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+	bool _useSIMD;
 };
 
 } // End of namespace Graphics
@@ -84,6 +84,7 @@
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "graphics/surface.h"
+#include "graphics/yuv_simd.h"
 #include "graphics/yuva_to_rgba.h"
 
 namespace Common {
@@ -166,6 +167,7 @@ YUVAToRGBALookup::YUVAToRGBALookup(Graphics::PixelFormat format, YUVAToRGBAManag
 
 YUVAToRGBAManager::YUVAToRGBAManager() {
 	_lookup = 0;
+	_useSIMD = true;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -203,6 +205,10 @@ const YUVAToRGBALookup *YUVAToRGBAManager::getLookup(Graphics::PixelFormat forma
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b] | aToPix[a])
 
+#define PUT_PIXEL(s, d) \
+	L = &rgbToPix[(s)]; \
+	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b] | opaque)
+
 template<typename PixelInt>
 void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
@@ -238,7 +244,7 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lo
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		aSrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
@@ -246,21 +252,94 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lo
 	}
 }
 
+// Same as above, for images without an alpha plane
+template<typename PixelInt>
+void convertYUV420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int halfHeight = yHeight >> 1;
+	int halfWidth = yWidth >> 1;
+
+	// Keep the tables in pointers here to avoid a dereference on each pixel
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const uint32 opaque = lookup->getAlphaToPix()[255];
+
+	for (int h = 0; h < halfHeight; h++) {
+		for (int w = 0; w < halfWidth; w++) {
+			register const uint32 *L;
+
+			int16 cr_r  = Cr_r_tab[*vSrc];
+			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
+			int16 cb_b  = Cb_b_tab[*uSrc];
+			++uSrc;
+			++vSrc;
+
+			PUT_PIXEL(*ySrc, dstPtr);
+			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
+			ySrc++;
+			dstPtr += sizeof(PixelInt);
+			PUT_PIXEL(*ySrc, dstPtr);
+			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
+			ySrc++;
+			dstPtr += sizeof(PixelInt);
+		}
+
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
+		ySrc += (yPitch << 1) - yWidth;
+		uSrc += uvPitch - halfWidth;
+		vSrc += uvPitch - halfWidth;
+	}
+}
+
 void YUVAToRGBAManager::convert420(Graphics::Surface *dst, YUVAToRGBAManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convert420Rows(dst, scale, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch, uvPitch, 0, yHeight);
+}
+
+void YUVAToRGBAManager::convert420Rows(Graphics::Surface *dst, YUVAToRGBAManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yPitch, int uvPitch, int firstRow, int rowCount) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
-	assert((yHeight & 1) == 0);
+	assert((firstRow & 1) == 0);
+	assert((rowCount & 1) == 0);
 
 	const YUVAToRGBALookup *lookup = getLookup(dst->format, scale);
 
+	byte *dstPtr = (byte *)dst->getBasePtr(0, firstRow);
+	ySrc += firstRow * yPitch;
+	uSrc += (firstRow >> 1) * uvPitch;
+	vSrc += (firstRow >> 1) * uvPitch;
+	if (aSrc)
+		aSrc += firstRow * yPitch;
+
+	// The vector kernels do most of the picture, the tables the columns left over
+	int done = 0;
+	if (_useSIMD && hasYUVSIMD())
+		done = convertYUV420SIMD(dstPtr, dst->pitch, dst->format, scale == kScaleITU, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, rowCount, yPitch, uvPitch);
+	if (done == yWidth)
+		return;
+
+	dstPtr += done * dst->format.bytesPerPixel;
+	ySrc += done;
+	uSrc += done >> 1;
+	vSrc += done >> 1;
+
 	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	if (aSrc) {
+		aSrc += done;
+		if (dst->format.bytesPerPixel == 2)
+			convertYUVA420ToRGBA<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth - done, rowCount, yPitch, uvPitch);
+		else
+			convertYUVA420ToRGBA<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth - done, rowCount, yPitch, uvPitch);
+	} else {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV420ToRGBA<uint16>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - done, rowCount, yPitch, uvPitch);
+		else
+			convertYUV420ToRGBA<uint32>(dstPtr, dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth - done, rowCount, yPitch, uvPitch);
+	}
 }
 
 } // End of namespace Graphics
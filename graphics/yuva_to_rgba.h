@@ -55,7 +55,7 @@ public:
 	 * @param ySrc    the source of the y component
 	 * @param uSrc    the source of the u component
 	 * @param vSrc    the source of the v component
-	 * @param aSrc    the source of the a component
+	 * @param aSrc    the source of the a component, or 0 for an opaque image
 	 * @param yWidth  the width of the y surface (must be divisible by 2)
 	 * @param yHeight the height of the y surface (must be divisible by 2)
 	 * @param yPitch  the pitch of the y surface
@@ -63,6 +63,24 @@ public:
 	 */
 	void convert420(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Convert a band of rows of a YUV420 image to an RGB surface
+	 *
+	 * The sources point to the start of the whole image, only the rows
+	 * from firstRow to firstRow + rowCount are read and written.
+	 *
+	 * @param firstRow the first row to convert (must be divisible by 2)
+	 * @param rowCount the number of rows to convert (must be divisible by 2)
+	 * @see convert420
+	 */
+	void convert420Rows(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yPitch, int uvPitch, int firstRow, int rowCount);
+
+	/**
+	 * Allow the 420 conversions to use the vectorised kernels when the CPU
+	 * has them, which is the default. The output is the same either way.
+	 */
+	void setUseSIMD(bool useSIMD) { _useSIMD = useSIMD; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVAToRGBAManager();
@@ -72,6 +90,7 @@ private:
 
 	YUVAToRGBALookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+	bool _useSIMD;
 };
 
 } // End of namespace Graphics
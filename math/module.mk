@@ -13,7 +13,8 @@ MODULE_OBJS := \
 	vector4d.o \
 	aabb.o \
 	frustum.o \
-	plane.o
+	plane.o \
+	skinning.o
 
 # Include common rules
 include $(srcdir)/rules.mk
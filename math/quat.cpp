@@ -36,7 +36,7 @@
 
 namespace Math {
 
-Quaternion Quaternion::slerpQuat(const Quaternion& to, const float t) {
+Quaternion Quaternion::slerpQuat(const Quaternion& to, const float t) const {
 	Quaternion dst;
 	float co, scale0, scale1;
 	bool flip = false ;
@@ -60,7 +60,7 @@ public:
 	 * @param t		factor to slerp by.
 	 * @return		the resulting quaternion.
 	 */
-	Quaternion slerpQuat(const Quaternion& to, const float t);
+	Quaternion slerpQuat(const Quaternion& to, const float t) const;
 	static Quaternion fromEuler(const Angle &yaw, const Angle &pitch, const Angle &roll);
 	
 	inline static Quaternion get_quaternion(const char *data) {
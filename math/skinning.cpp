@@ -0,0 +1,261 @@
+/* ResidualVM - A 3D game interpreter
+*
+* ResidualVM is the legal property of its developers, whose names
+* are too numerous to list here. Please refer to the COPYRIGHT
+* file distributed with this source distribution.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "common/intrinsics.h"
+
+#include "math/skinning.h"
+
+namespace Math {
+
+static bool useSIMD = true;
+
+void setUseSkinningSIMD(bool use) {
+	useSIMD = use;
+}
+
+bool hasSkinningSIMD() {
+#ifdef HAVE_SSE_INTRINSICS
+	// SSE is part of every CPU the compiler was allowed to target
+	return true;
+#else
+	return false;
+#endif
+}
+
+SkinnedMesh::SkinnedMesh() :
+		_numVertices(0), _x(nullptr), _y(nullptr), _z(nullptr),
+		_nx(nullptr), _ny(nullptr), _nz(nullptr), _joints(nullptr), _weights(nullptr) {
+}
+
+SkinnedMesh::~SkinnedMesh() {
+	free();
+}
+
+void SkinnedMesh::free() {
+	delete[] _x;
+	delete[] _joints;
+	delete[] _weights;
+	_x = _y = _z = _nx = _ny = _nz = nullptr;
+	_joints = nullptr;
+	_weights = nullptr;
+	_numVertices = 0;
+}
+
+void SkinnedMesh::setup(int numVertices) {
+	free();
+
+	_numVertices = numVertices;
+	_x = new float[6 * numVertices];
+	_y = _x + numVertices;
+	_z = _y + numVertices;
+	_nx = _z + numVertices;
+	_ny = _nx + numVertices;
+	_nz = _ny + numVertices;
+	for (int i = 0; i < 6 * numVertices; i++) {
+		_x[i] = 0.f;
+	}
+
+	_joints = new int[kMaxInfluences * numVertices];
+	_weights = new float[kMaxInfluences * numVertices];
+	for (int i = 0; i < kMaxInfluences * numVertices; i++) {
+		_joints[i] = 0;
+		_weights[i] = 0.f;
+	}
+}
+
+void SkinnedMesh::setVertex(int vertex, const Vector3d &pos, const Vector3d &normal) {
+	assert(vertex >= 0 && vertex < _numVertices);
+	_x[vertex] = pos.x();
+	_y[vertex] = pos.y();
+	_z[vertex] = pos.z();
+	_nx[vertex] = normal.x();
+	_ny[vertex] = normal.y();
+	_nz[vertex] = normal.z();
+}
+
+void SkinnedMesh::setInfluences(int vertex, const int *joints, const float *weights, int count) {
+	assert(vertex >= 0 && vertex < _numVertices);
+
+	int keptJoints[kMaxInfluences];
+	float keptWeights[kMaxInfluences];
+	int numKept = 0;
+	float total = 0.f;
+	for (int i = 0; i < count; i++) {
+		assert(joints[i] >= 0);
+		total += weights[i];
+		if (numKept < kMaxInfluences) {
+			keptJoints[numKept] = joints[i];
+			keptWeights[numKept] = weights[i];
+			numKept++;
+			continue;
+		}
+
+		int smallest = 0;
+		for (int k = 1; k < kMaxInfluences; k++) {
+			if (keptWeights[k] < keptWeights[smallest])
+				smallest = k;
+		}
+		if (weights[i] > keptWeights[smallest]) {
+			keptJoints[smallest] = joints[i];
+			keptWeights[smallest] = weights[i];
+		}
+	}
+
+	if (count > kMaxInfluences) {
+		float keptTotal = 0.f;
+		for (int k = 0; k < numKept; k++) {
+			keptTotal += keptWeights[k];
+		}
+		if (keptTotal > 0.f) {
+			for (int k = 0; k < numKept; k++) {
+				keptWeights[k] *= total / keptTotal;
+			}
+		}
+	}
+
+	for (int k = 0; k < kMaxInfluences; k++) {
+		_joints[k * _numVertices + vertex] = k < numKept ? keptJoints[k] : 0;
+		_weights[k * _numVertices + vertex] = k < numKept ? keptWeights[k] : 0.f;
+	}
+}
+
+void SkinnedMesh::skinScalar(const Matrix4 *skinMatrices, Vector3d *vertices, Vector3d *normals, int start) const {
+	// The same operations in the same order as the vectorised kernel
+	for (int v = start; v < _numVertices; v++) {
+		float m[12];
+		for (int e = 0; e < 12; e++) {
+			m[e] = 0.f;
+		}
+		for (int k = 0; k < kMaxInfluences; k++) {
+			const int i = k * _numVertices + v;
+			const float *joint = skinMatrices[_joints[i]].getData();
+			const float w = _weights[i];
+			for (int e = 0; e < 12; e++) {
+				m[e] += w * joint[e];
+			}
+		}
+
+		const float x = _x[v], y = _y[v], z = _z[v];
+		float *pos = vertices[v].getData();
+		pos[0] = m[0] * x + m[1] * y + m[2] * z + m[3];
+		pos[1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+		pos[2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+
+		const float nx = _nx[v], ny = _ny[v], nz = _nz[v];
+		float *normal = normals[v].getData();
+		normal[0] = m[0] * nx + m[1] * ny + m[2] * nz;
+		normal[1] = m[4] * nx + m[5] * ny + m[6] * nz;
+		normal[2] = m[8] * nx + m[9] * ny + m[10] * nz;
+		const float length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (length > 0.f) {
+			normal[0] /= length;
+			normal[1] /= length;
+			normal[2] /= length;
+		}
+	}
+}
+
+#ifdef HAVE_SSE_INTRINSICS
+
+static inline void storeVector3(float *dst, __m128 v) {
+	_mm_storel_pi((__m64 *)dst, v);
+	_mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+}
+
+/**
+ * Multiply the columns of the blended matrices of four vertices by their
+ * coordinates, one vertex per lane.
+ */
+static inline __m128 transformRow(const __m128 *row, __m128 x, __m128 y, __m128 z) {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(row[0], x), _mm_mul_ps(row[1], y)), _mm_mul_ps(row[2], z));
+}
+
+#endif
+
+void SkinnedMesh::skin(const Matrix4 *skinMatrices, Vector3d *vertices, Vector3d *normals) const {
+	int start = 0;
+
+#ifdef HAVE_SSE_INTRINSICS
+	if (useSIMD) {
+		const __m128 zero = _mm_setzero_ps();
+		for (; start + 4 <= _numVertices; start += 4) {
+			// Blend the joint matrices of each vertex, as rows of a 3x4 matrix
+			__m128 row0[4], row1[4], row2[4];
+			for (int l = 0; l < 4; l++) {
+				__m128 r0 = zero, r1 = zero, r2 = zero;
+				for (int k = 0; k < kMaxInfluences; k++) {
+					const int i = k * _numVertices + start + l;
+					const float *joint = skinMatrices[_joints[i]].getData();
+					const __m128 w = _mm_set1_ps(_weights[i]);
+					r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_loadu_ps(joint)));
+					r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_loadu_ps(joint + 4)));
+					r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_loadu_ps(joint + 8)));
+				}
+				row0[l] = r0;
+				row1[l] = r1;
+				row2[l] = r2;
+			}
+
+			// Now every register holds one matrix element of the four vertices
+			_MM_TRANSPOSE4_PS(row0[0], row0[1], row0[2], row0[3]);
+			_MM_TRANSPOSE4_PS(row1[0], row1[1], row1[2], row1[3]);
+			_MM_TRANSPOSE4_PS(row2[0], row2[1], row2[2], row2[3]);
+
+			const __m128 x = _mm_loadu_ps(_x + start);
+			const __m128 y = _mm_loadu_ps(_y + start);
+			const __m128 z = _mm_loadu_ps(_z + start);
+			__m128 px = _mm_add_ps(transformRow(row0, x, y, z), row0[3]);
+			__m128 py = _mm_add_ps(transformRow(row1, x, y, z), row1[3]);
+			__m128 pz = _mm_add_ps(transformRow(row2, x, y, z), row2[3]);
+
+			const __m128 nx = _mm_loadu_ps(_nx + start);
+			const __m128 ny = _mm_loadu_ps(_ny + start);
+			const __m128 nz = _mm_loadu_ps(_nz + start);
+			__m128 qx = transformRow(row0, nx, ny, nz);
+			__m128 qy = transformRow(row1, nx, ny, nz);
+			__m128 qz = transformRow(row2, nx, ny, nz);
+			const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), _mm_mul_ps(qz, qz)));
+			// Normals of zero length are left alone
+			const __m128 nonZero = _mm_cmpgt_ps(length, zero);
+			qx = _mm_or_ps(_mm_and_ps(nonZero, _mm_div_ps(qx, length)), _mm_andnot_ps(nonZero, qx));
+			qy = _mm_or_ps(_mm_and_ps(nonZero, _mm_div_ps(qy, length)), _mm_andnot_ps(nonZero, qy));
+			qz = _mm_or_ps(_mm_and_ps(nonZero, _mm_div_ps(qz, length)), _mm_andnot_ps(nonZero, qz));
+
+			__m128 pw = zero, qw = zero;
+			_MM_TRANSPOSE4_PS(px, py, pz, pw);
+			_MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+			storeVector3(vertices[start].getData(), px);
+			storeVector3(vertices[start + 1].getData(), py);
+			storeVector3(vertices[start + 2].getData(), pz);
+			storeVector3(vertices[start + 3].getData(), pw);
+			storeVector3(normals[start].getData(), qx);
+			storeVector3(normals[start + 1].getData(), qy);
+			storeVector3(normals[start + 2].getData(), qz);
+			storeVector3(normals[start + 3].getData(), qw);
+		}
+	}
+#endif
+
+	skinScalar(skinMatrices, vertices, normals, start);
+}
+
+} // end of namespace Math
@@ -0,0 +1,98 @@
+/* ResidualVM - A 3D game interpreter
+*
+* ResidualVM is the legal property of its developers, whose names
+* are too numerous to list here. Please refer to the COPYRIGHT
+* file distributed with this source distribution.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#ifndef MATH_SKINNING_H
+#define MATH_SKINNING_H
+
+#include "common/noncopyable.h"
+
+#include "math/vector3d.h"
+#include "math/matrix4.h"
+
+namespace Math {
+
+/**
+ * Whether the vectorised skinning kernel is available on this build and CPU.
+ */
+bool hasSkinningSIMD();
+
+/**
+ * Use the scalar skinning kernel even if the vectorised one is available,
+ * for comparing the two.
+ */
+void setUseSkinningSIMD(bool use);
+
+/**
+ * The bind pose of a mesh for linear blend skinning.
+ *
+ * The vertices, normals and influences are stored as structure of arrays
+ * so that four vertices are skinned at once. Every vertex is moved by up
+ * to kMaxInfluences joints, unused influences have a weight of zero.
+ */
+class SkinnedMesh : Common::NonCopyable {
+public:
+	enum { kMaxInfluences = 4 };
+
+	SkinnedMesh();
+	~SkinnedMesh();
+
+	/**
+	 * Allocate the arrays for the vertices, which start out at the origin
+	 * without influences.
+	 */
+	void setup(int numVertices);
+	void setVertex(int vertex, const Vector3d &pos, const Vector3d &normal);
+
+	/**
+	 * Set the joints which move a vertex and their weights. If there are
+	 * more than kMaxInfluences, the ones with the smallest weights are
+	 * dropped and the rest is scaled back to the same total weight.
+	 */
+	void setInfluences(int vertex, const int *joints, const float *weights, int count);
+
+	/**
+	 * Skin every vertex with the blend of its joint matrices.
+	 *
+	 * @param skinMatrices  for every joint the pose matrix multiplied by the
+	 *                      inverse of the bind pose matrix
+	 * @param vertices      the skinned vertices
+	 * @param normals       the skinned normals, which are normalised
+	 */
+	void skin(const Matrix4 *skinMatrices, Vector3d *vertices, Vector3d *normals) const;
+
+	int getNumVertices() const { return _numVertices; }
+
+private:
+	void skinScalar(const Matrix4 *skinMatrices, Vector3d *vertices, Vector3d *normals, int start) const;
+	void free();
+
+	int _numVertices;
+	float *_x, *_y, *_z;
+	float *_nx, *_ny, *_nz;
+	// kMaxInfluences arrays of _numVertices entries each
+	int *_joints;
+	float *_weights;
+};
+
+} // end of namespace Math
+
+#endif
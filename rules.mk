@@ -21,7 +21,7 @@ ifdef TOOL_EXECUTABLE
 ################################################
 TOOL-$(MODULE) := $(MODULE)/$(TOOL_EXECUTABLE)$(EXEEXT)
 $(TOOL-$(MODULE)): $(MODULE_OBJS-$(MODULE)) $(TOOL_DEPS)
-	$(QUIET_CXX)$(CXX) $(LDFLAGS) $+ -o $@
+	$(QUIET_CXX)$(CXX) $(LDFLAGS) $+ $(TOOL_LIBS) -o $@
 
 # Reset TOOL_* vars
 TOOL_EXECUTABLE:=
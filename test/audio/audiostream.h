@@ -205,4 +205,62 @@ public:
 	void test_sub_looping_audio_stream_stereo_22050_end_fixed_iter() {
 		testSubLoopingAudioStreamFixedIter(22050, true, 2, 2);
 	}
+
+	void test_ring_queuing_audio_stream_wrap_around() {
+		Audio::RingQueuingAudioStream *stream = Audio::makeRingQueuingAudioStream(22050, true, 100);
+		TS_ASSERT_EQUALS(stream->getFreeSamples(), 128u);
+		TS_ASSERT(stream->endOfData());
+
+		// Write and read in uneven steps, so the ring wraps around several times
+		int16 next = 0, expected = 0;
+		int16 buffer[128];
+		for (int round = 0; round < 20; round++) {
+			uint32 count = 90;
+			while (count) {
+				uint32 piece = count;
+				int16 *dst = stream->reserve(piece);
+				if (!piece)
+					break;
+				for (uint32 i = 0; i < piece; i++)
+					dst[i] = next++;
+				stream->commit(piece);
+				count -= piece;
+			}
+			TS_ASSERT(!stream->endOfData());
+
+			int read = stream->readBuffer(buffer, 70);
+			for (int i = 0; i < read; i++)
+				TS_ASSERT_EQUALS(buffer[i], expected++);
+		}
+		int read = stream->readBuffer(buffer, ARRAYSIZE(buffer));
+		for (int i = 0; i < read; i++)
+			TS_ASSERT_EQUALS(buffer[i], expected++);
+		TS_ASSERT_EQUALS(expected, next);
+		TS_ASSERT(stream->endOfData());
+		TS_ASSERT(!stream->endOfStream());
+
+		stream->finish();
+		TS_ASSERT(stream->endOfStream());
+		delete stream;
+	}
+
+	void test_ring_queuing_audio_stream_formats() {
+		Audio::RingQueuingAudioStream *stream = Audio::makeRingQueuingAudioStream(11025, false, 64);
+
+		byte be[] = { 0x12, 0x34, 0xFF, 0xFE };
+		byte le[] = { 0x34, 0x12, 0xFE, 0xFF };
+		byte u8[] = { 0x80, 0x00, 0xFF };
+		stream->queueBuffer(be, sizeof(be), DisposeAfterUse::NO, Audio::FLAG_16BITS);
+		stream->queueBuffer(le, sizeof(le), DisposeAfterUse::NO, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		stream->queueBuffer(u8, sizeof(u8), DisposeAfterUse::NO, Audio::FLAG_UNSIGNED);
+
+		const int16 samples[] = { 0x1234, -2 };
+		TS_ASSERT_EQUALS(stream->queueSamples(samples, 2), 2u);
+
+		int16 expected[] = { 0x1234, -2, 0x1234, -2, 0, -32768, 0x7F00, 0x1234, -2 };
+		int16 buffer[16];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, ARRAYSIZE(buffer)), ARRAYSIZE(expected));
+		TS_ASSERT_EQUALS(memcmp(buffer, expected, sizeof(expected)), 0);
+		delete stream;
+	}
 };
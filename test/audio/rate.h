@@ -0,0 +1,205 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/math.h"
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "test/test_random.h"
+
+// The vectorised mixing kernels have to match the scalar code sample for sample,
+// and the sinc converter has to keep what it should and remove what would alias
+class RateConverterTestSuite : public CxxTest::TestSuite {
+	enum {
+		kInputSamples = 5000,
+		kOutputFrames = 3001
+	};
+
+	/**
+	 * Random samples with the extremes at the start, read in odd sized
+	 * pieces so the converters refill their buffers in the middle of a block.
+	 */
+	class NoiseStream : public Audio::AudioStream {
+		int16 _samples[kInputSamples];
+		int _pos;
+		int _rate;
+		bool _stereo;
+
+	public:
+		NoiseStream(int rate, bool stereo) : _pos(0), _rate(rate), _stereo(stereo) {
+			TestRandom rng(4321);
+			for (int i = 0; i < kInputSamples; i++)
+				_samples[i] = rng.next() >> 16;
+			_samples[0] = -32768;
+			_samples[1] = 32767;
+			_samples[2] = -1;
+		}
+
+		int readBuffer(int16 *buffer, const int numSamples) {
+			int n = MIN(numSamples, kInputSamples - _pos);
+			if (n > 37)
+				n -= n % 37;
+			if (_stereo)
+				n &= ~1;
+			memcpy(buffer, _samples + _pos, n * sizeof(int16));
+			_pos += n;
+			return n;
+		}
+
+		bool isStereo() const { return _stereo; }
+		int getRate() const { return _rate; }
+		bool endOfData() const { return _pos >= kInputSamples; }
+	};
+
+	/**
+	 * A mono sine wave.
+	 */
+	class ToneStream : public Audio::AudioStream {
+		int _rate;
+		double _frequency;
+		int _pos;
+
+	public:
+		ToneStream(int rate, double frequency) : _rate(rate), _frequency(frequency), _pos(0) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) {
+			int n = MIN(numSamples, kInputSamples - _pos);
+			for (int i = 0; i < n; i++)
+				buffer[i] = (int16)(kToneAmplitude * sin(2 * M_PI * _frequency * (_pos + i) / _rate));
+			_pos += n;
+			return n;
+		}
+
+		bool isStereo() const { return false; }
+		int getRate() const { return _rate; }
+		bool endOfData() const { return _pos >= kInputSamples; }
+	};
+
+	enum {
+		kToneAmplitude = 16000
+	};
+
+	/**
+	 * Resample a tone and return the RMS of the difference from the same tone
+	 * at the output rate, or from silence when the tone is above the Nyquist
+	 * frequency of the output. The ends, where the filters run into the
+	 * silence around the tone, are left out.
+	 */
+	static double toneError(int inRate, int outRate, double frequency) {
+		ToneStream input(inRate, frequency);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false);
+		int16 buffer[kOutputFrames * 2];
+		memset(buffer, 0, sizeof(buffer));
+		int frames = converter->flow(input, buffer, kOutputFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		delete converter;
+
+		const bool audible = frequency < outRate / 2;
+		double sum = 0.0;
+		int count = 0;
+		for (int i = 64; i < frames - 64; i++) {
+			double expected = audible ? kToneAmplitude * sin(2 * M_PI * frequency * i / outRate) : 0.0;
+			double diff = buffer[i * 2] - expected;
+			sum += diff * diff;
+			count++;
+		}
+		return count ? sqrt(sum / count) : 1e9;
+	}
+
+	static void fillOutput(int16 *buffer) {
+		TestRandom rng(999);
+		for (int i = 0; i < kOutputFrames * 2; i++)
+			buffer[i] = rng.next() >> 16;
+	}
+
+	static int convert(int16 *buffer, int inRate, int outRate, bool stereo, bool reverseStereo, uint16 volL, uint16 volR) {
+		NoiseStream input(inRate, stereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, reverseStereo);
+		fillOutput(buffer);
+		int frames = 0;
+		// Several calls of uneven size, to leave partial blocks behind
+		while (frames < kOutputFrames) {
+			int n = converter->flow(input, buffer + frames * 2, MIN<int>(kOutputFrames - frames, 509), volL, volR);
+			if (n <= 0)
+				break;
+			frames += n;
+		}
+		delete converter;
+		return frames;
+	}
+
+	void compare(int inRate, int outRate, bool stereo, bool reverseStereo, uint16 volL, uint16 volR) {
+		int16 scalar[kOutputFrames * 2], simd[kOutputFrames * 2];
+
+		Audio::setUseRateSIMD(false);
+		int scalarFrames = convert(scalar, inRate, outRate, stereo, reverseStereo, volL, volR);
+		Audio::setUseRateSIMD(true);
+		int simdFrames = convert(simd, inRate, outRate, stereo, reverseStereo, volL, volR);
+
+		TS_ASSERT_EQUALS(scalarFrames, simdFrames);
+		TS_ASSERT(scalarFrames > 0);
+		TS_ASSERT_EQUALS(memcmp(scalar, simd, sizeof(scalar)), 0);
+	}
+
+	void compareVolumes(int inRate, int outRate, bool stereo, bool reverseStereo) {
+		compare(inRate, outRate, stereo, reverseStereo, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		compare(inRate, outRate, stereo, reverseStereo, 0, 255);
+		compare(inRate, outRate, stereo, reverseStereo, 97, 13);
+	}
+
+public:
+	void test_copy_mono() {
+		compareVolumes(44100, 44100, false, false);
+	}
+
+	void test_copy_stereo() {
+		compareVolumes(44100, 44100, true, false);
+		compareVolumes(48000, 48000, true, true);
+	}
+
+	void test_halve_rate() {
+		compareVolumes(44100, 22050, false, false);
+		compareVolumes(48000, 24000, true, false);
+		compareVolumes(44100, 11025, true, true);
+	}
+
+	void test_double_rate() {
+		compareVolumes(22050, 44100, false, false);
+		compareVolumes(24000, 48000, true, false);
+		compareVolumes(22050, 44100, true, true);
+	}
+
+	void test_other_rates() {
+		compareVolumes(22050, 48000, false, false);
+		compareVolumes(11025, 48000, true, true);
+	}
+
+	void test_sinc_rates() {
+		Audio::setUseSincResampler(true);
+		compareVolumes(22050, 48000, true, false);
+		compareVolumes(11025, 44100, false, false);
+		compareVolumes(44100, 22050, true, true);
+		compareVolumes(48000, 44100, false, false);
+		Audio::setUseSincResampler(false);
+	}
+
+	void test_sinc_passband() {
+		// Within a percent of the tone, well below the Nyquist frequency
+		Audio::setUseSincResampler(true);
+		TS_ASSERT_LESS_THAN(toneError(22050, 48000, 1000.0), kToneAmplitude * 0.01);
+		TS_ASSERT_LESS_THAN(toneError(22050, 44100, 8000.0), kToneAmplitude * 0.01);
+		TS_ASSERT_LESS_THAN(toneError(44100, 22050, 3000.0), kToneAmplitude * 0.01);
+		Audio::setUseSincResampler(false);
+	}
+
+	void test_sinc_alias_rejection() {
+		// Dropping every other frame folds a 15 kHz tone down to 7.05 kHz
+		TS_ASSERT_LESS_THAN(kToneAmplitude * 0.5, toneError(44100, 22050, 15000.0));
+
+		// The filter leaves less than 60 dB of it
+		Audio::setUseSincResampler(true);
+		TS_ASSERT_LESS_THAN(toneError(44100, 22050, 15000.0), kToneAmplitude * 0.001);
+		TS_ASSERT_LESS_THAN(toneError(48000, 22050, 13000.0), kToneAmplitude * 0.001);
+		Audio::setUseSincResampler(false);
+	}
+};
@@ -0,0 +1,99 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+#include "test/test_random.h"
+
+// The vectorised 4:2:0 kernels have to match the lookup tables bit for bit
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 70,
+		kHeight = 6
+	};
+
+	byte _y[kWidth * kHeight];
+	byte _u[(kWidth / 2) * (kHeight / 2)];
+	byte _v[(kWidth / 2) * (kHeight / 2)];
+	byte _a[kWidth * kHeight];
+
+	void fillPlanes() {
+		TestRandom rng(12345);
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			_y[i] = rng.next() >> 24;
+			_a[i] = rng.next() >> 24;
+		}
+		for (int i = 0; i < (kWidth / 2) * (kHeight / 2); i++) {
+			_u[i] = rng.next() >> 24;
+			_v[i] = rng.next() >> 24;
+		}
+		// Make sure the extremes get clamped
+		_y[0] = 0; _u[0] = 0; _v[0] = 255;
+		_y[1] = 255; _u[1] = 255; _v[1] = 0;
+	}
+
+	static bool sameSurfaces(const Graphics::Surface &a, const Graphics::Surface &b) {
+		for (int y = 0; y < a.h; y++)
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * a.format.bytesPerPixel))
+				return false;
+		return true;
+	}
+
+	void compareRGB(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		Graphics::Surface lut, simd;
+		lut.create(kWidth, kHeight, format);
+		simd.create(kWidth, kHeight, format);
+
+		YUVToRGBMan.setUseSIMD(false);
+		YUVToRGBMan.convert420(&lut, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth / 2);
+		YUVToRGBMan.setUseSIMD(true);
+		YUVToRGBMan.convert420(&simd, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth / 2);
+
+		TS_ASSERT(sameSurfaces(lut, simd));
+		lut.free();
+		simd.free();
+	}
+
+	void compareRGBA(const Graphics::PixelFormat &format, Graphics::YUVAToRGBAManager::LuminanceScale scale, const byte *aSrc) {
+		Graphics::Surface lut, simd;
+		lut.create(kWidth, kHeight, format);
+		simd.create(kWidth, kHeight, format);
+
+		YUVAToRGBAMan.setUseSIMD(false);
+		YUVAToRGBAMan.convert420(&lut, scale, _y, _u, _v, aSrc, kWidth, kHeight, kWidth, kWidth / 2);
+		YUVAToRGBAMan.setUseSIMD(true);
+		YUVAToRGBAMan.convert420(&simd, scale, _y, _u, _v, aSrc, kWidth, kHeight, kWidth, kWidth / 2);
+
+		TS_ASSERT(sameSurfaces(lut, simd));
+		lut.free();
+		simd.free();
+	}
+
+public:
+	void test_convert420_16bit() {
+		fillPlanes();
+		Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		compareRGB(format, Graphics::YUVToRGBManager::kScaleFull);
+		compareRGB(format, Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_convert420_32bit() {
+		fillPlanes();
+		Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		compareRGB(format, Graphics::YUVToRGBManager::kScaleFull);
+		compareRGB(format, Graphics::YUVToRGBManager::kScaleITU);
+	}
+
+	void test_convert420_alpha() {
+		fillPlanes();
+		Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		compareRGBA(rgba, Graphics::YUVAToRGBAManager::kScaleFull, _a);
+		compareRGBA(rgba, Graphics::YUVAToRGBAManager::kScaleITU, _a);
+		compareRGBA(rgba, Graphics::YUVAToRGBAManager::kScaleITU, 0);
+
+		Graphics::PixelFormat argb4444(2, 4, 4, 4, 4, 8, 4, 0, 12);
+		compareRGBA(argb4444, Graphics::YUVAToRGBAManager::kScaleFull, _a);
+		compareRGBA(argb4444, Graphics::YUVAToRGBAManager::kScaleFull, 0);
+	}
+};
@@ -0,0 +1,148 @@
+#include <cxxtest/TestSuite.h>
+
+#include "math/skinning.h"
+
+#include "test/test_random.h"
+
+// The skinning kernels have to move the vertices the same way as applying the
+// inverse bind pose and the joint pose one influence at a time
+class SkinningTestSuite : public CxxTest::TestSuite {
+	enum {
+		kNumVertices = 23,
+		kNumJoints = 7
+	};
+
+	TestRandom _random;
+
+	float randomFloat(float range) {
+		return _random.nextFloat(range);
+	}
+
+	Math::Matrix4 randomRigidMatrix() {
+		Math::Matrix4 m;
+		m.buildFromXYZ(Math::Angle(randomFloat(180.f)), Math::Angle(randomFloat(180.f)), Math::Angle(randomFloat(180.f)), Math::EO_XYZ);
+		m.setPosition(Math::Vector3d(randomFloat(10.f), randomFloat(10.f), randomFloat(10.f)));
+		return m;
+	}
+
+	Math::Matrix4 _bind[kNumJoints];
+	Math::Matrix4 _pose[kNumJoints];
+	Math::Matrix4 _skin[kNumJoints];
+	Math::Vector3d _vertices[kNumVertices];
+	Math::Vector3d _normals[kNumVertices];
+	int _joints[kNumVertices][Math::SkinnedMesh::kMaxInfluences];
+	float _weights[kNumVertices][Math::SkinnedMesh::kMaxInfluences];
+	int _counts[kNumVertices];
+
+	void setupMesh(Math::SkinnedMesh &mesh) {
+		_random = TestRandom(1234);
+		for (int j = 0; j < kNumJoints; j++) {
+			_bind[j] = randomRigidMatrix();
+			_pose[j] = randomRigidMatrix();
+			Math::Matrix4 inverseBind = _bind[j];
+			inverseBind.invertAffineOrthonormal();
+			_skin[j] = _pose[j] * inverseBind;
+		}
+
+		mesh.setup(kNumVertices);
+		for (int v = 0; v < kNumVertices; v++) {
+			_vertices[v].set(randomFloat(5.f), randomFloat(5.f), randomFloat(5.f));
+			_normals[v].set(randomFloat(1.f), randomFloat(1.f), randomFloat(1.f));
+			// Every fifth vertex has no influences at all
+			_counts[v] = v % (Math::SkinnedMesh::kMaxInfluences + 1);
+			float total = 0.f;
+			for (int k = 0; k < _counts[v]; k++) {
+				_joints[v][k] = (v + 3 * k) % kNumJoints;
+				_weights[v][k] = randomFloat(1.f) + 1.5f;
+				total += _weights[v][k];
+			}
+			for (int k = 0; k < _counts[v]; k++) {
+				_weights[v][k] /= total;
+			}
+			mesh.setVertex(v, _vertices[v], _normals[v]);
+			mesh.setInfluences(v, _joints[v], _weights[v], _counts[v]);
+		}
+		// Normals of zero length stay that way
+		_normals[kNumVertices - 1].set(0.f, 0.f, 0.f);
+		mesh.setVertex(kNumVertices - 1, _vertices[kNumVertices - 1], _normals[kNumVertices - 1]);
+	}
+
+	void assertNear(const Math::Vector3d &a, const Math::Vector3d &b, float epsilon) {
+		TS_ASSERT_DELTA(a.x(), b.x(), epsilon);
+		TS_ASSERT_DELTA(a.y(), b.y(), epsilon);
+		TS_ASSERT_DELTA(a.z(), b.z(), epsilon);
+	}
+
+public:
+	void tearDown() {
+		Math::setUseSkinningSIMD(true);
+	}
+
+	void test_per_influence() {
+		Math::SkinnedMesh mesh;
+		setupMesh(mesh);
+
+		Math::Vector3d vertices[kNumVertices], normals[kNumVertices];
+		mesh.skin(_skin, vertices, normals);
+
+		for (int v = 0; v < kNumVertices; v++) {
+			Math::Vector3d vertex, normal;
+			for (int k = 0; k < _counts[v]; k++) {
+				const Math::Matrix4 &bind = _bind[_joints[v][k]];
+				Math::Vector3d vert = _vertices[v];
+				bind.inverseTranslate(&vert);
+				bind.inverseRotate(&vert);
+				_pose[_joints[v][k]].transform(&vert, true);
+				vertex += vert * _weights[v][k];
+
+				Math::Vector3d norm = _normals[v];
+				bind.inverseRotate(&norm);
+				_pose[_joints[v][k]].transform(&norm, false);
+				normal += norm * _weights[v][k];
+			}
+			normal.normalize();
+
+			assertNear(vertices[v], vertex, 1e-4f);
+			assertNear(normals[v], normal, 1e-5f);
+		}
+	}
+
+	void test_simd_matches_scalar() {
+		Math::SkinnedMesh mesh;
+		setupMesh(mesh);
+
+		Math::Vector3d vertices[kNumVertices], normals[kNumVertices];
+		Math::Vector3d scalarVertices[kNumVertices], scalarNormals[kNumVertices];
+		mesh.skin(_skin, vertices, normals);
+		Math::setUseSkinningSIMD(false);
+		mesh.skin(_skin, scalarVertices, scalarNormals);
+
+		for (int v = 0; v < kNumVertices; v++) {
+			assertNear(vertices[v], scalarVertices[v], 1e-6f);
+			assertNear(normals[v], scalarNormals[v], 1e-6f);
+		}
+	}
+
+	void test_drop_smallest_influence() {
+		Math::SkinnedMesh mesh;
+		setupMesh(mesh);
+
+		// The smallest weight is dropped and the others are scaled to make up for it
+		const int joints[] = { 0, 1, 2, 3, 4 };
+		const float weights[] = { 0.2f, 0.3f, 0.05f, 0.25f, 0.2f };
+		mesh.setInfluences(0, joints, weights, 5);
+		const int keptJoints[] = { 0, 1, 4, 3 };
+		const float keptWeights[] = { 0.2f / 0.95f, 0.3f / 0.95f, 0.2f / 0.95f, 0.25f / 0.95f };
+		Math::SkinnedMesh expectedMesh;
+		expectedMesh.setup(1);
+		expectedMesh.setVertex(0, _vertices[0], _normals[0]);
+		expectedMesh.setInfluences(0, keptJoints, keptWeights, 4);
+
+		Math::Vector3d vertices[kNumVertices], normals[kNumVertices];
+		Math::Vector3d expectedVertex, expectedNormal;
+		mesh.skin(_skin, vertices, normals);
+		expectedMesh.skin(_skin, &expectedVertex, &expectedNormal);
+		assertNear(vertices[0], expectedVertex, 1e-5f);
+		assertNear(normals[0], expectedNormal, 1e-5f);
+	}
+};
@@ -0,0 +1,27 @@
+#ifndef TEST_RANDOM_H
+#define TEST_RANDOM_H
+
+#include "common/scummsys.h"
+
+/**
+ * The same pseudo random numbers on every run, for filling test data.
+ * Common::RandomSource needs g_system, which the test runner does not have.
+ */
+class TestRandom {
+	uint32 _seed;
+
+public:
+	TestRandom(uint32 seed = 1) : _seed(seed) {}
+
+	uint32 next() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed;
+	}
+
+	/** A float in [-range, range). */
+	float nextFloat(float range) {
+		return ((next() >> 8) / float(1 << 24) - 0.5f) * 2.f * range;
+	}
+};
+
+#endif
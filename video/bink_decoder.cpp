@@ -129,10 +129,14 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	// Reading video frame properties
 	_frames.resize(frameCount);
+	_keyFrames.clear();
 	for (uint32 i = 0; i < frameCount; i++) {
 		_frames[i].offset   = _bink->readUint32LE();
 		_frames[i].keyFrame = _frames[i].offset & 1;
 
+		if (_frames[i].keyFrame)
+			_keyFrames.push_back(i);
+
 		_frames[i].offset &= ~1;
 
 		if (i != 0)
@@ -154,6 +158,7 @@ void BinkDecoder::close() {
 
 	_audioTracks.clear();
 	_frames.clear();
+	_keyFrames.clear();
 }
 
 void BinkDecoder::readNextPacket() {
@@ -247,6 +252,7 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
+	_convertedRows = 0;
 
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
@@ -366,10 +372,17 @@ bool BinkDecoder::seekIntern(const Audio::Timestamp &time) {
 uint32 BinkDecoder::findKeyFrame(uint32 frame) const {
 	assert(frame < _frames.size());
 
-	for (int i = frame; i >= 0; i--) {
-		if (_frames[i].keyFrame)
-			return i;
+	// Binary search for the last key frame not after frame
+	uint lo = 0, hi = _keyFrames.size();
+	while (lo < hi) {
+		uint mid = (lo + hi) / 2;
+		if (_keyFrames[mid] <= frame)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
+	if (lo > 0)
+		return _keyFrames[lo - 1];
 
 	// If none found, we'll assume the requested frame is a key frame
 	return frame;
@@ -397,28 +410,25 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
 
-		decodePlane(frame, 3, false);
+		decodePlane(frame, 3, false, false);
 	}
 
 	if (_id == kBIKiID)
 		frame.bits->skip(32);
 
+	_convertedRows = 0;
 	for (int i = 0; i < 3; i++) {
 		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
 
-		decodePlane(frame, planeIdx, i != 0);
+		// The last plane converts every band of rows as soon as it is complete
+		decodePlane(frame, planeIdx, i != 0, i == 2);
 
 		if (frame.bits->pos() >= frame.bits->size())
 			break;
 	}
 
-	// Convert the YUV data we have to our format
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _curPlanes[3]
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-	YUVAToRGBAMan.convert420(&_surface, Graphics::YUVAToRGBAManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-			_surfaceWidth, _surfaceHeight, _surfaceWidth, _surfaceWidth >> 1);
+	// Convert whatever is left, when the frame ended early
+	convertRows(_surfaceHeight);
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
@@ -427,7 +437,23 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	_curFrame++;
 }
 
-void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
+void BinkDecoder::BinkVideoTrack::convertRows(int endRow) {
+	endRow = MIN(endRow, _surfaceHeight) & ~1;
+	if (endRow <= _convertedRows)
+		return;
+
+	// Convert the YUV data we have to our format
+	// The width used here is the surface-width, and not the video-width
+	// to allow for odd-sized videos.
+	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _curPlanes[3]
+	// The alpha plane stays opaque for videos without alpha, so it is skipped.
+	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
+	YUVAToRGBAMan.convert420Rows(&_surface, Graphics::YUVAToRGBAManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _hasAlpha ? _curPlanes[3] : 0,
+			_surfaceWidth, _surfaceWidth, _surfaceWidth >> 1, _convertedRows, endRow - _convertedRows);
+	_convertedRows = endRow;
+}
+
+void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma, bool convert) {
 	uint32 blockWidth  = isChroma ? ((_surface.w  + 15) >> 4) : ((_surface.w  + 7) >> 3);
 	uint32 blockHeight = isChroma ? ((_surface.h + 15) >> 4) : ((_surface.h + 7) >> 3);
 	uint32 width       = isChroma ?  (_surface.w        >> 1) :   _surface.w;
@@ -520,6 +546,9 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 		}
 
+		// A chroma block row covers 16 rows of the picture
+		if (convert)
+			convertRows((ctx.blockY + 1) * 16);
 	}
 
 	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
@@ -246,6 +246,7 @@ private:
 		Graphics::Surface _surface;
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
+		int _convertedRows; ///< Rows of the current frame already converted to RGB
 
 		uint32 _id; ///< The BIK FourCC.
 
@@ -274,8 +275,10 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
-		/** Decode a plane. */
-		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		/** Decode a plane, optionally converting the picture rows it completes. */
+		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma, bool convert);
+		/** Convert the picture rows before endRow that are not converted yet. */
+		void convertRows(int endRow);
 
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
@@ -363,6 +366,7 @@ private:
 
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
+	Common::Array<uint32> _keyFrames;       ///< Indices of the key frames, ascending.
 
 	void initAudioTrack(AudioInfo &audio);
 };